@@ -0,0 +1,95 @@
+#include <Arduino.h>
+#include <pas-co2-rate-ino.hpp>
+
+/**
+ * In this example, the CO2 concentration is measured in continuous 
+ * mode with a measurement period following the rate of change of 
+ * the concentration: up to 5 minutes while it is stable, down to 
+ * 10 seconds when it changes, and shorter close to the alarm 
+ * threshold. Each period change restarts the continuous mode, which 
+ * measures at once. Each result is printed with the next period.
+ */
+
+/* 
+ * The sensor supports 100KHz and 400KHz. 
+ * You hardware setup and pull-ups value will
+ * also influence the i2c operation. You can 
+ * change this value to 100000 in case of 
+ * communication issues.
+ */
+#define I2C_FREQ_HZ  400000                     
+#define MIN_MEAS_INTERVAL_IN_SECONDS  10
+#define MAX_MEAS_INTERVAL_IN_SECONDS  300
+#define ALARM_THRESHOLD_IN_PPM  1000
+
+/*
+ * Create CO2 object. Unless otherwise specified,
+ * using the Wire interface
+ */
+PASCO2Ino cotwo;
+
+/* Period for a change of about 20 ppm between two results */
+PASCO2RateControl rate(MIN_MEAS_INTERVAL_IN_SECONDS, MAX_MEAS_INTERVAL_IN_SECONDS);
+
+Sample_t sample;
+Error_t err;
+
+void setup()
+{
+    Serial.begin(9600);
+    delay(800);
+    Serial.println("serial initialized");
+
+    /* Initialize the i2c interface used by the sensor */
+    Wire.begin();
+    Wire.setClock(I2C_FREQ_HZ);
+
+    /* Initialize the sensor */
+    err = cotwo.begin();
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("initialization error: ");
+      Serial.println(err);
+    }
+
+    rate.setAlarm(ALARM_THRESHOLD_IN_PPM);
+
+    /* Continuous measurement from the minimum period, serviced into samples */
+    err = cotwo.startAcquisition(rate.period());
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("start acquisition error: ");
+      Serial.println(err);
+    }
+}
+
+void loop()
+{
+    err = cotwo.service(sample);
+    if(XENSIV_PASCO2_OK != err)
+    {
+      if(XENSIV_PASCO2_READ_NRDY != err)
+      {
+        Serial.print("service error: ");
+        Serial.println(err);
+      }
+      delay(100);
+      return;
+    }
+
+    /* Rewrites the period if needed */
+    rate.update(sample);
+    err = rate.apply(cotwo);
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("set rate error: ");
+      Serial.println(err);
+    }
+
+    Serial.print("co2 ppm value : ");
+    Serial.print(sample.co2PPM);
+    Serial.print(" ppm/h : ");
+    Serial.print(rate.slope());
+    Serial.print(" period s : ");
+    Serial.println(rate.period());
+}
@@ -0,0 +1,118 @@
+#include <Arduino.h>
+#include <pas-co2-history-ino.hpp>
+
+/**
+ * In this example, the CO2 concentration is measured in continuous 
+ * mode and every result is stored with the sensor status flags in a 
+ * compressed history of 2 KB, which holds days of one minute results. 
+ * The records held, the storage used and the oldest records evicted 
+ * are printed with each result. Send 'd' on the serial monitor to 
+ * dump the whole history as comma separated values.
+ */
+
+/* 
+ * The sensor supports 100KHz and 400KHz. 
+ * You hardware setup and pull-ups value will
+ * also influence the i2c operation. You can 
+ * change this value to 100000 in case of 
+ * communication issues.
+ */
+#define I2C_FREQ_HZ  400000                     
+#define PERIODIC_MEAS_INTERVAL_IN_SECONDS  10 /* demo-mode value; not recommended for long-term measurements */
+// #define PERIODIC_MEAS_INTERVAL_IN_SECONDS 60L /* specification value for stable operation (uncomment for long-time-measurements) */
+
+/*
+ * Create CO2 object. Unless otherwise specified,
+ * using the Wire interface
+ */
+PASCO2Ino cotwo;
+
+/* 2 KB in blocks of 128 bytes, timestamps within 1 s */
+PASCO2History<2048> history;
+
+int16_t co2ppm;
+Diag_t diag;
+Error_t err;
+
+void setup()
+{
+    Serial.begin(9600);
+    delay(800);
+    Serial.println("serial initialized");
+
+    /* Initialize the i2c interface used by the sensor */
+    Wire.begin();
+    Wire.setClock(I2C_FREQ_HZ);
+
+    /* Initialize the sensor */
+    err = cotwo.begin();
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("initialization error: ");
+      Serial.println(err);
+    }
+
+    err = cotwo.startMeasure(PERIODIC_MEAS_INTERVAL_IN_SECONDS);
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("start measure error: ");
+      Serial.println(err);
+    }
+
+    delay(1000);
+}
+
+void dump()
+{
+    HistoryRec_t rec;
+    PASCO2HistoryReader reader(history);
+
+    Serial.println("timestamp,co2,status");
+    while(reader.next(rec))
+    {
+      Serial.print(rec.timestamp);
+      Serial.print(",");
+      Serial.print(rec.co2PPM);
+      Serial.print(",");
+      Serial.println(rec.diag.u, HEX);
+    }
+}
+
+void loop()
+{
+    /* Wait for the value to be ready. */
+    delay(PERIODIC_MEAS_INTERVAL_IN_SECONDS*1000);
+
+    err = cotwo.getCO2(co2ppm);
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("get co2 error: ");
+      Serial.println(err);
+      return;
+    }
+
+    err = cotwo.getDiagnosis(diag);
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("get diagnosis error: ");
+      Serial.println(err);
+      return;
+    }
+
+    /* Timestamped with millis() */
+    history.add(co2ppm, diag);
+
+    Serial.print("co2 ppm value : ");
+    Serial.print(co2ppm);
+    Serial.print(" records : ");
+    Serial.print(history.count());
+    Serial.print(" bytes : ");
+    Serial.print(history.size());
+    Serial.print(" evicted : ");
+    Serial.println(history.evicted());
+
+    if(Serial.available() && ('d' == Serial.read()))
+    {
+      dump();
+    }
+}
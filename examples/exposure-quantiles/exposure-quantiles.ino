@@ -0,0 +1,108 @@
+#include <Arduino.h>
+#include <pas-co2-quantile-ino.hpp>
+
+/**
+ * In this example, the CO2 concentration is measured in continuous 
+ * mode and every result is added to a quantile sketch. The median, 
+ * the 95th and the 99th percentiles of the exposure are printed 
+ * with each result. Once a day, the sketch is serialized in a few 
+ * hundred bytes, printed in hexadecimal and cleared. The daily 
+ * sketches can be merged later on to get the weekly percentiles.
+ */
+
+/* 
+ * The sensor supports 100KHz and 400KHz. 
+ * You hardware setup and pull-ups value will
+ * also influence the i2c operation. You can 
+ * change this value to 100000 in case of 
+ * communication issues.
+ */
+#define I2C_FREQ_HZ  400000                     
+#define PERIODIC_MEAS_INTERVAL_IN_SECONDS  10 /* demo-mode value; not recommended for long-term measurements */
+// #define PERIODIC_MEAS_INTERVAL_IN_SECONDS 60L /* specification value for stable operation (uncomment for long-time-measurements) */
+#define RESULTS_PER_DAY                    (86400L / PERIODIC_MEAS_INTERVAL_IN_SECONDS)
+
+/*
+ * Create CO2 object. Unless otherwise specified,
+ * using the Wire interface
+ */
+PASCO2Ino cotwo;
+
+/* Within 1.6 % of the true percentiles, 704 bytes */
+PASCO2Quantiles<5> day;
+
+uint8_t serialized[PASCO2Quantiles<5>::maxSerializedSize];
+
+int16_t co2ppm;
+Error_t err;
+
+void setup()
+{
+    Serial.begin(9600);
+    delay(800);
+    Serial.println("serial initialized");
+
+    /* Initialize the i2c interface used by the sensor */
+    Wire.begin();
+    Wire.setClock(I2C_FREQ_HZ);
+
+    /* Initialize the sensor */
+    err = cotwo.begin();
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("initialization error: ");
+      Serial.println(err);
+    }
+
+    err = cotwo.startMeasure(PERIODIC_MEAS_INTERVAL_IN_SECONDS);
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("start measure error: ");
+      Serial.println(err);
+    }
+
+    delay(1000);
+}
+
+void loop()
+{
+    /* Wait for the value to be ready. */
+    delay(PERIODIC_MEAS_INTERVAL_IN_SECONDS*1000);
+
+    err = cotwo.getCO2(co2ppm);
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("get co2 error: ");
+      Serial.println(err);
+      return;
+    }
+
+    day.add(co2ppm);
+
+    Serial.print("co2 ppm value : ");
+    Serial.print(co2ppm);
+    Serial.print(" p50 : ");
+    Serial.print(day.quantile(500));
+    Serial.print(" p95 : ");
+    Serial.print(day.quantile(950));
+    Serial.print(" p99 : ");
+    Serial.println(day.quantile(990));
+
+    if(day.count() >= RESULTS_PER_DAY)
+    {
+      size_t len = day.serialize(serialized, sizeof(serialized));
+
+      Serial.print("day sketch : ");
+      for(size_t i = 0; i < len; i++)
+      {
+        if(serialized[i] < 0x10)
+        {
+          Serial.print("0");
+        }
+        Serial.print(serialized[i], HEX);
+      }
+      Serial.println();
+
+      day.reset();
+    }
+}
@@ -0,0 +1,93 @@
+#include <Arduino.h>
+#include <pas-co2-rollup-ino.hpp>
+
+/**
+ * In this example, the CO2 concentration is measured in continuous 
+ * mode and every result is aggregated into minute, hour and day bins. 
+ * The 15 minutes and 8 hours time weighted averages (TWA) of the 
+ * exposure, and the min/max/mean of the last day are printed with 
+ * each result, without storing nor scanning the raw results.
+ */
+
+/* 
+ * The sensor supports 100KHz and 400KHz. 
+ * You hardware setup and pull-ups value will
+ * also influence the i2c operation. You can 
+ * change this value to 100000 in case of 
+ * communication issues.
+ */
+#define I2C_FREQ_HZ  400000                     
+#define PERIODIC_MEAS_INTERVAL_IN_SECONDS  10 /* demo-mode value; not recommended for long-term measurements */
+// #define PERIODIC_MEAS_INTERVAL_IN_SECONDS 60L /* specification value for stable operation (uncomment for long-time-measurements) */
+
+/*
+ * Create CO2 object. Unless otherwise specified,
+ * using the Wire interface
+ */
+PASCO2Ino cotwo;
+
+/* Last 15 minutes, last day of hours, last week of days */
+PASCO2Rollup<15, 24, 7> rollup(PERIODIC_MEAS_INTERVAL_IN_SECONDS);
+
+Sample_t sample;
+Rollup_t day;
+Error_t err;
+
+void setup()
+{
+    Serial.begin(9600);
+    delay(800);
+    Serial.println("serial initialized");
+
+    /* Initialize the i2c interface used by the sensor */
+    Wire.begin();
+    Wire.setClock(I2C_FREQ_HZ);
+
+    /* Initialize the sensor */
+    err = cotwo.begin();
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("initialization error: ");
+      Serial.println(err);
+    }
+
+    /* Continuous measurement, serviced into samples */
+    err = cotwo.startAcquisition(PERIODIC_MEAS_INTERVAL_IN_SECONDS);
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("start acquisition error: ");
+      Serial.println(err);
+    }
+}
+
+void loop()
+{
+    /* Timestamped with millis() at the readout */
+    err = cotwo.service(sample);
+    if(XENSIV_PASCO2_OK != err)
+    {
+      if(XENSIV_PASCO2_READ_NRDY != err)
+      {
+        Serial.print("service error: ");
+        Serial.println(err);
+      }
+      delay(100);
+      return;
+    }
+
+    rollup.update(sample);
+    rollup.window(24UL * 3600000UL, day);
+
+    Serial.print("co2 ppm value : ");
+    Serial.print(sample.co2PPM);
+    Serial.print(" twa 15 min : ");
+    Serial.print(rollup.twa(15UL * 60000UL));
+    Serial.print(" twa 8 h : ");
+    Serial.print(rollup.twa(8UL * 3600000UL));
+    Serial.print(" day min : ");
+    Serial.print(day.minimum);
+    Serial.print(" max : ");
+    Serial.print(day.maximum);
+    Serial.print(" mean : ");
+    Serial.println(PASCO2Rollup<15, 24, 7>::mean(day));
+}
@@ -0,0 +1,85 @@
+#include <Arduino.h>
+#include <pas-co2-manager-ino.hpp>
+
+/**
+ * In this example, 16 sensors share the same i2c address behind 
+ * two TCA9548A multiplexers, at the addresses 0x70 and 0x71. 
+ * The sensor i is connected to the channel i % 8 of the 
+ * multiplexer i / 8. 
+ * The manager reads out each sensor when its measurement is due 
+ * and pushes the samples, tagged with the sensor index, into a 
+ * single ring buffer. The multiplexer channel is only switched 
+ * when needed.
+ */
+
+/* 
+ * The sensor supports 100KHz and 400KHz. 
+ * You hardware setup and pull-ups value will
+ * also influence the i2c operation. You can 
+ * change this value to 100000 in case of 
+ * communication issues.
+ */
+#define I2C_FREQ_HZ     400000  
+#define NUM_SENSORS     16
+#define PERIODIC_MEAS_INTERVAL_IN_SECONDS  10 /* demo-mode value; not recommended for long-term measurements */
+// #define PERIODIC_MEAS_INTERVAL_IN_SECONDS 60L /* specification value for stable operation (uncomment for long-time-measurements) */
+
+/*
+ * The constructor takes the Wire instance as i2c interface
+ * and the address of the first multiplexer
+ */
+PASCO2Manager<NUM_SENSORS> sensors(&Wire, 0x70);
+
+PASCO2MuxSampleRing<32> ring;
+MuxSample_t sample;
+Error_t err;
+
+void setup()
+{
+    Serial.begin(9600);
+    delay(500);
+    Serial.println("serial initialized");
+
+    /* Initialize the i2c serial interface used by the multiplexers and sensors */
+    Wire.begin();
+    Wire.setClock(I2C_FREQ_HZ);
+
+    /* Begins all the sensors in parallel and starts their continuous measurement */
+    err = sensors.begin(PERIODIC_MEAS_INTERVAL_IN_SECONDS);
+    if(XENSIV_PASCO2_OK != err)
+    {
+      for(uint8_t i = 0; i < sensors.count(); i++)
+      {
+        if(!sensors.slot(i).active)
+        {
+          Serial.print("sensor ");
+          Serial.print(i);
+          Serial.print(" initialization error: ");
+          Serial.println(sensors.slot(i).status);
+        }
+      }
+    }
+}
+
+void loop()
+{
+    /* Reads out all the sensors due. Returns immediately if none is */
+    err = sensors.service(ring);
+    if((XENSIV_PASCO2_OK != err) && (XENSIV_PASCO2_READ_NRDY != err))
+    {
+      Serial.print("service error: ");
+      Serial.println(err);
+    }
+
+    while(ring.pop(sample))
+    {
+        Serial.print("sensor ");
+        Serial.print(sample.sensor);
+        Serial.print(" t=");
+        Serial.print(sample.sample.timestamp);
+        Serial.print(" ms co2 ppm value : ");
+        Serial.println(sample.sample.co2PPM);
+    }
+
+    /* ... do something else until sensors.nextDueMs() has elapsed ... */
+}
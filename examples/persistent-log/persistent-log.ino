@@ -0,0 +1,168 @@
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <pas-co2-log-ino.hpp>
+
+/**
+ * In this example, the CO2 concentration is measured in continuous 
+ * mode and every result is appended with the sensor status flags to 
+ * a persistent log in the EEPROM, which survives resets and power 
+ * losses. The EEPROM is split into pages used in turn, so that all 
+ * its cells wear evenly. On startup, the log is recovered and the 
+ * boot number and the records torn by a power loss are printed. 
+ * Send 'd' on the serial monitor to dump the whole log as comma 
+ * separated values.
+ */
+
+/* 
+ * The sensor supports 100KHz and 400KHz. 
+ * You hardware setup and pull-ups value will
+ * also influence the i2c operation. You can 
+ * change this value to 100000 in case of 
+ * communication issues.
+ */
+#define I2C_FREQ_HZ  400000                     
+#define PERIODIC_MEAS_INTERVAL_IN_SECONDS  10 /* demo-mode value; not recommended for long-term measurements */
+// #define PERIODIC_MEAS_INTERVAL_IN_SECONDS 60L /* specification value for stable operation (uncomment for long-time-measurements) */
+
+/* 
+ * EEPROM area of the log: 16 pages of 64 bytes,
+ * i.e. 1 KB holding 4 records per page. 
+ */
+#define LOG_PAGE_SIZE  64
+#define LOG_PAGES      16
+
+/*
+ * Create CO2 object. Unless otherwise specified,
+ * using the Wire interface
+ */
+PASCO2Ino cotwo;
+
+/* 
+ * Page storage on the EEPROM. The EEPROM has
+ * no erase, a page is erased by writing 0xFF.
+ */
+int32_t eepromRead(void * arg, uint32_t addr, uint8_t * buf, uint16_t len)
+{
+    for(uint16_t i = 0; i < len; i++)
+    {
+      buf[i] = EEPROM.read(addr + i);
+    }
+    return XENSIV_PASCO2_OK;
+}
+
+int32_t eepromWrite(void * arg, uint32_t addr, const uint8_t * buf, uint16_t len)
+{
+    for(uint16_t i = 0; i < len; i++)
+    {
+      EEPROM.write(addr + i, buf[i]);
+    }
+    return XENSIV_PASCO2_OK;
+}
+
+int32_t eepromErase(void * arg, uint16_t page)
+{
+    for(uint16_t i = 0; i < LOG_PAGE_SIZE; i++)
+    {
+      EEPROM.write((uint32_t)page * LOG_PAGE_SIZE + i, 0xFF);
+    }
+    return XENSIV_PASCO2_OK;
+}
+
+const LogStore_t store = { eepromRead, eepromWrite, eepromErase, nullptr, LOG_PAGE_SIZE, LOG_PAGES };
+PASCO2Log co2log(&store);
+
+Error_t err;
+
+void setup()
+{
+    Serial.begin(9600);
+    delay(800);
+    Serial.println("serial initialized");
+
+    /* Recover the log and append a boot record */
+    err = co2log.begin();
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("log error: ");
+      Serial.println(err);
+    }
+
+    Serial.print("boot : ");
+    Serial.print(co2log.boot());
+    Serial.print(" records : ");
+    Serial.print(co2log.count());
+    Serial.print(" torn : ");
+    Serial.println(co2log.corrupted());
+
+    /* Initialize the i2c interface used by the sensor */
+    Wire.begin();
+    Wire.setClock(I2C_FREQ_HZ);
+
+    /* Initialize the sensor */
+    err = cotwo.begin();
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("initialization error: ");
+      Serial.println(err);
+      co2log.logEvent(LOG_EVENT_ERROR, err);
+    }
+
+    err = cotwo.startMeasure(PERIODIC_MEAS_INTERVAL_IN_SECONDS);
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("start measure error: ");
+      Serial.println(err);
+      co2log.logEvent(LOG_EVENT_ERROR, err);
+    }
+
+    delay(1000);
+}
+
+void dump()
+{
+    LogRec_t rec;
+
+    Serial.println("boot,timestamp,type,code,value");
+    for(uint32_t i = 0; i < co2log.count(); i++)
+    {
+      if(XENSIV_PASCO2_OK == co2log.read(i, rec))
+      {
+        Serial.print(rec.boot);
+        Serial.print(",");
+        Serial.print(rec.timestamp);
+        Serial.print(",");
+        Serial.print(rec.type);
+        Serial.print(",");
+        Serial.print(rec.code, HEX);
+        Serial.print(",");
+        Serial.println(rec.value);
+      }
+    }
+}
+
+void loop()
+{
+    /* Wait for the value to be ready. */
+    delay(PERIODIC_MEAS_INTERVAL_IN_SECONDS*1000);
+
+    /* 
+     * Read the CO2 concentration and the sensor
+     * status, and log them, or log the error.
+     */
+    err = co2log.capture(cotwo);
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("capture error: ");
+      Serial.println(err);
+    }
+    else
+    {
+      Serial.print("records : ");
+      Serial.println(co2log.count());
+    }
+
+    if(Serial.available() && ('d' == Serial.read()))
+    {
+      dump();
+    }
+}
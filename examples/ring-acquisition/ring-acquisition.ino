@@ -0,0 +1,96 @@
+#include <Arduino.h>
+#include <pas-co2-ino.hpp>
+
+/**
+ * In this example, the sensor data ready interrupt is handled by 
+ * the library. The interrupt only flags the new measurement, and 
+ * service() reads it out from the main loop and pushes it into a 
+ * ring buffer, together with its timestamp, status and sequence 
+ * number. 
+ * The samples are then drained in batches, here every 30 seconds, 
+ * while the loop remains free to do other tasks. 
+ */
+
+uint8_t interruptPin = 9;      /* For XMC2Go. Change it for your hardware setup */
+
+/* 
+ * The sensor supports 100KHz and 400KHz. 
+ * You hardware setup and pull-ups value will
+ * also influence the i2c operation. You can 
+ * change this value to 100000 in case of 
+ * communication issues.
+ */
+#define I2C_FREQ_HZ     400000  
+#define PERIODIC_MEAS_INTERVAL_IN_SECONDS  10 /* demo-mode value; not recommended for long-term measurements */
+// #define PERIODIC_MEAS_INTERVAL_IN_SECONDS 60L /* specification value for stable operation (uncomment for long-time-measurements) */
+#define DRAIN_INTERVAL_MS                  30000
+#define DRAIN_BATCH                        4
+
+/*
+ * The constructor takes the Wire instance as i2c interface,
+ * and the controller interrupt pin
+ */
+PASCO2Ino cotwo(&Wire, interruptPin);
+
+PASCO2SampleRing<16> ring;
+Sample_t samples[DRAIN_BATCH];
+uint32_t lastDrain = 0;
+Error_t err;
+
+void setup()
+{
+    Serial.begin(9600);
+    delay(500);
+    Serial.println("serial initialized");
+
+    /* Initialize the i2c serial interface used by the sensor */
+    Wire.begin();
+    Wire.setClock(I2C_FREQ_HZ);
+
+    err = cotwo.begin();
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("initialization error: ");
+      Serial.println(err);
+    }
+
+    /* Continuous measurement every 10 seconds */
+    err = cotwo.startAcquisition(PERIODIC_MEAS_INTERVAL_IN_SECONDS);
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("start acquisition error: ");
+      Serial.println(err);
+    }
+}
+
+void loop()
+{
+    /* Returns immediately if no new measurement has been flagged */
+    err = cotwo.service(ring);
+    if((XENSIV_PASCO2_OK != err) && (XENSIV_PASCO2_READ_NRDY != err))
+    {
+      Serial.print("service error: ");
+      Serial.println(err);
+    }
+
+    if((millis() - lastDrain) >= DRAIN_INTERVAL_MS)
+    {
+        lastDrain = millis();
+
+        uint8_t n;
+        while(0 != (n = ring.drain(samples, DRAIN_BATCH)))
+        {
+            for(uint8_t i = 0; i < n; i++)
+            {
+                Serial.print("#");
+                Serial.print(samples[i].seq);
+                Serial.print(" t=");
+                Serial.print(samples[i].timestamp);
+                Serial.print(" ms co2 ppm value : ");
+                Serial.println(samples[i].co2PPM);
+            }
+        }
+    }
+
+    /* ... do something else ... */
+}
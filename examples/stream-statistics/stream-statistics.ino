@@ -0,0 +1,93 @@
+#include <Arduino.h>
+#include <pas-co2-stats-ino.hpp>
+
+/**
+ * In this example, the CO2 concentration is measured in continuous 
+ * mode and every result is fed into a streaming statistics object. 
+ * Next to the raw value, the moving average of the last 8 results, 
+ * the exponential moving average with a 5 minutes time constant, 
+ * the min/max and the standard deviation are printed. 
+ * Only integer arithmetic is used.
+ */
+
+/* 
+ * The sensor supports 100KHz and 400KHz. 
+ * You hardware setup and pull-ups value will
+ * also influence the i2c operation. You can 
+ * change this value to 100000 in case of 
+ * communication issues.
+ */
+#define I2C_FREQ_HZ  400000                     
+#define PERIODIC_MEAS_INTERVAL_IN_SECONDS  10 /* demo-mode value; not recommended for long-term measurements */
+// #define PERIODIC_MEAS_INTERVAL_IN_SECONDS 60L /* specification value for stable operation (uncomment for long-time-measurements) */
+#define EMA_TIME_CONSTANT_MS               300000
+
+/*
+ * Create CO2 object. Unless otherwise specified,
+ * using the Wire interface
+ */
+PASCO2Ino cotwo;
+
+/* Moving average over 8 results */
+PASCO2Stats<8> stats(EMA_TIME_CONSTANT_MS);
+
+int16_t co2ppm;
+Error_t err;
+
+void setup()
+{
+    Serial.begin(9600);
+    delay(800);
+    Serial.println("serial initialized");
+
+    /* Initialize the i2c interface used by the sensor */
+    Wire.begin();
+    Wire.setClock(I2C_FREQ_HZ);
+
+    /* Initialize the sensor */
+    err = cotwo.begin();
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("initialization error: ");
+      Serial.println(err);
+    }
+
+    err = cotwo.startMeasure(PERIODIC_MEAS_INTERVAL_IN_SECONDS);
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("start measure error: ");
+      Serial.println(err);
+    }
+
+    delay(1000);
+}
+
+void loop()
+{
+    /* Wait for the value to be ready. */
+    delay(PERIODIC_MEAS_INTERVAL_IN_SECONDS*1000);
+
+    err = cotwo.getCO2(co2ppm);
+    if(XENSIV_PASCO2_OK != err)
+    {
+      Serial.print("get co2 error: ");
+      Serial.println(err);
+      return;
+    }
+
+    /* Timestamped with millis() */
+    stats.update(co2ppm);
+
+    Serial.print("co2 ppm value : ");
+    Serial.print(co2ppm);
+    Serial.print(" avg : ");
+    Serial.print(stats.average());
+    Serial.print(" ema : ");
+    Serial.print(stats.ema());
+    Serial.print(" min : ");
+    Serial.print(stats.minimum());
+    Serial.print(" max : ");
+    Serial.print(stats.maximum());
+    Serial.print(" stddev : ");
+    Serial.println(stats.stddev());
+}
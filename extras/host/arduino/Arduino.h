@@ -0,0 +1,113 @@
+/** 
+ * @file        Arduino.h
+ * @brief       Minimal Arduino core shim for host builds on the XENSIV™ PAS CO2 simulator
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *              
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ARDUINO_SHIM_H_
+#define ARDUINO_SHIM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @addtogroup co2inohost
+ * @{
+ */
+
+#define LOW             0
+#define HIGH            1
+
+#define INPUT           0
+#define OUTPUT          1
+#define INPUT_PULLUP    2
+
+#define CHANGE          1
+#define FALLING         2
+#define RISING          3
+
+#define DEC             10
+#define HEX             16
+
+#define digitalPinToInterrupt(p)    (p)
+
+/**
+ * @brief   Number of pins of the shim
+ */
+#define ARDUINO_SHIM_PINS   (32U)
+
+/**
+ * @brief   Time functions on the simulated clock
+ */
+unsigned long millis();
+unsigned long micros();
+void          delay(unsigned long ms);
+void          delayMicroseconds(unsigned int us);
+void          yield();
+
+/**
+ * @brief   Digital pins and interrupts
+ * 
+ * @details Input levels are driven by the host application with 
+ *          arduino_shim_set_pin(), which runs the attached interrupt 
+ *          handler on a matching edge.
+ */
+void    pinMode(uint8_t pin, uint8_t mode);
+int     digitalRead(uint8_t pin);
+void    digitalWrite(uint8_t pin, uint8_t val);
+void    attachInterrupt(uint8_t irq, void (*isr)(), int mode);
+void    detachInterrupt(uint8_t irq);
+void    noInterrupts();
+void    interrupts();
+
+void    arduino_shim_set_pin(uint8_t pin, bool level);
+
+/**
+ * @brief   Stream printing to stdout
+ */
+class Stream
+{
+    public:
+
+        virtual int     available()                             { return 0; }
+        virtual int     read()                                  { return -1; }
+        virtual size_t  write(uint8_t)                          { return 1; }
+        virtual size_t  write(const uint8_t *, size_t len)      { return len; }
+        virtual void    flush()                                 { }
+        virtual        ~Stream()                                { }
+
+        size_t print   (const char * s)                         { return (size_t)printf("%s", s); }
+        size_t print   (char c)                                 { return (size_t)printf("%c", c); }
+        size_t print   (long v, int base = DEC)                 { return (size_t)printf((HEX == base) ? "%lx" : "%ld", v); }
+        size_t print   (unsigned long v, int base = DEC)        { return (size_t)printf((HEX == base) ? "%lx" : "%lu", v); }
+        size_t print   (int v, int base = DEC)                  { return print((long)v, base); }
+        size_t print   (unsigned int v, int base = DEC)         { return print((unsigned long)v, base); }
+        size_t print   (double v)                               { return (size_t)printf("%.2f", v); }
+        size_t println ()                                       { return (size_t)printf("\n"); }
+        template<typename T>
+        size_t println (T v)                                    { size_t n = print(v); return n + println(); }
+        template<typename T>
+        size_t println (T v, int base)                          { size_t n = print(v, base); return n + println(); }
+};
+
+/**
+ * @brief   Hardware serial. The simulated sensors bind to the object address 
+ */
+class HardwareSerial : public Stream
+{
+    public:
+
+        void begin(unsigned long)   { }
+        void end()                  { }
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+
+/** @} */
+
+#endif /** ARDUINO_SHIM_H_ **/
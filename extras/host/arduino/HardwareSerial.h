@@ -0,0 +1,14 @@
+/** 
+ * @file        HardwareSerial.h
+ * @brief       Minimal Arduino HardwareSerial shim for host builds
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *              
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef HARDWARE_SERIAL_SHIM_H_
+#define HARDWARE_SERIAL_SHIM_H_
+
+#include <Arduino.h>
+
+#endif /** HARDWARE_SERIAL_SHIM_H_ **/
@@ -0,0 +1,35 @@
+/** 
+ * @file        Wire.h
+ * @brief       Minimal Arduino Wire shim for host builds
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *              
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef WIRE_SHIM_H_
+#define WIRE_SHIM_H_
+
+#include <Arduino.h>
+
+/**
+ * @addtogroup co2inohost
+ * @{
+ */
+
+/**
+ * @brief   I2C bus. The simulated sensors bind to the object address 
+ */
+class TwoWire : public Stream
+{
+    public:
+
+        void begin()                { }
+        void end()                  { }
+        void setClock(uint32_t)     { }
+};
+
+extern TwoWire Wire;
+
+/** @} */
+
+#endif /** WIRE_SHIM_H_ **/
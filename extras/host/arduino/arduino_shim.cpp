@@ -0,0 +1,200 @@
+/**
+ * @file        arduino_shim.cpp
+ * @brief       Minimal Arduino core shim for host builds on the XENSIV™ PAS CO2 simulator
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @details     Replaces both the Arduino core and pas-co2-pal-ino.cpp: the
+ *              core library platform hooks are provided by xensiv_pasco2_sim.c,
+ *              and the non-blocking UART receive of the Arduino PAL is served
+ *              from the simulated UART devices. The bus mutexes are those of
+ *              pas-co2-mutex-ino.cpp, linked alongside.
+ */
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "pas-co2-pal-ino.hpp"
+#include "xensiv_pasco2_sim.h"
+
+HardwareSerial  Serial;
+HardwareSerial  Serial1;
+TwoWire         Wire;
+
+static void   (* shimIsr[ARDUINO_SHIM_PINS])()  = {nullptr};
+static int       shimIsrMode[ARDUINO_SHIM_PINS] = {0};
+static bool      shimPin[ARDUINO_SHIM_PINS]     = {false};
+
+static constexpr unsigned int shimPollUs = 100U;   /**< Simulated time of a receive poll without progress or of a yield() */
+
+unsigned long millis()
+{
+    return (unsigned long)(xensiv_pasco2_sim_time_us() / 1000U);
+}
+
+unsigned long micros()
+{
+    return (unsigned long)xensiv_pasco2_sim_time_us();
+}
+
+void delay(unsigned long ms)
+{
+    xensiv_pasco2_sim_advance_us((uint64_t)ms * 1000U);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    xensiv_pasco2_sim_advance_us(us);
+}
+
+void yield()
+{
+    /* A yield takes some time, so that yield loops make progress on the simulated clock */
+    delayMicroseconds(shimPollUs);
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if((pin < ARDUINO_SHIM_PINS) && (INPUT_PULLUP == mode))
+    {
+        shimPin[pin] = true;
+    }
+}
+
+int digitalRead(uint8_t pin)
+{
+    return ((pin < ARDUINO_SHIM_PINS) && shimPin[pin]) ? HIGH : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    if(pin < ARDUINO_SHIM_PINS)
+    {
+        shimPin[pin] = (LOW != val);
+    }
+}
+
+void attachInterrupt(uint8_t irq, void (*isr)(), int mode)
+{
+    if(irq < ARDUINO_SHIM_PINS)
+    {
+        shimIsr[irq]     = isr;
+        shimIsrMode[irq] = mode;
+    }
+}
+
+void detachInterrupt(uint8_t irq)
+{
+    if(irq < ARDUINO_SHIM_PINS)
+    {
+        shimIsr[irq] = nullptr;
+    }
+}
+
+void noInterrupts()
+{
+
+}
+
+void interrupts()
+{
+
+}
+
+/**
+ * @brief       Drives an input pin level
+ *
+ * @details     Runs the attached interrupt handler if the level change
+ *              matches its edge mode. Meant to be connected to the
+ *              simulated sensor INT pin handler.
+ *
+ * @param[in]   pin     Pin number
+ * @param[in]   level   New level
+ */
+void arduino_shim_set_pin(uint8_t pin, bool level)
+{
+    if((pin >= ARDUINO_SHIM_PINS) || (level == shimPin[pin]))
+    {
+        return;
+    }
+
+    shimPin[pin] = level;
+
+    if((nullptr != shimIsr[pin]) &&
+       ((CHANGE == shimIsrMode[pin]) ||
+        ((RISING == shimIsrMode[pin]) && level) ||
+        ((FALLING == shimIsrMode[pin]) && !level)))
+    {
+        shimIsr[pin]();
+    }
+}
+
+void xensiv_pasco2_plat_uart_rx_start(xensiv_pasco2_plat_uart_rx_t * rx, void * ctx, uint8_t * data, size_t len, uint32_t timeout)
+{
+    rx->ctx     = ctx;
+    rx->data    = data;
+    rx->len     = len;
+    rx->count   = 0;
+    rx->start   = (uint32_t)millis();
+    rx->timeout = timeout;
+    rx->status  = XENSIV_PASCO2_BUSY;
+}
+
+int32_t xensiv_pasco2_plat_uart_rx_poll(xensiv_pasco2_plat_uart_rx_t * rx)
+{
+    if(XENSIV_PASCO2_BUSY == rx->status)
+    {
+        size_t avail = xensiv_pasco2_sim_uart_available(rx->ctx);
+        size_t n     = rx->len - rx->count;
+
+        if(avail < n)
+        {
+            n = avail;
+        }
+
+        if((n > 0U) && (XENSIV_PASCO2_OK == xensiv_pasco2_plat_uart_read(rx->ctx, &rx->data[rx->count], n)))
+        {
+            rx->count += n;
+        }
+
+        if(rx->count == rx->len)
+        {
+            rx->status = XENSIV_PASCO2_OK;
+        }
+        else if(0U == n)
+        {
+            /* The caller loop spins on the simulated clock */
+            delayMicroseconds(shimPollUs);
+        }
+
+        if((XENSIV_PASCO2_BUSY == rx->status) && (((uint32_t)millis() - rx->start) >= rx->timeout))
+        {
+            rx->status = XENSIV_PASCO2_ERR_COMM;
+        }
+    }
+
+    return rx->status;
+}
+
+void xensiv_pasco2_plat_set_wait(xensiv_pasco2_plat_wait_t wait, void * arg)
+{
+    xensiv_pasco2_sim_set_wait(wait, arg);
+}
+
+void xensiv_pasco2_plat_wait(uint32_t ms)
+{
+    xensiv_pasco2_sim_wait(ms);
+}
+
+void xensiv_pasco2_plat_yield_wait(void * arg, uint32_t ms)
+{
+    (void)arg;
+
+    /* The microsecond clock avoids returning up to 1 ms early on a millis() tick */
+    uint32_t start = (uint32_t)micros();
+
+    do
+    {
+        yield();
+    } while(((uint32_t)micros() - start) < (ms * 1000UL));
+}
@@ -0,0 +1,151 @@
+/**
+ * @file        bench-bus-cost.cpp
+ * @brief       Bus cost of the XENSIV™ PAS CO2 Arduino API calls on the host simulator
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @details     Reports, for each PASCO2Ino public method on the I2C and UART
+ *              transports, the number of platform transfers, the bytes on the
+ *              wire, the time spent in xensiv_pasco2_plat_delay() and the
+ *              modeled wall time of the call.
+ *
+ *              Build and run from this directory:
+ *
+ *              @code
+ *              gcc -c -I../../src ../../src/xensiv_pasco2.c xensiv_pasco2_sim.c
+ *              g++ -std=c++11 -pthread -Iarduino -I../../src -I. bench-bus-cost.cpp arduino/arduino_shim.cpp \
+ *                  ../../src/pas-co2-ino.cpp ../../src/pas-co2-mutex-ino.cpp xensiv_pasco2.o xensiv_pasco2_sim.o -o bench-bus-cost
+ *              ./bench-bus-cost
+ *              @endcode
+ *
+ *              Pass --csv to print comma separated values.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <Arduino.h>
+#include <Wire.h>
+#include "pas-co2-ino.hpp"
+#include "xensiv_pasco2_sim.h"
+
+static constexpr uint8_t  intPinI2C     = 2;       /**< Shim pin wired to the I2C sensor INT */
+static constexpr uint8_t  intPinUART    = 3;       /**< Shim pin wired to the UART sensor INT */
+static constexpr int16_t  periodSec     = 10;      /**< Continuous mode period */
+static constexpr int16_t  alarmPPM      = 1000;    /**< Alarm threshold */
+
+static bool csv = false;
+
+static void wireInt(void * arg, bool level)
+{
+    arduino_shim_set_pin((uint8_t)(uintptr_t)arg, level);
+}
+
+static void isr(void *)
+{
+
+}
+
+static void header()
+{
+    if(csv)
+    {
+        printf("transport,call,result,transfers,bytes,delay_calls,delay_ms,wall_ms\n");
+    }
+    else
+    {
+        printf("%-5s %-52s %4s %6s %6s %7s %9s %10s\n",
+               "bus", "call", "res", "xfers", "bytes", "delays", "delay ms", "wall ms");
+    }
+}
+
+template<typename F>
+static void measure(const char * transport, const char * call, xensiv_pasco2_sim_t & sim, F f)
+{
+    xensiv_pasco2_sim_stats_t stats;
+    uint32_t delayCalls;
+
+    xensiv_pasco2_sim_reset_stats(&sim);
+    xensiv_pasco2_sim_reset_delay();
+    uint64_t t0 = xensiv_pasco2_sim_time_us();
+
+    Error_t ret = f();
+
+    uint64_t wallUs  = xensiv_pasco2_sim_time_us() - t0;
+    uint64_t delayMs = xensiv_pasco2_sim_get_delay_ms(&delayCalls);
+    xensiv_pasco2_sim_get_stats(&sim, &stats);
+
+    printf(csv ? "%s,%s,%d,%u,%u,%u,%llu,%.3f\n" : "%-5s %-52s %4d %6u %6u %7u %9llu %10.3f\n",
+           transport, call, (int)ret, (unsigned)stats.transfers, (unsigned)(stats.tx_bytes + stats.rx_bytes),
+           (unsigned)delayCalls, (unsigned long long)delayMs, (double)wallUs / 1000.0);
+}
+
+static void bench(const char * transport, PASCO2Ino & cotwo, xensiv_pasco2_sim_t & sim)
+{
+    char call[64];
+    int16_t co2;
+    Diag_t diag;
+    FCSProgress_t progress;
+
+    measure(transport, "begin()", sim, [&]() { return cotwo.begin(); });
+
+    /* Every startMeasure() argument combination, each from idle */
+    for(uint8_t i = 0; i < 16U; i++)
+    {
+        int16_t period  = (i & 1U) ? periodSec : 0;
+        int16_t alarm   = (i & 2U) ? alarmPPM : 0;
+        bool    cback   = (0U != (i & 4U));
+        bool    early   = (0U != (i & 8U));
+
+        (void)cotwo.stopMeasure();
+
+        snprintf(call, sizeof(call), "startMeasure(%d, %d, %s, %s)", period, alarm, cback ? "isr" : "nullptr", early ? "true" : "false");
+        measure(transport, call, sim, [&]() { return cotwo.startMeasure(period, alarm, cback ? isr : nullptr, early); });
+    }
+
+    measure(transport, "stopMeasure()", sim, [&]() { return cotwo.stopMeasure(); });
+
+    (void)cotwo.startMeasure();
+    delay(XENSIV_PASCO2_SIM_MEAS_TIME_MS + 100U);
+    measure(transport, "getCO2() ready", sim, [&]() { return cotwo.getCO2(co2); });
+    measure(transport, "getCO2() not ready", sim, [&]() { return cotwo.getCO2(co2); });
+
+    measure(transport, "getDiagnosis()", sim, [&]() { return cotwo.getDiagnosis(diag); });
+    measure(transport, "setABOC(XENSIV_PASCO2_BOC_CFG_AUTOMATIC, 400)", sim, [&]() { return cotwo.setABOC(XENSIV_PASCO2_BOC_CFG_AUTOMATIC, 400); });
+    measure(transport, "setPressRef(1015)", sim, [&]() { return cotwo.setPressRef(1015); });
+
+    measure(transport, "performForcedCompensation(420)", sim, [&]() { return cotwo.performForcedCompensation(420); });
+    measure(transport, "startForcedCompensation(420)", sim, [&]() { return cotwo.startForcedCompensation(420); });
+    measure(transport, "pollForcedCompensation() until done, 100 ms loop", sim, [&]()
+    {
+        Error_t ret;
+        while(XENSIV_PASCO2_BUSY == (ret = cotwo.pollForcedCompensation(progress)))
+        {
+            delay(100);
+        }
+        return ret;
+    });
+    measure(transport, "clearForcedCompensation()", sim, [&]() { return cotwo.clearForcedCompensation(); });
+}
+
+int main(int argc, char ** argv)
+{
+    xensiv_pasco2_sim_t simI2C;
+    xensiv_pasco2_sim_t simUART;
+
+    csv = (argc > 1) && (0 == strcmp(argv[1], "--csv"));
+
+    xensiv_pasco2_sim_init(&simI2C, &Wire, XENSIV_PASCO2_SIM_I2C);
+    xensiv_pasco2_sim_init(&simUART, &Serial1, XENSIV_PASCO2_SIM_UART);
+    xensiv_pasco2_sim_set_int_handler(&simI2C, wireInt, (void *)(uintptr_t)intPinI2C);
+    xensiv_pasco2_sim_set_int_handler(&simUART, wireInt, (void *)(uintptr_t)intPinUART);
+
+    PASCO2Ino cotwoI2C(&Wire, intPinI2C);
+    PASCO2Ino cotwoUART(&Serial1, intPinUART);
+
+    header();
+    bench("i2c", cotwoI2C, simI2C);
+    bench("uart", cotwoUART, simUART);
+
+    return 0;
+}
@@ -0,0 +1,241 @@
+/**
+ * @file        bench-history.cpp
+ * @brief       Compression ratio and throughput of the XENSIV™ PAS CO2 compressed history
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @details     Fills a 2 KB PASCO2History with two weeks of synthetic one
+ *              minute results: an office profile with a 420 ppm baseline and
+ *              occupancy peaks on the working days, plus sensor noise. The
+ *              timestamps follow a sensor clock 0.3 % fast with 30 ms of
+ *              readout jitter and a missed result every 500. The sensor
+ *              status flags change every 1000 results.
+ *
+ *              For each noise level, block size and timestamp tolerance, it
+ *              reports the records held, the days of history they span, the
+ *              bits per record and the compression ratio against int16_t
+ *              values and against 7 byte records (timestamp, ppm, status).
+ *              All the records held are decoded and checked: the ppm values
+ *              and the status flags must be exact, and the timestamps within
+ *              the tolerance. Finally the host time per add(), per record
+ *              decoded in sequence, and per random get() is measured.
+ *
+ *              Build and run from this directory:
+ *
+ *              @code
+ *              gcc -c -I../../src ../../src/xensiv_pasco2.c xensiv_pasco2_sim.c
+ *              g++ -std=c++11 -pthread -O2 -Iarduino -I../../src -I. bench-history.cpp arduino/arduino_shim.cpp \
+ *                  ../../src/pas-co2-history-ino.cpp xensiv_pasco2.o xensiv_pasco2_sim.o -o bench-history
+ *              ./bench-history
+ *              @endcode
+ *
+ *              Pass --csv to print comma separated values.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include "pas-co2-history-ino.hpp"
+
+static constexpr uint16_t storageSize = 2048;                /**< History storage in bytes */
+static constexpr uint32_t periodMs    = 60000;               /**< Nominal result period */
+static constexpr uint32_t records     = 14U * 1440U;         /**< Two weeks of one minute results */
+
+static bool csv = false;
+static uint32_t rng = 1U;
+
+typedef struct
+{
+    uint32_t    timestamp;
+    int16_t     co2PPM;
+    uint8_t     diag;
+} Raw_t;
+
+static uint32_t rnd()
+{
+    rng = rng * 1664525U + 1013904223U;
+    return rng >> 8;
+}
+
+static double gauss()
+{
+    double s = 0.0;
+
+    for(uint8_t i = 0; i < 12U; i++)
+    {
+        s += (double)rnd() / (double)(1U << 24);
+    }
+
+    return s - 6.0;
+}
+
+static std::vector<Raw_t> stream(double noise)
+{
+    std::vector<Raw_t> s(records);
+    double t = 1000.0;
+    uint8_t diag = 0x80U;   /* sen_rdy */
+
+    rng = 1U;
+
+    for(uint32_t i = 0; i < records; i++)
+    {
+        double h    = fmod((double)i / 60.0, 24.0);
+        bool   work = ((i / 1440U) % 7U) < 5U;
+        double occ  = (work && (h > 8.0) && (h < 18.0)) ? sin(M_PI * (h - 8.0) / 10.0) : 0.0;
+
+        if(0U == (i % 1000U))
+        {
+            diag ^= 0x10U;  /* orvs */
+        }
+
+        t += periodMs * 0.997 + 30.0 * gauss();
+        t += (0U == (rnd() % 500U)) ? (double)periodMs : 0.0;
+
+        s[i].timestamp = (uint32_t)t;
+        s[i].co2PPM    = (int16_t)lround(420.0 + 700.0 * occ + noise * gauss());
+        s[i].diag      = diag;
+    }
+
+    return s;
+}
+
+static double nsSince(const struct timespec & t0)
+{
+    struct timespec t1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    return (double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec);
+}
+
+template<uint16_t B>
+static void bench(const char * name, const std::vector<Raw_t> & raw, uint16_t toleranceMs)
+{
+    PASCO2History<storageSize, B> history(toleranceMs);
+    HistoryRec_t rec;
+    Diag_t diag;
+
+    for(uint32_t i = 0; i < raw.size(); i++)
+    {
+        diag.u = raw[i].diag;
+        (void)history.add(raw[i].co2PPM, diag, raw[i].timestamp);
+    }
+
+    /* The records held are the last ones */
+    PASCO2HistoryReader reader(history);
+    uint32_t base = (uint32_t)raw.size() - history.count();
+    uint32_t maxErr = 0;
+    bool exact = true;
+    uint32_t n = 0;
+
+    while(reader.next(rec))
+    {
+        const Raw_t & r = raw[base + n++];
+        int32_t err = (int32_t)(rec.timestamp - r.timestamp);
+
+        err = (err < 0) ? -err : err;
+        maxErr = ((uint32_t)err > maxErr) ? (uint32_t)err : maxErr;
+        exact = exact && (rec.co2PPM == r.co2PPM) && (rec.diag.u == r.diag);
+    }
+
+    exact = exact && (n == history.count()) && (maxErr <= toleranceMs);
+
+    double bits = 8.0 * (double)history.size() / (double)history.count();
+
+    printf(csv ? "%s,%u,%u,%u,%.2f,%.2f,%.1f,%.1f,%u,%s\n" : "%-8s %5u %6u %8u %6.2f %9.2f %9.1f %9.1f %10u %6s\n",
+           name, (unsigned)B, (unsigned)toleranceMs, (unsigned)history.count(),
+           (double)(raw[raw.size() - 1U].timestamp - raw[base].timestamp) / 86400000.0,
+           bits, 16.0 / bits, 56.0 / bits, (unsigned)maxErr, exact ? "yes" : "NO");
+}
+
+static void cost(const std::vector<Raw_t> & raw)
+{
+    static PASCO2History<storageSize> history;
+    const uint32_t rounds = 50U;
+    const uint32_t gets = 20000U;
+    struct timespec t0;
+    HistoryRec_t rec;
+    Diag_t diag;
+    volatile int32_t sink = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for(uint32_t k = 0; k < rounds; k++)
+    {
+        for(uint32_t i = 0; i < raw.size(); i++)
+        {
+            diag.u = raw[i].diag;
+            (void)history.add(raw[i].co2PPM, diag, raw[i].timestamp);
+        }
+    }
+    double addNs = nsSince(t0) / ((double)rounds * raw.size());
+
+    uint32_t decoded = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for(uint32_t k = 0; k < rounds * 10U; k++)
+    {
+        PASCO2HistoryReader reader(history);
+
+        while(reader.next(rec))
+        {
+            sink += rec.co2PPM;
+            decoded++;
+        }
+    }
+    double nextNs = nsSince(t0) / decoded;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for(uint32_t k = 0; k < gets; k++)
+    {
+        (void)history.get(rnd() % history.count(), rec);
+        sink += rec.co2PPM;
+    }
+    double getNs = nsSince(t0) / gets;
+
+    (void)sink;
+
+    if(csv)
+    {
+        printf("\ncall,ns\nadd,%.1f\nnext,%.1f\nget,%.1f\n", addNs, nextNs, getNs);
+    }
+    else
+    {
+        printf("\nhost cost: add() %.1f ns, next() %.1f ns, get() %.1f ns\n", addNs, nextNs, getNs);
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    static const double noises[] = { 3.0, 8.0, 20.0 };
+    static const char * names[] = { "quiet", "typical", "noisy" };
+
+    csv = (argc > 1) && (0 == strcmp(argv[1], "--csv"));
+
+    if(csv)
+    {
+        printf("noise,block,tolerance_ms,records,days,bits_per_record,ratio_int16,ratio_record,max_time_err_ms,exact\n");
+    }
+    else
+    {
+        printf("%u byte history, one result per minute, 7 byte raw records\n", (unsigned)storageSize);
+        printf("%-8s %5s %6s %8s %6s %9s %9s %9s %10s %6s\n",
+               "noise", "block", "tol ms", "records", "days", "bits/rec", "vs int16", "vs rec", "t err ms", "exact");
+    }
+
+    for(uint8_t k = 0; k < 3U; k++)
+    {
+        std::vector<Raw_t> raw = stream(noises[k]);
+
+        bench<64>(names[k], raw, 1000U);
+        bench<128>(names[k], raw, 1000U);
+        bench<256>(names[k], raw, 1000U);
+        bench<128>(names[k], raw, 0U);
+    }
+
+    cost(stream(8.0));
+
+    return 0;
+}
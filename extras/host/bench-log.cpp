@@ -0,0 +1,320 @@
+/**
+ * @file        bench-log.cpp
+ * @brief       Write amplification, wear and recovery of the XENSIV™ PAS CO2 persistent log
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @details     Runs PASCO2Log on the file-backed NOR flash emulation of
+ *              log-file-store.cpp, for a few page geometries:
+ *
+ *              - Endurance: a year of one minute samples, with an error
+ *                event every 1000 samples. Reports the records held and the
+ *                days they span, the write amplification (bytes programmed
+ *                and erased per 7 payload bytes of a sample: timestamp, ppm
+ *                and status), the erases of the most and least worn pages,
+ *                and the years to 100000 erase cycles at one sample per
+ *                minute.
+ *              - Recovery: the bytes read and the host time of begin() on
+ *                the full log, against a scan of all the records.
+ *              - Power cuts: 2000 cuts at a random byte of the programming
+ *                or erase operations, each followed by begin(). After each
+ *                recovery, every sample acknowledged by the log and not
+ *                evicted since must be read back, in order, and the log
+ *                must go on.
+ *
+ *              The storage file is created in the current directory.
+ *
+ *              Build and run from this directory:
+ *
+ *              @code
+ *              gcc -c -I../../src ../../src/xensiv_pasco2.c xensiv_pasco2_sim.c
+ *              g++ -std=c++11 -pthread -O2 -Iarduino -I../../src -I. bench-log.cpp log-file-store.cpp arduino/arduino_shim.cpp \
+ *                  ../../src/pas-co2-log-ino.cpp xensiv_pasco2.o xensiv_pasco2_sim.o -o bench-log
+ *              ./bench-log
+ *              @endcode
+ *
+ *              Pass --csv to print comma separated values.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+#include "log-file-store.hpp"
+
+static constexpr const char * path      = "bench-log.bin";  /**< Storage file */
+static constexpr uint32_t     samples   = 365U * 1440U;     /**< A year of one minute samples */
+static constexpr uint32_t     endurance = 100000U;          /**< Erase cycles of a flash page */
+static constexpr uint32_t     cuts      = 2000U;            /**< Power cuts */
+static constexpr uint8_t      payload   = 7U;               /**< Sample bytes: timestamp, ppm, status */
+
+static bool csv = false;
+static uint32_t rng = 1U;
+
+static uint32_t rnd()
+{
+    rng = rng * 1664525U + 1013904223U;
+    return rng >> 8;
+}
+
+static double nsSince(const struct timespec & t0)
+{
+    struct timespec t1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    return (double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec);
+}
+
+static void wear(uint16_t pageSize, uint16_t pages)
+{
+    LogFileStore_t fs;
+    LogStore_t store;
+    Diag_t diag;
+    LogRec_t rec;
+    struct timespec t0;
+
+    (void)unlink(path);
+    if(!logFileStoreOpen(&fs, &store, path, pageSize, pages))
+    {
+        printf("cannot open %s\n", path);
+        exit(1);
+    }
+
+    PASCO2Log log(&store);
+
+    (void)log.begin();
+    diag.u = 0x80U;
+
+    for(uint32_t i = 0; i < samples; i++)
+    {
+        (void)log.logSample((int16_t)(420 + (rnd() % 600U)), diag, i * 60000U);
+
+        if(0U == (i % 1000U))
+        {
+            (void)log.logEvent(LOG_EVENT_ERROR, XENSIV_PASCO2_ERR_COMM, i * 60000U);
+        }
+    }
+
+    uint32_t held = log.count();
+    uint32_t minErase = fs.erases[0];
+    uint32_t maxErase = fs.erases[0];
+
+    for(uint16_t p = 1; p < pages; p++)
+    {
+        minErase = (fs.erases[p] < minErase) ? fs.erases[p] : minErase;
+        maxErase = (fs.erases[p] > maxErase) ? fs.erases[p] : maxErase;
+    }
+
+    double programmedWA = (double)fs.programmed / ((double)samples * payload);
+    double erasedWA     = (double)fs.erased / ((double)samples * payload);
+    double years        = (double)endurance / (double)maxErase;
+
+    /* Recovery of the full log, on a power up */
+    const uint32_t boots = 200U;
+    uint64_t read = fs.read;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for(uint32_t k = 0; k < boots; k++)
+    {
+        PASCO2Log again(&store);
+
+        (void)again.begin();
+    }
+    double beginUs = nsSince(t0) / boots / 1000.0;
+    uint32_t beginRead = (uint32_t)((fs.read - read) / boots);
+
+    read = fs.read;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for(uint32_t i = 0; i < log.count(); i++)
+    {
+        (void)log.read(i, rec);
+    }
+    double scanUs = nsSince(t0) / 1000.0;
+    uint32_t scanRead = (uint32_t)(fs.read - read);
+
+    printf(csv ? "%u,%u,%u,%.1f,%.3f,%.3f,%u,%u,%.0f,%u,%.1f,%u,%.1f\n"
+               : "%5u %5u %7u %6.1f %8.3f %8.3f %6u %6u %7.0f %10u %9.1f %9u %9.1f\n",
+           (unsigned)pageSize, (unsigned)pages, (unsigned)held, (double)held / 1440.0,
+           programmedWA, erasedWA, (unsigned)minErase, (unsigned)maxErase, years,
+           (unsigned)beginRead, beginUs, (unsigned)scanRead, scanUs);
+
+    logFileStoreClose(&fs);
+    (void)unlink(path);
+}
+
+/**
+ * @brief   Checks the log after a recovery
+ * @details All the acknowledged samples from the oldest one held must be
+ *          read back in order. Only the sample being written at the power
+ *          cut may be read back without having been acknowledged, it is
+ *          then acknowledged.
+ */
+static bool check(const PASCO2Log & log, std::vector<uint32_t> & acked, uint32_t attempted)
+{
+    std::vector<uint32_t> got;
+    LogRec_t rec;
+    bool extra = false;
+
+    for(uint32_t i = 0; i < log.count(); i++)
+    {
+        if((XENSIV_PASCO2_OK == log.read(i, rec)) && (LOG_SAMPLE == rec.type))
+        {
+            got.push_back(rec.timestamp);
+        }
+    }
+
+    if(got.empty())
+    {
+        return acked.empty();
+    }
+
+    size_t a = 0;
+    while((a < acked.size()) && (acked[a] < got[0]))
+    {
+        a++;
+    }
+
+    for(size_t g = 0; g < got.size(); g++)
+    {
+        if((a < acked.size()) && (got[g] == acked[a]))
+        {
+            a++;
+        }
+        else if(got[g] == attempted)
+        {
+            extra = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    if(extra)
+    {
+        acked.push_back(attempted);
+    }
+
+    return (a + (extra ? 1U : 0U)) == acked.size();
+}
+
+static void powerCuts(uint16_t pageSize, uint16_t pages)
+{
+    LogFileStore_t fs;
+    LogStore_t store;
+    Diag_t diag;
+    std::vector<uint32_t> acked;
+    uint32_t stamp = 0;
+    uint32_t failed = 0;
+    uint32_t torn = 0;
+    uint32_t lastBoot = 0;
+    bool boots = true;
+
+    (void)unlink(path);
+    if(!logFileStoreOpen(&fs, &store, path, pageSize, pages))
+    {
+        printf("cannot open %s\n", path);
+        exit(1);
+    }
+
+    PASCO2Log log(&store);
+
+    (void)log.begin();
+    diag.u = 0x80U;
+
+    for(uint32_t k = 0; k < cuts; k++)
+    {
+        /* Cut within about two pages worth of operations, erases included */
+        logFileStoreCutAfter(&fs, (int64_t)(rnd() % (4U * pageSize)));
+
+        for(;;)
+        {
+            stamp++;
+
+            if(XENSIV_PASCO2_OK != log.logSample((int16_t)(400 + (stamp % 500U)), diag, stamp))
+            {
+                break;
+            }
+
+            acked.push_back(stamp);
+        }
+
+        logFileStoreRestore(&fs);
+
+        if(XENSIV_PASCO2_OK != log.begin())
+        {
+            failed++;
+            continue;
+        }
+
+        boots = boots && ((0U == lastBoot) || (log.boot() == (lastBoot + 1U)));
+        lastBoot = log.boot();
+        torn += log.corrupted();
+        failed += check(log, acked, stamp) ? 0U : 1U;
+
+        /* Forget the samples evicted for good */
+        if(acked.size() > (2U * log.count()))
+        {
+            acked.erase(acked.begin(), acked.end() - log.count());
+        }
+    }
+
+    printf(csv ? "%u,%u,%u,%u,%u,%u,%s\n" : "%5u %5u %6u %8u %6u %7u %6s\n",
+           (unsigned)pageSize, (unsigned)pages, (unsigned)cuts, (unsigned)stamp, (unsigned)torn,
+           (unsigned)failed, boots ? "yes" : "NO");
+
+    logFileStoreClose(&fs);
+    (void)unlink(path);
+}
+
+int main(int argc, char ** argv)
+{
+    static const struct { uint16_t pageSize; uint16_t pages; } geometries[] =
+    {
+        { 256,  16 },
+        { 512,  64 },
+        { 4096, 16 },
+    };
+    const size_t n = sizeof(geometries) / sizeof(geometries[0]);
+
+    csv = (argc > 1) && (0 == strcmp(argv[1], "--csv"));
+
+    if(csv)
+    {
+        printf("page,pages,records,days,program_wa,erase_wa,min_erases,max_erases,years_to_endurance,"
+               "begin_read_bytes,begin_us,scan_read_bytes,scan_us\n");
+    }
+    else
+    {
+        printf("%u one minute samples, %u byte payload, %u erase cycles\n",
+               (unsigned)samples, (unsigned)payload, (unsigned)endurance);
+        printf("%5s %5s %7s %6s %8s %8s %6s %6s %7s %10s %9s %9s %9s\n",
+               "page", "pages", "records", "days", "prog WA", "erase WA", "min er", "max er", "years",
+               "begin read", "begin us", "scan read", "scan us");
+    }
+
+    for(size_t g = 0; g < n; g++)
+    {
+        wear(geometries[g].pageSize, geometries[g].pages);
+    }
+
+    if(csv)
+    {
+        printf("\npage,pages,cuts,samples,torn,failed,boots_ok\n");
+    }
+    else
+    {
+        printf("\n%5s %5s %6s %8s %6s %7s %6s\n", "page", "pages", "cuts", "samples", "torn", "failed", "boots");
+    }
+
+    for(size_t g = 0; g < n; g++)
+    {
+        powerCuts(geometries[g].pageSize, geometries[g].pages);
+    }
+
+    return 0;
+}
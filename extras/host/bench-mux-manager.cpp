@@ -0,0 +1,235 @@
+/**
+ * @file        bench-mux-manager.cpp
+ * @brief       Multi-sensor manager of the XENSIV™ PAS CO2 Arduino API on the host simulator
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @details     Simulates 16 sensors at the same I2C address behind two
+ *              TCA9548A multiplexers, each sensor seeing its own CO2
+ *              concentration. The sensors are acquired for a number of
+ *              periods with:
+ *              - PASCO2Manager, sleeping until nextDueMs() between the
+ *                service() calls
+ *              - a plain round-robin loop polling every sensor every
+ *                100 ms, with the multiplexer channel selected before each
+ *                readout
+ *
+ *              For each scheme, it reports the samples read, the min and
+ *              max samples per sensor, the samples tagged with the wrong
+ *              sensor, the readouts finding no data, the multiplexer writes,
+ *              the sensor transfers, the time on the wire and the address
+ *              collisions. The bus figures include the sensors begin.
+ *
+ *              Build and run from this directory:
+ *
+ *              @code
+ *              gcc -c -I../../src ../../src/xensiv_pasco2.c xensiv_pasco2_sim.c
+ *              g++ -std=c++11 -pthread -Iarduino -I../../src -I. bench-mux-manager.cpp arduino/arduino_shim.cpp \
+ *                  ../../src/pas-co2-ino.cpp ../../src/pas-co2-mutex-ino.cpp ../../src/pas-co2-manager-ino.cpp \
+ *                  xensiv_pasco2.o xensiv_pasco2_sim.o -o bench-mux-manager
+ *              ./bench-mux-manager
+ *              @endcode
+ *
+ *              Pass --csv to print comma separated values.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <Arduino.h>
+#include <Wire.h>
+#include "pas-co2-manager-ino.hpp"
+#include "xensiv_pasco2_sim.h"
+
+static constexpr uint8_t  numSensors  = 16;      /**< Sensors, 8 per multiplexer */
+static constexpr int16_t  periodSec   = 10;      /**< Continuous mode period */
+static constexpr uint16_t periods     = 60;      /**< Acquisition length in periods */
+static constexpr uint16_t pollMs      = 100;     /**< Round-robin poll interval */
+static constexpr uint16_t basePPM     = 400;     /**< CO2 concentration seen by sensor 0 */
+static constexpr uint16_t stepPPM     = 25;      /**< CO2 concentration step between sensors */
+
+static bool csv = false;
+static xensiv_pasco2_sim_t sims[numSensors];
+
+/**
+ * @brief   Acquisition figures of a scheme
+ */
+typedef struct
+{
+    uint32_t    samples;    /**< Samples read */
+    uint32_t    minPerSens; /**< Fewest samples of a sensor */
+    uint32_t    maxPerSens; /**< Most samples of a sensor */
+    uint32_t    wrong;      /**< Samples with the concentration of another sensor */
+    uint32_t    notReady;   /**< Readouts finding no data */
+    uint32_t    muxWrites;  /**< Multiplexer control register writes */
+    uint32_t    transfers;  /**< Sensor transfers */
+    uint64_t    busUs;      /**< Sensor time on the wire */
+    uint32_t    collisions; /**< Address collisions */
+} Result_t;
+
+static void setup()
+{
+    xensiv_pasco2_sim_reset_all();
+    xensiv_pasco2_sim_add_mux(&Wire, PASCO2Mux::defaultAddr);
+    xensiv_pasco2_sim_add_mux(&Wire, PASCO2Mux::defaultAddr + 1U);
+
+    for(uint8_t i = 0; i < numSensors; i++)
+    {
+        xensiv_pasco2_sim_init(&sims[i], &Wire, XENSIV_PASCO2_SIM_I2C);
+        xensiv_pasco2_sim_set_mux_channel(&sims[i], PASCO2Mux::defaultAddr + (i / PASCO2Mux::portsPerMux), i % PASCO2Mux::portsPerMux);
+        xensiv_pasco2_sim_set_co2(&sims[i], basePPM + (stepPPM * i));
+    }
+}
+
+static void collect(Result_t & r, const uint32_t * perSensor)
+{
+    r.minPerSens = 0xFFFFFFFFU;
+
+    for(uint8_t i = 0; i < numSensors; i++)
+    {
+        xensiv_pasco2_sim_stats_t stats;
+
+        xensiv_pasco2_sim_get_stats(&sims[i], &stats);
+        r.transfers += stats.transfers;
+        r.busUs     += stats.bus_us;
+
+        r.minPerSens = (perSensor[i] < r.minPerSens) ? perSensor[i] : r.minPerSens;
+        r.maxPerSens = (perSensor[i] > r.maxPerSens) ? perSensor[i] : r.maxPerSens;
+    }
+
+    uint32_t writes;
+
+    (void)xensiv_pasco2_sim_get_mux(&Wire, PASCO2Mux::defaultAddr, &writes);
+    r.muxWrites = writes;
+    (void)xensiv_pasco2_sim_get_mux(&Wire, PASCO2Mux::defaultAddr + 1U, &writes);
+    r.muxWrites += writes;
+
+    r.collisions = xensiv_pasco2_sim_get_collisions();
+}
+
+static void check(Result_t & r, uint32_t * perSensor, uint8_t sensor, const Sample_t & sample)
+{
+    r.samples++;
+    perSensor[sensor]++;
+
+    if(sample.co2PPM != (int16_t)(basePPM + (stepPPM * sensor)))
+    {
+        r.wrong++;
+    }
+}
+
+static Result_t runManager()
+{
+    static PASCO2Manager<numSensors> manager(&Wire);
+    PASCO2MuxSampleRing<32> ring;
+    MuxSample_t sample;
+    Result_t r = {};
+    uint32_t perSensor[numSensors] = {};
+
+    setup();
+
+    (void)manager.begin(periodSec);
+
+    uint32_t end = millis() + (uint32_t)periods * periodSec * 1000U;
+
+    while((int32_t)(end - millis()) > 0)
+    {
+        (void)manager.service(ring);
+
+        while(ring.pop(sample))
+        {
+            check(r, perSensor, sample.sensor, sample.sample);
+        }
+
+        uint32_t sleep = manager.nextDueMs();
+        uint32_t left  = end - millis();
+
+        delay((sleep < left) ? sleep : left);
+    }
+
+    for(uint8_t i = 0; i < numSensors; i++)
+    {
+        r.notReady += manager.slot(i).notReady;
+    }
+
+    collect(r, perSensor);
+    (void)manager.end();
+
+    return r;
+}
+
+static Result_t runRoundRobin()
+{
+    static PASCO2<PASCO2I2C> sensors[numSensors];
+    PASCO2Mux mux(&Wire);
+    Sample_t sample;
+    Result_t r = {};
+    uint32_t perSensor[numSensors] = {};
+
+    setup();
+
+    (void)mux.reset(0x03U);
+
+    for(uint8_t i = 0; i < numSensors; i++)
+    {
+        (void)mux.select(i);
+        (void)sensors[i].begin();
+        (void)sensors[i].startMeasure(periodSec);
+    }
+
+    uint32_t end = millis() + (uint32_t)periods * periodSec * 1000U;
+
+    while((int32_t)(end - millis()) > 0)
+    {
+        for(uint8_t i = 0; i < numSensors; i++)
+        {
+            (void)mux.select(i);
+
+            Error_t ret = sensors[i].service(sample);
+
+            if(XENSIV_PASCO2_OK == ret)
+            {
+                check(r, perSensor, i, sample);
+            }
+            else if(XENSIV_PASCO2_READ_NRDY == ret)
+            {
+                r.notReady++;
+            }
+        }
+
+        delay(pollMs);
+    }
+
+    collect(r, perSensor);
+
+    return r;
+}
+
+static void report(const char * scheme, const Result_t & r)
+{
+    printf(csv ? "%s,%u,%u,%u,%u,%u,%u,%u,%.3f,%u\n" : "%-12s %8u %6u %6u %6u %9u %10u %10u %12.3f %10u\n",
+           scheme, (unsigned)r.samples, (unsigned)r.minPerSens, (unsigned)r.maxPerSens, (unsigned)r.wrong,
+           (unsigned)r.notReady, (unsigned)r.muxWrites, (unsigned)r.transfers, (double)r.busUs / 1000.0,
+           (unsigned)r.collisions);
+}
+
+int main(int argc, char ** argv)
+{
+    csv = (argc > 1) && (0 == strcmp(argv[1], "--csv"));
+
+    if(csv)
+    {
+        printf("scheme,samples,min_per_sensor,max_per_sensor,wrong,not_ready,mux_writes,transfers,bus_ms,collisions\n");
+    }
+    else
+    {
+        printf("%u sensors, %d s period, %u periods\n", (unsigned)numSensors, (int)periodSec, (unsigned)periods);
+        printf("%-12s %8s %6s %6s %6s %9s %10s %10s %12s %10s\n",
+               "scheme", "samples", "min", "max", "wrong", "not ready", "mux writes", "transfers", "bus ms", "collisions");
+    }
+
+    report("manager", runManager());
+    report("round-robin", runRoundRobin());
+
+    return 0;
+}
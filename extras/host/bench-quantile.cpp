@@ -0,0 +1,246 @@
+/**
+ * @file        bench-quantile.cpp
+ * @brief       Error bounds and update cost of the XENSIV™ PAS CO2 streaming quantile sketch
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @details     Feeds PASCO2Quantiles with synthetic CO2 streams and compares
+ *              its estimates to the exact quantiles of the sorted stream:
+ *              - office: a day of results, 420 ppm at night and occupancy
+ *                peaks up to 1600 ppm in the working hours
+ *              - uniform: 400 to 5000 ppm
+ *              - tail: 420 ppm plus an exponential tail of 300 ppm mean
+ *
+ *              For each stream length and sub-bucket bits, it reports the
+ *              relative error of P50, P95 and P99, the worst relative error
+ *              over all the per mille quantiles, the bound 2^-(B+1), and the
+ *              serialized size. The stream is also split over four sketches
+ *              which are merged, and the sketch is serialized and loaded
+ *              back: both must give the same quantiles as the single sketch.
+ *              Finally the host time per add() and per quantile() is
+ *              measured.
+ *
+ *              Build and run from this directory:
+ *
+ *              @code
+ *              g++ -std=c++11 -O2 -Iarduino -I../../src -I. bench-quantile.cpp -o bench-quantile -lm
+ *              ./bench-quantile
+ *              @endcode
+ *
+ *              Pass --csv to print comma separated values.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+#include "pas-co2-quantile-ino.hpp"
+
+static bool csv = false;
+static uint32_t rng = 1U;
+
+static uint32_t rnd()
+{
+    rng = rng * 1664525U + 1013904223U;
+    return rng >> 8;
+}
+
+static double unit()
+{
+    return (double)rnd() / (double)(1U << 24);
+}
+
+static std::vector<int16_t> office(size_t n)
+{
+    std::vector<int16_t> s(n);
+
+    for(size_t i = 0; i < n; i++)
+    {
+        double h = 24.0 * (double)(i % n) / (double)n;
+        double occ = ((h > 8.0) && (h < 18.0)) ? sin(M_PI * (h - 8.0) / 10.0) : 0.0;
+        double peak = 800.0 + 400.0 * sin(2.0 * M_PI * (double)(i / (n / 7U + 1U)) / 7.0);
+
+        s[i] = (int16_t)(420.0 + occ * peak + 20.0 * (unit() - 0.5));
+    }
+
+    return s;
+}
+
+static std::vector<int16_t> uniform(size_t n)
+{
+    std::vector<int16_t> s(n);
+
+    for(size_t i = 0; i < n; i++)
+    {
+        s[i] = (int16_t)(400U + rnd() % 4601U);
+    }
+
+    return s;
+}
+
+static std::vector<int16_t> tail(size_t n)
+{
+    std::vector<int16_t> s(n);
+
+    for(size_t i = 0; i < n; i++)
+    {
+        double x = 420.0 - 300.0 * log(1.0 - unit());
+
+        s[i] = (int16_t)((x > 32767.0) ? 32767.0 : x);
+    }
+
+    return s;
+}
+
+static int16_t exact(const std::vector<int16_t> & sorted, uint16_t permille)
+{
+    size_t rank = (size_t)(((uint64_t)permille * sorted.size() + 999U) / 1000U);
+
+    rank = (0U == rank) ? 1U : rank;
+
+    return sorted[rank - 1U];
+}
+
+static double relErr(int16_t est, int16_t ref)
+{
+    return (0 == ref) ? 0.0 : 100.0 * fabs((double)est - (double)ref) / (double)ref;
+}
+
+template<uint8_t B>
+static void bench(const char * name, const std::vector<int16_t> & stream)
+{
+    typedef PASCO2Quantiles<B, uint32_t> Sketch;
+
+    static Sketch one;
+    static Sketch part[4];
+    static Sketch merged;
+    static Sketch loaded;
+    static uint8_t bin[Sketch::maxSerializedSize];
+
+    std::vector<int16_t> sorted(stream);
+    std::sort(sorted.begin(), sorted.end());
+
+    one.reset();
+    merged.reset();
+
+    for(uint8_t k = 0; k < 4U; k++)
+    {
+        part[k].reset();
+    }
+
+    for(size_t i = 0; i < stream.size(); i++)
+    {
+        one.add(stream[i]);
+        part[i % 4U].add(stream[i]);
+    }
+
+    for(uint8_t k = 0; k < 4U; k++)
+    {
+        merged.merge(part[k]);
+    }
+
+    size_t size = one.serialize(bin, sizeof(bin));
+    bool roundTrip = loaded.deserialize(bin, size);
+    bool mergeOK = (merged.count() == one.count());
+    double worst = 0.0;
+
+    for(uint16_t q = 0; q <= 1000U; q++)
+    {
+        double e = relErr(one.quantile(q), exact(sorted, q));
+
+        worst = (e > worst) ? e : worst;
+        mergeOK = mergeOK && (merged.quantile(q) == one.quantile(q));
+        roundTrip = roundTrip && (loaded.quantile(q) == one.quantile(q));
+    }
+
+    printf(csv ? "%s,%zu,%u,%.3f,%.3f,%.3f,%.3f,%.3f,%zu,%u,%s,%s\n"
+               : "%-8s %7zu %2u %8.3f %8.3f %8.3f %9.3f %8.3f %6zu %6u %6s %6s\n",
+           name, stream.size(), (unsigned)B,
+           relErr(one.quantile(500), exact(sorted, 500)),
+           relErr(one.quantile(950), exact(sorted, 950)),
+           relErr(one.quantile(990), exact(sorted, 990)),
+           worst, 100.0 / (double)(2U << B), size, (unsigned)(Sketch::buckets * sizeof(uint16_t)),
+           mergeOK ? "yes" : "NO", roundTrip ? "yes" : "NO");
+}
+
+static double nsSince(const struct timespec & t0)
+{
+    struct timespec t1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    return (double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec);
+}
+
+static void cost()
+{
+    static PASCO2Quantiles<5> sketch;
+    const uint32_t adds = 10000000U;
+    const uint32_t queries = 100000U;
+    std::vector<int16_t> stream = tail(4096);
+    struct timespec t0;
+    volatile int32_t sink = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for(uint32_t i = 0; i < adds; i++)
+    {
+        sketch.add(stream[i & 4095U]);
+    }
+    double addNs = nsSince(t0) / adds;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for(uint32_t i = 0; i < queries; i++)
+    {
+        sink += sketch.quantile((uint16_t)(i % 1001U));
+    }
+    double queryNs = nsSince(t0) / queries;
+
+    (void)sink;
+
+    if(csv)
+    {
+        printf("\ncall,ns\nadd,%.1f\nquantile,%.1f\n", addNs, queryNs);
+    }
+    else
+    {
+        printf("\nB=5 host cost: add() %.1f ns, quantile() %.1f ns, sketch %zu bytes\n", addNs, queryNs, sizeof(sketch));
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    static const size_t lengths[] = { 1440U, 17280U, 100000U };
+
+    csv = (argc > 1) && (0 == strcmp(argv[1], "--csv"));
+
+    if(csv)
+    {
+        printf("stream,n,bits,p50_err_pct,p95_err_pct,p99_err_pct,worst_err_pct,bound_pct,serialized_bytes,ram_bytes_u16,merge_exact,roundtrip\n");
+    }
+    else
+    {
+        printf("%-8s %7s %2s %8s %8s %8s %9s %8s %6s %6s %6s %6s\n",
+               "stream", "n", "B", "P50 err%", "P95 err%", "P99 err%", "worst err", "bound %", "ser B", "RAM B", "merge", "load");
+    }
+
+    for(size_t n : lengths)
+    {
+        std::vector<int16_t> streams[3] = { office(n), uniform(n), tail(n) };
+        const char * names[3] = { "office", "uniform", "tail" };
+
+        for(uint8_t k = 0; k < 3U; k++)
+        {
+            bench<4>(names[k], streams[k]);
+            bench<5>(names[k], streams[k]);
+            bench<6>(names[k], streams[k]);
+        }
+    }
+
+    cost();
+
+    return 0;
+}
@@ -0,0 +1,242 @@
+/**
+ * @file        bench-rate.cpp
+ * @brief       Samples saved against tracking error of the XENSIV™ PAS CO2 adaptive measurement rate
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @details     Runs a simulated sensor in continuous mode for a week of a
+ *              meeting room: 420 ppm at night and over the weekend, four
+ *              meetings a working day with a first order build-up towards
+ *              1400 ppm (15 minutes time constant), crossing the 1000 ppm
+ *              alarm threshold, a 30 minutes decay in between, and an
+ *              airing at noon. The results have 10 ppm of noise.
+ *
+ *              Each fixed period and PASCO2RateControl setup is run on the
+ *              same week. The result held by the application, the last one
+ *              read, is compared every second to the noiseless
+ *              concentration. The bench reports the measurement sequences
+ *              run, the share saved against a fixed 60 s period, the bytes
+ *              on the bus (readouts and period changes), the period
+ *              changes, the mean, 95th percentile and max tracking error,
+ *              and the mean and max delay from the concentration crossing
+ *              the alarm threshold to a result above it.
+ *
+ *              Build and run from this directory:
+ *
+ *              @code
+ *              gcc -c -I../../src ../../src/xensiv_pasco2.c xensiv_pasco2_sim.c
+ *              g++ -std=c++11 -pthread -O2 -Iarduino -I../../src -I. bench-rate.cpp arduino/arduino_shim.cpp \
+ *                  ../../src/pas-co2-ino.cpp ../../src/pas-co2-mutex-ino.cpp ../../src/pas-co2-rate-ino.cpp \
+ *                  xensiv_pasco2.o xensiv_pasco2_sim.o -o bench-rate
+ *              ./bench-rate
+ *              @endcode
+ *
+ *              Pass --csv to print comma separated values.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include <Arduino.h>
+#include <Wire.h>
+#include "pas-co2-rate-ino.hpp"
+#include "xensiv_pasco2_sim.h"
+
+static constexpr uint32_t days      = 7;        /**< Acquisition length, Monday to Sunday */
+static constexpr int16_t  alarmTh   = 1000;     /**< Alarm threshold in ppm */
+static constexpr uint16_t noisePPM  = 10;       /**< Result noise amplitude */
+
+static bool csv = false;
+
+/**
+ * @brief   Setup of a run
+ */
+typedef struct
+{
+    const char    * name;           /**< Setup name */
+    int16_t         periodSec;      /**< Fixed period, or initial period if adaptive */
+    bool            adaptive;       /**< Adaptive period */
+    int16_t         maxSec;         /**< Maximum adaptive period */
+    uint16_t        tolerancePPM;   /**< Adaptive tolerance */
+    bool            alarm;          /**< Alarm proximity enabled */
+} Setup_t;
+
+/**
+ * @brief   Noiseless concentration, one value per second
+ */
+static std::vector<float> profile()
+{
+    static const struct { double from; double to; } meetings[] =
+    {
+        { 9.0, 10.0 }, { 11.0, 11.5 }, { 14.0, 15.5 }, { 16.5, 17.0 },
+    };
+    std::vector<float> c(days * 86400U);
+    double v = 420.0;
+
+    for(uint32_t t = 0; t < c.size(); t++)
+    {
+        double h    = (double)(t % 86400U) / 3600.0;
+        bool   work = ((t / 86400U) % 7U) < 5U;
+        double eq   = 420.0;
+        double tau  = 30.0;
+
+        for(size_t m = 0; m < sizeof(meetings) / sizeof(meetings[0]); m++)
+        {
+            if(work && (h >= meetings[m].from) && (h < meetings[m].to))
+            {
+                eq  = 1400.0;
+                tau = 15.0;
+            }
+        }
+
+        if(work && (h >= 12.0) && (h < 12.17))
+        {
+            eq  = 430.0;
+            tau = 3.0;
+        }
+
+        v += (eq - v) / (tau * 60.0);
+        c[t] = (float)v;
+    }
+
+    return c;
+}
+
+static void run(const Setup_t & s, const std::vector<float> & truth, uint32_t baseline, uint32_t & results)
+{
+    xensiv_pasco2_sim_t sim;
+    xensiv_pasco2_sim_stats_t stats;
+    PASCO2RateControl rate(PASCO2RateControl::defaultMinSec, s.maxSec, s.tolerancePPM, noisePPM);
+    std::vector<float> err(truth.size());
+    uint32_t writes = 0;
+    uint32_t crossings = 0;
+    uint32_t delaySum = 0;
+    uint32_t delayMax = 0;
+    int16_t  held = 420;
+    bool     above = false;
+    uint32_t crossed = 0;
+    bool     waiting = false;
+    int16_t  co2ppm;
+
+    xensiv_pasco2_sim_reset_all();
+    xensiv_pasco2_sim_init(&sim, &Wire, XENSIV_PASCO2_SIM_I2C);
+    xensiv_pasco2_sim_set_error(&sim, 0, noisePPM, 1U);
+    xensiv_pasco2_sim_set_co2(&sim, (uint16_t)lroundf(truth[0]));
+
+    PASCO2Ino cotwo(&Wire);
+
+    /* No baseline compensation, the room reads its true concentration */
+    (void)cotwo.begin();
+    (void)cotwo.setABOC(XENSIV_PASCO2_BOC_CFG_DISABLE, 0);
+    rate.reset(s.periodSec);
+    rate.setAlarm(s.alarm ? alarmTh : 0);
+    (void)cotwo.startMeasure(s.periodSec);
+    xensiv_pasco2_sim_reset_stats(&sim);
+
+    results = 0;
+
+    for(uint32_t t = 0; t < truth.size(); t++)
+    {
+        xensiv_pasco2_sim_set_co2(&sim, (uint16_t)lroundf(truth[t]));
+        delay(1000);
+
+        /* Read out on data ready, as with the interrupt */
+        if(0U != (xensiv_pasco2_sim_get_regs(&sim)[XENSIV_PASCO2_REG_MEAS_STS] & XENSIV_PASCO2_REG_MEAS_STS_DRDY_MSK))
+        {
+            if(XENSIV_PASCO2_OK == cotwo.getCO2(co2ppm))
+            {
+                held = co2ppm;
+                results++;
+
+                if(s.adaptive)
+                {
+                    (void)rate.update(co2ppm, millis());
+                    writes += rate.pending() ? 1U : 0U;
+                    (void)rate.apply(cotwo);
+                }
+            }
+        }
+
+        err[t] = fabsf(truth[t] - (float)held);
+
+        if(!above && (truth[t] >= alarmTh))
+        {
+            crossed = t;
+            waiting = true;
+            crossings++;
+        }
+        above = (truth[t] >= alarmTh);
+
+        if(waiting && (held >= alarmTh))
+        {
+            delaySum += t - crossed;
+            delayMax  = ((t - crossed) > delayMax) ? (t - crossed) : delayMax;
+            waiting   = false;
+        }
+    }
+
+    xensiv_pasco2_sim_get_stats(&sim, &stats);
+
+    double mean = 0.0;
+    for(size_t i = 0; i < err.size(); i++)
+    {
+        mean += err[i];
+    }
+    mean /= (double)err.size();
+
+    float maxErr = *std::max_element(err.begin(), err.end());
+    std::nth_element(err.begin(), err.begin() + (err.size() * 95U) / 100U, err.end());
+    float p95 = err[(err.size() * 95U) / 100U];
+
+    double saved = (0U == baseline) ? 0.0 : 100.0 * (1.0 - (double)results / (double)baseline);
+
+    printf(csv ? "%s,%u,%.1f,%u,%u,%.1f,%.1f,%.1f,%.1f,%u\n" : "%-18s %8u %7.1f %9u %7u %8.1f %7.1f %7.1f %9.1f %9u\n",
+           s.name, (unsigned)results, saved, (unsigned)(stats.tx_bytes + stats.rx_bytes), (unsigned)writes,
+           mean, (double)p95, (double)maxErr,
+           (0U == crossings) ? 0.0 : (double)delaySum / crossings, (unsigned)delayMax);
+
+    xensiv_pasco2_sim_deinit(&sim);
+}
+
+int main(int argc, char ** argv)
+{
+    static const Setup_t setups[] =
+    {
+        { "fixed 60 s",         60,  false, 0,    0,  false },
+        { "fixed 10 s",         10,  false, 0,    0,  false },
+        { "fixed 120 s",        120, false, 0,    0,  false },
+        { "fixed 300 s",        300, false, 0,    0,  false },
+        { "adaptive 120 s",     10,  true,  120,  20, false },
+        { "adaptive 300 s",     10,  true,  300,  20, false },
+        { "adaptive 300 s al",  10,  true,  300,  20, true  },
+        { "adaptive 600 s al",  10,  true,  600,  20, true  },
+    };
+    std::vector<float> truth = profile();
+    uint32_t baseline = 0;
+    uint32_t results;
+
+    csv = (argc > 1) && (0 == strcmp(argv[1], "--csv"));
+
+    if(csv)
+    {
+        printf("setup,results,saved_pct,bus_bytes,rate_writes,err_mean_ppm,err_p95_ppm,err_max_ppm,alarm_delay_mean_s,alarm_delay_max_s\n");
+    }
+    else
+    {
+        printf("%u days, %u ppm noise, alarm at %d ppm, savings against a fixed 60 s period\n",
+               (unsigned)days, (unsigned)noisePPM, (int)alarmTh);
+        printf("%-18s %8s %7s %9s %7s %8s %7s %7s %9s %9s\n",
+               "setup", "results", "saved %", "bus bytes", "writes", "err mean", "err p95", "err max", "alarm dly", "alarm max");
+    }
+
+    for(size_t k = 0; k < sizeof(setups) / sizeof(setups[0]); k++)
+    {
+        run(setups[k], truth, baseline, results);
+        baseline = (0U == k) ? results : baseline;
+    }
+
+    return 0;
+}
@@ -0,0 +1,309 @@
+/**
+ * @file        bench-rollup.cpp
+ * @brief       Accuracy and cost of the XENSIV™ PAS CO2 multi-resolution rollup
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @details     Feeds PASCO2Rollup<60, 24, 7> with ten days of synthetic
+ *              continuous mode results, one per minute: an office profile
+ *              with a 420 ppm baseline, occupancy peaks on the working days
+ *              and 8 ppm of noise. The sensor clock is 0.3 % fast with 30 ms
+ *              of readout jitter, a result is missed every 500, and the
+ *              sensor is off for 3 hours on the fourth day.
+ *
+ *              Every closed minute, hour and day bin held is checked against the
+ *              raw results of its time span: the count, min, max and sum
+ *              must be exact, and the time integral within the rounding of
+ *              its minute bins. Then, for windows of 1 hour to 7 days, the
+ *              rollup TWA is compared to the exact TWA of the same window
+ *              and of the span of the bins it combines, and the time of a
+ *              rollup query is compared to a rescan of the raw results of
+ *              the window, which would take 6 bytes per result of RAM on
+ *              the device. Finally the host time per update() is measured.
+ *
+ *              Build and run from this directory:
+ *
+ *              @code
+ *              gcc -c -I../../src ../../src/xensiv_pasco2.c xensiv_pasco2_sim.c
+ *              g++ -std=c++11 -pthread -O2 -Iarduino -I../../src -I. bench-rollup.cpp arduino/arduino_shim.cpp \
+ *                  xensiv_pasco2.o xensiv_pasco2_sim.o -o bench-rollup
+ *              ./bench-rollup
+ *              @endcode
+ *
+ *              Pass --csv to print comma separated values.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+#include "pas-co2-rollup-ino.hpp"
+
+typedef PASCO2Rollup<60, 24, 7> Rollup;
+
+static constexpr int16_t  periodSec = 60;                   /**< Continuous mode period */
+static constexpr uint32_t days      = 10;                   /**< Acquisition length */
+static constexpr uint32_t holdMs    = periodSec * 2500U;    /**< Longest hold of a result, as the rollup */
+
+static bool csv = false;
+static uint32_t rng = 1U;
+
+typedef struct
+{
+    uint32_t    timestamp;
+    int16_t     co2PPM;
+} Raw_t;
+
+static uint32_t rnd()
+{
+    rng = rng * 1664525U + 1013904223U;
+    return rng >> 8;
+}
+
+static double gauss()
+{
+    double s = 0.0;
+
+    for(uint8_t i = 0; i < 12U; i++)
+    {
+        s += (double)rnd() / (double)(1U << 24);
+    }
+
+    return s - 6.0;
+}
+
+static std::vector<Raw_t> stream()
+{
+    std::vector<Raw_t> s;
+    double t = 12345.0;
+
+    while(t < (double)days * Rollup::dayMs)
+    {
+        double h    = fmod(t / Rollup::hourMs, 24.0);
+        bool   work = ((uint32_t)(t / Rollup::dayMs) % 7U) < 5U;
+        double occ  = (work && (h > 8.0) && (h < 18.0)) ? sin(M_PI * (h - 8.0) / 10.0) : 0.0;
+        bool   off  = (t > 3.5 * Rollup::dayMs) && (t < (3.5 * Rollup::dayMs + 3.0 * Rollup::hourMs));
+        Raw_t  r;
+
+        t += periodSec * 1000.0 * 0.997 + 30.0 * gauss();
+
+        if(!off && (0U != (rnd() % 500U)))
+        {
+            r.timestamp = (uint32_t)t;
+            r.co2PPM    = (int16_t)lround(420.0 + 700.0 * occ + 8.0 * gauss());
+            s.push_back(r);
+        }
+    }
+
+    return s;
+}
+
+static bool before(const Raw_t & r, uint32_t t)
+{
+    return r.timestamp < t;
+}
+
+/**
+ * @brief   Exact aggregate of the raw results within [from, to)
+ */
+static void exact(const std::vector<Raw_t> & raw, uint32_t from, uint32_t to, Rollup_t & agg, double & areaMs, double & coverMs)
+{
+    agg.sum = 0;
+    agg.count = 0;
+    agg.minimum = INT16_MAX;
+    agg.maximum = INT16_MIN;
+    areaMs = 0.0;
+    coverMs = 0.0;
+
+    /* From the result held at the window start */
+    size_t i = (size_t)(std::lower_bound(raw.begin(), raw.end(), from, before) - raw.begin());
+
+    for(i = (i > 0U) ? (i - 1U) : 0U; (i < raw.size()) && (raw[i].timestamp < to); i++)
+    {
+        uint32_t t = raw[i].timestamp;
+
+        if((t >= from) && (t < to))
+        {
+            agg.sum += raw[i].co2PPM;
+            agg.count++;
+            agg.minimum = (raw[i].co2PPM < agg.minimum) ? raw[i].co2PPM : agg.minimum;
+            agg.maximum = (raw[i].co2PPM > agg.maximum) ? raw[i].co2PPM : agg.maximum;
+        }
+
+        if(((i + 1U) < raw.size()) && ((raw[i + 1U].timestamp - t) <= holdMs))
+        {
+            uint32_t a = (t > from) ? t : from;
+            uint32_t b = (raw[i + 1U].timestamp < to) ? raw[i + 1U].timestamp : to;
+
+            if(b > a)
+            {
+                areaMs  += (double)raw[i].co2PPM * (b - a);
+                coverMs += (double)(b - a);
+            }
+        }
+    }
+}
+
+static double nsSince(const struct timespec & t0)
+{
+    struct timespec t1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    return (double)(t1.tv_sec - t0.tv_sec) * 1e9 + (double)(t1.tv_nsec - t0.tv_nsec);
+}
+
+/**
+ * @brief   Checks the closed bins of a tier against the raw results
+ */
+static void checkTier(const Rollup & rollup, const std::vector<Raw_t> & raw, RollupTier_t tier, const char * name, uint32_t width)
+{
+    uint16_t bad = 0;
+    uint16_t checked = 0;
+    double worstArea = 0.0;
+
+    for(uint16_t age = 1; age < rollup.bins(tier); age++)
+    {
+        Rollup_t bin;
+        Rollup_t ref;
+        uint32_t start;
+        double areaMs;
+        double coverMs;
+
+        (void)rollup.bin(tier, age, bin, &start);
+        exact(raw, start, start + width, ref, areaMs, coverMs);
+
+        double areaErr = fabs((double)bin.area - areaMs / 1000.0);
+
+        worstArea = (areaErr > worstArea) ? areaErr : worstArea;
+        bad += ((bin.count != ref.count) || (bin.sum != ref.sum) || (bin.minimum != ref.minimum) ||
+                (bin.maximum != ref.maximum) || (areaErr > (width / 60000U) * 0.5 + 1.0)) ? 1U : 0U;
+        checked++;
+    }
+
+    printf(csv ? "%s,%u,%u,%.1f\n" : "%-6s bins %3u, mismatches %u, worst integral error %.1f ppm.s\n",
+           name, (unsigned)checked, (unsigned)bad, worstArea);
+}
+
+int main(int argc, char ** argv)
+{
+    static const struct { const char * name; uint32_t ms; } windows[] =
+    {
+        { "1 h",  Rollup::hourMs },
+        { "8 h",  8U * Rollup::hourMs },
+        { "24 h", Rollup::dayMs },
+        { "7 d",  7U * Rollup::dayMs },
+    };
+    static Rollup rollup(periodSec);
+    std::vector<Raw_t> raw = stream();
+    struct timespec t0;
+    volatile int32_t sink = 0;
+
+    csv = (argc > 1) && (0 == strcmp(argv[1], "--csv"));
+
+    const uint32_t rounds = 20U;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for(uint32_t k = 0; k < rounds; k++)
+    {
+        rollup.reset();
+
+        for(size_t i = 0; i < raw.size(); i++)
+        {
+            rollup.update(raw[i].co2PPM, raw[i].timestamp);
+        }
+    }
+    double updateNs = nsSince(t0) / ((double)rounds * raw.size());
+
+    if(csv)
+    {
+        printf("tier,bins,mismatches,worst_integral_err_ppm_s\n");
+    }
+    else
+    {
+        printf("%u results over %u days, rollup %u bytes, raw results %u bytes\n",
+               (unsigned)raw.size(), (unsigned)days, (unsigned)sizeof(rollup), (unsigned)(raw.size() * 6U));
+    }
+
+    checkTier(rollup, raw, ROLLUP_MINUTE, "minute", Rollup::minuteMs);
+    checkTier(rollup, raw, ROLLUP_HOUR, "hour", Rollup::hourMs);
+    checkTier(rollup, raw, ROLLUP_DAY, "day", Rollup::dayMs);
+
+    if(csv)
+    {
+        printf("\nwindow,span_h,twa,twa_exact_window,twa_exact_span,mean,min,max,query_ns,rescan_ns\n");
+    }
+    else
+    {
+        printf("\n%-6s %8s %6s %12s %10s %6s %6s %6s %10s %10s\n",
+               "window", "span h", "TWA", "exact window", "exact span", "mean", "min", "max", "query ns", "rescan ns");
+    }
+
+    uint32_t last = raw.back().timestamp;
+
+    for(size_t w = 0; w < sizeof(windows) / sizeof(windows[0]); w++)
+    {
+        Rollup_t agg;
+        Rollup_t ref;
+        double areaMs;
+        double coverMs;
+        const uint32_t queries = 10000U;
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for(uint32_t k = 0; k < queries; k++)
+        {
+            sink += rollup.twa(windows[w].ms);
+        }
+        double queryNs = nsSince(t0) / queries;
+
+        rollup.window(windows[w].ms, agg);
+
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for(uint32_t k = 0; k < 20U; k++)
+        {
+            exact(raw, last - windows[w].ms, last + 1U, ref, areaMs, coverMs);
+            sink += (int32_t)areaMs;
+        }
+        double rescanNs = nsSince(t0) / 20.0;
+        double twaWindow = areaMs / coverMs;
+
+        /* The combined bins span back from the last result over the covered time, gaps aside */
+        uint32_t span = 0;
+        Rollup_t bin;
+        uint32_t start = last;
+        RollupTier_t tier = (windows[w].ms <= 3600000U) ? ROLLUP_MINUTE : ((windows[w].ms <= Rollup::dayMs) ? ROLLUP_HOUR : ROLLUP_DAY);
+        uint32_t width = (ROLLUP_MINUTE == tier) ? Rollup::minuteMs : ((ROLLUP_HOUR == tier) ? Rollup::hourMs : Rollup::dayMs);
+
+        for(uint16_t age = 0; rollup.bin(tier, age, bin, &start); age++)
+        {
+            if((int32_t)((start + width) - (last - windows[w].ms)) <= 0)
+            {
+                break;
+            }
+            span = last - start;
+        }
+
+        exact(raw, last - span, last + 1U, ref, areaMs, coverMs);
+
+        printf(csv ? "%s,%.2f,%d,%.2f,%.2f,%d,%d,%d,%.1f,%.1f\n" : "%-6s %8.2f %6d %12.2f %10.2f %6d %6d %6d %10.1f %10.1f\n",
+               windows[w].name, (double)span / Rollup::hourMs, (int)Rollup::twa(agg), twaWindow, areaMs / coverMs,
+               (int)Rollup::mean(agg), (int)agg.minimum, (int)agg.maximum, queryNs, rescanNs);
+    }
+
+    (void)sink;
+
+    if(csv)
+    {
+        printf("\ncall,ns\nupdate,%.1f\n", updateNs);
+    }
+    else
+    {
+        printf("\nhost cost: update() %.1f ns\n", updateNs);
+    }
+
+    return 0;
+}
@@ -0,0 +1,210 @@
+/**
+ * @file        bench-stagger.cpp
+ * @brief       Staggered continuous mode of the XENSIV™ PAS CO2 multi-sensor manager on the host simulator
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @details     Simulates 16 sensors behind two TCA9548A multiplexers,
+ *              acquired by PASCO2Manager with the continuous mode starts
+ *              aligned and staggered over the period. The manager is
+ *              serviced every millisecond, and every millisecond the bench
+ *              samples:
+ *              - the sensors running a measurement sequence, a proxy of the
+ *                supply current peaks
+ *              - the sensors holding a result not read out yet, i.e. the
+ *                concurrent bus demand
+ *              - the time on the wire in a sliding 100 ms window
+ *
+ *              It reports the peak and mean of each, and the max and mean
+ *              time a result waits for its readout. The first period, in
+ *              which the staggered sensors start, is left out.
+ *
+ *              Build and run from this directory:
+ *
+ *              @code
+ *              gcc -c -I../../src ../../src/xensiv_pasco2.c xensiv_pasco2_sim.c
+ *              g++ -std=c++11 -pthread -Iarduino -I../../src -I. bench-stagger.cpp arduino/arduino_shim.cpp \
+ *                  ../../src/pas-co2-ino.cpp ../../src/pas-co2-mutex-ino.cpp ../../src/pas-co2-manager-ino.cpp \
+ *                  xensiv_pasco2.o xensiv_pasco2_sim.o -o bench-stagger
+ *              ./bench-stagger
+ *              @endcode
+ *
+ *              Pass --csv to print comma separated values.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <Arduino.h>
+#include <Wire.h>
+#include "pas-co2-manager-ino.hpp"
+#include "xensiv_pasco2_sim.h"
+
+static constexpr uint8_t  numSensors  = 16;      /**< Sensors, 8 per multiplexer */
+static constexpr int16_t  periodSec   = 10;      /**< Continuous mode period */
+static constexpr uint16_t periods     = 30;      /**< Acquisition length in periods */
+static constexpr uint16_t windowMs    = 100;     /**< Bus time window */
+
+static bool csv = false;
+static xensiv_pasco2_sim_t sims[numSensors];
+
+/**
+ * @brief   Figures of a run
+ */
+typedef struct
+{
+    uint32_t    samples;        /**< Samples read */
+    uint8_t     measPeak;       /**< Most sensors measuring at once */
+    double      measMean;       /**< Mean sensors measuring */
+    uint8_t     pendingPeak;    /**< Most results waiting for their readout at once */
+    double      pendingMean;    /**< Mean results waiting for their readout */
+    uint32_t    busPeakUs;      /**< Most time on the wire in a window */
+    uint32_t    waitMaxMs;      /**< Longest wait of a result for its readout */
+    double      waitMeanMs;     /**< Mean wait of a result for its readout */
+} Result_t;
+
+static void setup()
+{
+    xensiv_pasco2_sim_reset_all();
+    xensiv_pasco2_sim_add_mux(&Wire, PASCO2Mux::defaultAddr);
+    xensiv_pasco2_sim_add_mux(&Wire, PASCO2Mux::defaultAddr + 1U);
+
+    for(uint8_t i = 0; i < numSensors; i++)
+    {
+        xensiv_pasco2_sim_init(&sims[i], &Wire, XENSIV_PASCO2_SIM_I2C);
+        xensiv_pasco2_sim_set_mux_channel(&sims[i], PASCO2Mux::defaultAddr + (i / PASCO2Mux::portsPerMux), i % PASCO2Mux::portsPerMux);
+    }
+}
+
+static uint64_t busUs()
+{
+    uint64_t us = 0;
+
+    for(uint8_t i = 0; i < numSensors; i++)
+    {
+        xensiv_pasco2_sim_stats_t stats;
+
+        xensiv_pasco2_sim_get_stats(&sims[i], &stats);
+        us += stats.bus_us;
+    }
+
+    return us;
+}
+
+static Result_t run(bool staggered)
+{
+    static PASCO2Manager<numSensors> manager(&Wire);
+    static uint64_t window[windowMs];
+    PASCO2MuxSampleRing<32> ring;
+    MuxSample_t sample;
+    Result_t r = {};
+    uint32_t pendingSince[numSensors] = {};
+    bool pending[numSensors] = {};
+    uint64_t measSum = 0;
+    uint64_t pendingSum = 0;
+    uint64_t waitSum = 0;
+    uint32_t waits = 0;
+    uint32_t ticks = 0;
+
+    setup();
+
+    (void)manager.begin(periodSec, staggered);
+
+    uint32_t start = millis() + (uint32_t)periodSec * 1000U;
+    uint32_t end   = start + (uint32_t)periods * periodSec * 1000U;
+
+    memset(window, 0, sizeof(window));
+
+    while((int32_t)(end - millis()) > 0)
+    {
+        (void)manager.service(ring);
+
+        bool counted = ((int32_t)(millis() - start) >= 0);
+        uint8_t meas = 0;
+        uint8_t pend = 0;
+
+        while(ring.pop(sample))
+        {
+            r.samples += counted ? 1U : 0U;
+        }
+
+        for(uint8_t i = 0; i < numSensors; i++)
+        {
+            bool drdy = (0U != (xensiv_pasco2_sim_get_regs(&sims[i])[XENSIV_PASCO2_REG_MEAS_STS] & XENSIV_PASCO2_REG_MEAS_STS_DRDY_MSK));
+
+            meas += xensiv_pasco2_sim_is_measuring(&sims[i]) ? 1U : 0U;
+            pend += drdy ? 1U : 0U;
+
+            if(drdy && !pending[i])
+            {
+                pendingSince[i] = millis();
+            }
+            else if(!drdy && pending[i] && counted)
+            {
+                uint32_t wait = millis() - pendingSince[i];
+
+                waitSum += wait;
+                waits++;
+                r.waitMaxMs = (wait > r.waitMaxMs) ? wait : r.waitMaxMs;
+            }
+
+            pending[i] = drdy;
+        }
+
+        /* Bus time over the last windowMs milliseconds */
+        uint64_t now = busUs();
+        uint64_t inWindow = now - window[ticks % windowMs];
+        window[ticks % windowMs] = now;
+        ticks++;
+
+        if(counted)
+        {
+            r.measPeak    = (meas > r.measPeak) ? meas : r.measPeak;
+            r.pendingPeak = (pend > r.pendingPeak) ? pend : r.pendingPeak;
+            r.busPeakUs   = (inWindow > r.busPeakUs) ? (uint32_t)inWindow : r.busPeakUs;
+            measSum    += meas;
+            pendingSum += pend;
+        }
+
+        delay(1);
+    }
+
+    uint32_t countedMs = (uint32_t)periods * periodSec * 1000U;
+
+    r.measMean    = (double)measSum / countedMs;
+    r.pendingMean = (double)pendingSum / countedMs;
+    r.waitMeanMs  = (0U != waits) ? ((double)waitSum / waits) : 0.0;
+
+    (void)manager.end();
+
+    return r;
+}
+
+static void report(const char * mode, const Result_t & r)
+{
+    printf(csv ? "%s,%u,%u,%.2f,%u,%.2f,%.3f,%u,%.1f\n" : "%-9s %8u %9u %9.2f %12u %12.2f %12.3f %12u %13.1f\n",
+           mode, (unsigned)r.samples, (unsigned)r.measPeak, r.measMean, (unsigned)r.pendingPeak, r.pendingMean,
+           (double)r.busPeakUs / 1000.0, (unsigned)r.waitMaxMs, r.waitMeanMs);
+}
+
+int main(int argc, char ** argv)
+{
+    csv = (argc > 1) && (0 == strcmp(argv[1], "--csv"));
+
+    if(csv)
+    {
+        printf("starts,samples,meas_peak,meas_mean,pending_peak,pending_mean,bus_peak_ms,wait_max_ms,wait_mean_ms\n");
+    }
+    else
+    {
+        printf("%u sensors, %d s period, %u periods, bus time per %u ms window\n",
+               (unsigned)numSensors, (int)periodSec, (unsigned)periods, (unsigned)windowMs);
+        printf("%-9s %8s %9s %9s %12s %12s %12s %12s %13s\n",
+               "starts", "samples", "meas peak", "meas mean", "pending peak", "pending mean", "bus peak ms", "wait max ms", "wait mean ms");
+    }
+
+    report("aligned", run(false));
+    report("staggered", run(true));
+
+    return 0;
+}
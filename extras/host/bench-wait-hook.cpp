@@ -0,0 +1,205 @@
+/**
+ * @file        bench-wait-hook.cpp
+ * @brief       Cooperative wait hook of the XENSIV™ PAS CO2 Arduino API on the host simulator
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @details     Reference implementation of a wait hook on the simulated
+ *              clock: a cooperative scheduler that runs a background task
+ *              in time slices while the driver waits. For each PASCO2Ino
+ *              call on the I2C and UART transports, it reports the waits
+ *              passed to the hook, the waited time, the background task
+ *              runs and the waits on which the hook returned too early.
+ *              The calls are run with the blocking default, the
+ *              cooperative scheduler hook and xensiv_pasco2_plat_yield_wait().
+ *
+ *              Build and run from this directory:
+ *
+ *              @code
+ *              gcc -c -I../../src ../../src/xensiv_pasco2.c xensiv_pasco2_sim.c
+ *              g++ -std=c++11 -pthread -Iarduino -I../../src -I. bench-wait-hook.cpp arduino/arduino_shim.cpp \
+ *                  ../../src/pas-co2-ino.cpp ../../src/pas-co2-mutex-ino.cpp xensiv_pasco2.o xensiv_pasco2_sim.o -o bench-wait-hook
+ *              ./bench-wait-hook
+ *              @endcode
+ *
+ *              Pass --csv to print comma separated values.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <Arduino.h>
+#include <Wire.h>
+#include "pas-co2-ino.hpp"
+#include "xensiv_pasco2_sim.h"
+
+static constexpr uint32_t sliceUs   = 1000;    /**< Scheduler time slice */
+static constexpr uint32_t taskUs    = 250;     /**< Simulated run time of the background task */
+
+static bool csv = false;
+
+/**
+ * @brief   Cooperative scheduler state
+ */
+typedef struct
+{
+    uint32_t    waits;      /**< Waits passed to the hook */
+    uint32_t    yields;     /**< Zero time waits */
+    uint64_t    waitedUs;   /**< Time spent in the hook */
+    uint32_t    runs;       /**< Background task runs */
+} Scheduler_t;
+
+static Scheduler_t sched;
+
+static void backgroundTask()
+{
+    sched.runs++;
+    delayMicroseconds(taskUs);
+}
+
+/**
+ * @brief   Cooperative scheduler wait hook
+ *
+ * @details Runs the background task once per time slice until the deadline,
+ *          and sleeps the rest of each slice. A yield request runs the task
+ *          once.
+ */
+static void schedulerWait(void * arg, uint32_t ms)
+{
+    Scheduler_t * s = (Scheduler_t *)arg;
+    uint64_t start  = xensiv_pasco2_sim_time_us();
+    uint64_t end    = start + ((uint64_t)ms * 1000U);
+
+    s->waits++;
+
+    if(0U == ms)
+    {
+        s->yields++;
+        backgroundTask();
+    }
+
+    while(xensiv_pasco2_sim_time_us() < end)
+    {
+        uint64_t slice = xensiv_pasco2_sim_time_us() + sliceUs;
+
+        backgroundTask();
+
+        uint64_t now = xensiv_pasco2_sim_time_us();
+        uint64_t wake = (slice < end) ? slice : end;
+
+        if(now < wake)
+        {
+            delayMicroseconds((unsigned int)(wake - now));
+        }
+    }
+
+    s->waitedUs += xensiv_pasco2_sim_time_us() - start;
+}
+
+/**
+ * @brief   Counting wrapper of xensiv_pasco2_plat_yield_wait()
+ */
+static void yieldWait(void * arg, uint32_t ms)
+{
+    Scheduler_t * s = (Scheduler_t *)arg;
+    uint64_t start  = xensiv_pasco2_sim_time_us();
+
+    s->waits++;
+    s->yields += (0U == ms) ? 1U : 0U;
+
+    xensiv_pasco2_plat_yield_wait(nullptr, ms);
+
+    s->waitedUs += xensiv_pasco2_sim_time_us() - start;
+}
+
+static void header()
+{
+    if(csv)
+    {
+        printf("transport,hook,call,result,waits,waited_ms,task_runs,early,wall_ms\n");
+    }
+    else
+    {
+        printf("%-5s %-9s %-28s %4s %6s %10s %9s %6s %10s\n",
+               "bus", "hook", "call", "res", "waits", "waited ms", "task runs", "early", "wall ms");
+    }
+}
+
+template<typename F>
+static void measure(const char * transport, const char * hook, const char * call, F f)
+{
+    memset(&sched, 0, sizeof(sched));
+    xensiv_pasco2_sim_reset_delay();
+    uint64_t t0 = xensiv_pasco2_sim_time_us();
+
+    Error_t ret = f();
+
+    uint64_t wallUs = xensiv_pasco2_sim_time_us() - t0;
+
+    printf(csv ? "%s,%s,%s,%d,%u,%.3f,%u,%u,%.3f\n" : "%-5s %-9s %-28s %4d %6u %10.3f %9u %6u %10.3f\n",
+           transport, hook, call, (int)ret, (unsigned)sched.waits, (double)sched.waitedUs / 1000.0,
+           (unsigned)sched.runs, (unsigned)xensiv_pasco2_sim_get_wait_early(), (double)wallUs / 1000.0);
+}
+
+static void bench(const char * transport, const char * hook, PASCO2Ino & cotwo)
+{
+    int16_t co2;
+    FCSProgress_t progress;
+
+    measure(transport, hook, "begin()", [&]() { return cotwo.begin(); });
+    measure(transport, hook, "startMeasure(5)", [&]() { return cotwo.startMeasure(5); });
+    delay(5100);
+    measure(transport, hook, "getCO2()", [&]() { return cotwo.getCO2(co2); });
+    measure(transport, hook, "stopMeasure()", [&]() { return cotwo.stopMeasure(); });
+    measure(transport, hook, "performForcedCompensation()", [&]() { return cotwo.performForcedCompensation(420); });
+    measure(transport, hook, "startForcedCompensation()", [&]() { return cotwo.startForcedCompensation(420); });
+    measure(transport, hook, "pollForcedCompensation()", [&]()
+    {
+        Error_t ret;
+        while(XENSIV_PASCO2_BUSY == (ret = cotwo.pollForcedCompensation(progress)))
+        {
+            delay(100);
+        }
+        return ret;
+    });
+}
+
+int main(int argc, char ** argv)
+{
+    static const struct
+    {
+        const char * name;
+        WaitHook_t   hook;
+    } hooks[] =
+    {
+        { "delay",     nullptr        },
+        { "scheduler", schedulerWait  },
+        { "yield",     yieldWait      },
+    };
+
+    csv = (argc > 1) && (0 == strcmp(argv[1], "--csv"));
+
+    header();
+
+    for(const auto & h : hooks)
+    {
+        xensiv_pasco2_sim_t simI2C;
+        xensiv_pasco2_sim_t simUART;
+
+        xensiv_pasco2_sim_reset_all();
+        xensiv_pasco2_sim_init(&simI2C, &Wire, XENSIV_PASCO2_SIM_I2C);
+        xensiv_pasco2_sim_init(&simUART, &Serial1, XENSIV_PASCO2_SIM_UART);
+
+        PASCO2Ino cotwoI2C(&Wire);
+        PASCO2Ino cotwoUART(&Serial1);
+
+        PASCO2Ino::setWaitHook(h.hook, &sched);
+
+        bench("i2c", h.name, cotwoI2C);
+        bench("uart", h.name, cotwoUART);
+    }
+
+    PASCO2Ino::setWaitHook(nullptr);
+
+    return 0;
+}
@@ -0,0 +1,195 @@
+/**
+ * @file        log-file-store.cpp
+ * @brief       File-backed page storage of the XENSIV™ PAS CO2 persistent log for host builds
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "log-file-store.hpp"
+
+/**
+ * @brief   Takes one byte of the power cut budget
+ * @return  False if the power is cut before the byte
+ */
+static bool spend(LogFileStore_t * fs)
+{
+    if(0 == fs->budget)
+    {
+        fs->off = true;
+    }
+    else if(fs->budget > 0)
+    {
+        fs->budget--;
+    }
+
+    return !fs->off;
+}
+
+static int32_t fileRead(void * arg, uint32_t addr, uint8_t * buf, uint16_t len)
+{
+    LogFileStore_t * fs = (LogFileStore_t *)arg;
+
+    if(fs->off || ((addr + len) > ((uint32_t)fs->pageSize * fs->pages)) ||
+       (pread(fs->fd, buf, len, addr) != (ssize_t)len))
+    {
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    fs->read += len;
+
+    return XENSIV_PASCO2_OK;
+}
+
+static int32_t fileWrite(void * arg, uint32_t addr, const uint8_t * buf, uint16_t len)
+{
+    LogFileStore_t * fs = (LogFileStore_t *)arg;
+    uint8_t old[256];
+
+    if(fs->off || ((addr + len) > ((uint32_t)fs->pageSize * fs->pages)) || (len > sizeof(old)) ||
+       (pread(fs->fd, old, len, addr) != (ssize_t)len))
+    {
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    /* Programming only clears bits, byte by byte until a power cut */
+    uint16_t done = 0;
+    while((done < len) && spend(fs))
+    {
+        old[done] &= buf[done];
+        done++;
+    }
+
+    fs->programmed += done;
+
+    if((done > 0U) && (pwrite(fs->fd, old, done, addr) != (ssize_t)done))
+    {
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    return (done == len) ? XENSIV_PASCO2_OK : XENSIV_PASCO2_ERR_COMM;
+}
+
+static int32_t fileErase(void * arg, uint16_t page)
+{
+    LogFileStore_t * fs = (LogFileStore_t *)arg;
+    uint8_t ones[4096];
+
+    if(fs->off || (page >= fs->pages) || (fs->pageSize > sizeof(ones)))
+    {
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    /* An erase cut short leaves the start of the page erased */
+    uint16_t done = 0;
+    while((done < fs->pageSize) && spend(fs))
+    {
+        done++;
+    }
+
+    memset(ones, 0xFF, done);
+    fs->erased += done;
+    fs->erases[page]++;
+
+    if((done > 0U) && (pwrite(fs->fd, ones, done, (off_t)page * fs->pageSize) != (ssize_t)done))
+    {
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    return (done == fs->pageSize) ? XENSIV_PASCO2_OK : XENSIV_PASCO2_ERR_COMM;
+}
+
+/**
+ * @brief       Opens a storage file
+ *
+ * @details     A file of another size is replaced by an erased one. The
+ *              counters are cleared and the power is on.
+ *
+ * @param[out]  fs          File storage
+ * @param[out]  store       Page storage for PASCO2Log, bound to fs
+ * @param[in]   path        File path
+ * @param[in]   pageSize    Page size in bytes, up to 4096
+ * @param[in]   pages       Number of pages
+ * @return      False if the file cannot be opened
+ */
+bool logFileStoreOpen(LogFileStore_t * fs, LogStore_t * store, const char * path, uint16_t pageSize, uint16_t pages)
+{
+    struct stat st;
+    off_t size = (off_t)pageSize * pages;
+
+    fs->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if(fs->fd < 0)
+    {
+        return false;
+    }
+
+    fs->pageSize   = pageSize;
+    fs->pages      = pages;
+    fs->read       = 0;
+    fs->programmed = 0;
+    fs->erased     = 0;
+    fs->budget     = -1;
+    fs->off        = false;
+    fs->erases.assign(pages, 0U);
+
+    if((0 != fstat(fs->fd, &st)) || (st.st_size != size))
+    {
+        uint8_t ones[4096];
+
+        memset(ones, 0xFF, sizeof(ones));
+
+        if(0 != ftruncate(fs->fd, 0))
+        {
+            return false;
+        }
+
+        for(uint16_t p = 0; p < pages; p++)
+        {
+            if(pwrite(fs->fd, ones, pageSize, (off_t)p * pageSize) != (ssize_t)pageSize)
+            {
+                return false;
+            }
+        }
+    }
+
+    store->read     = fileRead;
+    store->write    = fileWrite;
+    store->erase    = fileErase;
+    store->arg      = fs;
+    store->pageSize = pageSize;
+    store->pages    = pages;
+
+    return true;
+}
+
+/**
+ * @brief       Closes a storage file
+ */
+void logFileStoreClose(LogFileStore_t * fs)
+{
+    (void)close(fs->fd);
+    fs->fd = -1;
+}
+
+/**
+ * @brief       Schedules a power cut
+ *
+ * @param[in]   bytes   Bytes programmed or erased before the cut
+ */
+void logFileStoreCutAfter(LogFileStore_t * fs, int64_t bytes)
+{
+    fs->budget = bytes;
+}
+
+/**
+ * @brief       Restores the power, without any power cut scheduled
+ */
+void logFileStoreRestore(LogFileStore_t * fs)
+{
+    fs->budget = -1;
+    fs->off    = false;
+}
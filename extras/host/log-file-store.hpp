@@ -0,0 +1,56 @@
+/**
+ * @file        log-file-store.hpp
+ * @brief       File-backed page storage of the XENSIV™ PAS CO2 persistent log for host builds
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @details     Emulates a NOR flash in a file: an erase sets a page to 0xFF,
+ *              and a write can only clear bits, i.e. it ANDs the data into
+ *              the bytes. The file is kept, so that the log can be recovered
+ *              by another run.
+ *
+ *              The bytes read, programmed and erased, and the erases of each
+ *              page are counted. A power cut can be scheduled after a given
+ *              number of bytes programmed or erased: the operation in
+ *              progress is left partly done, and all the operations fail
+ *              until the power is restored.
+ *
+ *              @code
+ *              LogFileStore_t fs;
+ *              LogStore_t store;
+ *
+ *              logFileStoreOpen(&fs, &store, "log.bin", 256, 16);
+ *              PASCO2Log log(&store);
+ *              @endcode
+ */
+
+#ifndef LOG_FILE_STORE_HPP_
+#define LOG_FILE_STORE_HPP_
+
+#include <stdint.h>
+#include <vector>
+#include "pas-co2-log-ino.hpp"
+
+/**
+ * @brief   File-backed page storage
+ */
+typedef struct
+{
+    int                     fd;         /**< Storage file */
+    uint16_t                pageSize;   /**< Page size in bytes */
+    uint16_t                pages;      /**< Number of pages */
+    uint64_t                read;       /**< Bytes read */
+    uint64_t                programmed; /**< Bytes programmed */
+    uint64_t                erased;     /**< Bytes erased */
+    std::vector<uint32_t>   erases;     /**< Erases of each page */
+    int64_t                 budget;     /**< Bytes programmed or erased before the power cut, negative for none */
+    bool                    off;        /**< Power cut */
+} LogFileStore_t;
+
+bool logFileStoreOpen       (LogFileStore_t * fs, LogStore_t * store, const char * path, uint16_t pageSize, uint16_t pages);
+void logFileStoreClose      (LogFileStore_t * fs);
+void logFileStoreCutAfter   (LogFileStore_t * fs, int64_t bytes);
+void logFileStoreRestore    (LogFileStore_t * fs);
+
+#endif /** LOG_FILE_STORE_HPP_ **/
@@ -0,0 +1,318 @@
+/**
+ * @file        stress-lock.cpp
+ * @brief       Instance and bus mutex stress test of the XENSIV™ PAS CO2 Arduino API on the host simulator
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @details     Several std::threads call the public methods of an I2C and
+ *              a UART PASCO2Ino instance, each with a std::mutex instance
+ *              mutex and bus mutex. A further thread plays another driver
+ *              on the I2C bus, writing a TCA9548A multiplexer under the
+ *              same bus mutex. The mutexes are wrapped with counters, and
+ *              the test checks that:
+ *              - every call returns XENSIV_PASCO2_OK, or XENSIV_PASCO2_READ_NRDY
+ *                for getCO2(), or XENSIV_PASCO2_BUSY for the lock-free getStats()
+ *              - no two threads ever hold the same mutex
+ *              - every sensor transfer is made with the instance mutex held
+ *                by the calling thread
+ *              - the bus locks, the driver statistics and the simulated
+ *                transfers agree, i.e. no transaction was lost or torn
+ *
+ *              Build and run from this directory:
+ *
+ *              @code
+ *              gcc -c -I../../src ../../src/xensiv_pasco2.c xensiv_pasco2_sim.c
+ *              g++ -std=c++11 -pthread -Iarduino -I../../src -I. stress-lock.cpp arduino/arduino_shim.cpp \
+ *                  ../../src/pas-co2-ino.cpp ../../src/pas-co2-mutex-ino.cpp xensiv_pasco2.o xensiv_pasco2_sim.o -o stress-lock
+ *              ./stress-lock
+ *              @endcode
+ *
+ *              Exits with a non-zero status if any check fails.
+ */
+
+#include <stdio.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <Arduino.h>
+#include <Wire.h>
+#include "pas-co2-ino.hpp"
+#include "xensiv_pasco2_sim.h"
+
+static constexpr uint8_t  threadsPerInst = 4;       /**< Threads calling each sensor instance */
+static constexpr uint16_t callsPerThread = 2000;    /**< Calls of each sensor thread */
+static constexpr uint16_t muxWrites      = 2000;    /**< Transfers of the other driver on the I2C bus */
+static constexpr uint8_t  muxAddr        = 0x70;    /**< I2C address of the other driver device */
+static constexpr int16_t  periodSec      = 5;       /**< Continuous mode period */
+
+/**
+ * @brief   std::mutex with usage counters
+ */
+typedef struct
+{
+    std::mutex              mutex;      /**< Underlying mutex */
+    std::atomic<int>        holders;    /**< Threads currently holding the mutex */
+    std::atomic<uint32_t>   locks;      /**< Lock count */
+    std::atomic<uint32_t>   overlaps;   /**< Locks taken while another thread held the mutex */
+    std::atomic<uint32_t>   unguarded;  /**< Bus locks of sensor threads not holding their instance mutex */
+    std::atomic<uint32_t>   sensorLocks;/**< Bus locks of sensor threads */
+} Counted_t;
+
+static thread_local bool inInstance = false;  /**< Calling thread holds its instance mutex */
+static thread_local bool sensorThread = false;/**< Calling thread drives a sensor instance */
+
+static void countedLock(Counted_t * c)
+{
+    c->mutex.lock();
+
+    if(0 != c->holders.fetch_add(1))
+    {
+        c->overlaps++;
+    }
+
+    c->locks++;
+}
+
+static void countedUnlock(Counted_t * c)
+{
+    c->holders.fetch_sub(1);
+    c->mutex.unlock();
+}
+
+static void instLock(void * arg)
+{
+    countedLock((Counted_t *)arg);
+    inInstance = true;
+}
+
+static void instUnlock(void * arg)
+{
+    inInstance = false;
+    countedUnlock((Counted_t *)arg);
+}
+
+static void busLock(void * arg)
+{
+    Counted_t * c = (Counted_t *)arg;
+
+    countedLock(c);
+
+    if(sensorThread)
+    {
+        c->sensorLocks++;
+
+        if(!inInstance)
+        {
+            c->unguarded++;
+        }
+    }
+}
+
+static void busUnlock(void * arg)
+{
+    countedUnlock((Counted_t *)arg);
+}
+
+/**
+ * @brief   Sensor instance under test
+ */
+typedef struct
+{
+    const char        * name;           /**< Transport name */
+    PASCO2Ino         * cotwo;          /**< Instance */
+    xensiv_pasco2_sim_t sim;            /**< Simulated sensor */
+    Counted_t           inst;           /**< Instance mutex */
+    Counted_t           bus;            /**< Bus mutex */
+    Mutex_t             instMutex;      /**< Instance mutex wrapper */
+    Mutex_t             busMutex;       /**< Bus mutex wrapper */
+    std::atomic<uint32_t> ok;           /**< Calls returning XENSIV_PASCO2_OK */
+    std::atomic<uint32_t> notReady;     /**< getCO2() calls returning XENSIV_PASCO2_READ_NRDY */
+    std::atomic<uint32_t> statsBusy;    /**< getStats() calls returning XENSIV_PASCO2_BUSY during an update */
+    std::atomic<uint32_t> failed;       /**< Calls returning any other code */
+} Inst_t;
+
+static void sensorTask(Inst_t * in, uint8_t id)
+{
+    sensorThread = true;
+
+    for(uint16_t i = 0; i < callsPerThread; i++)
+    {
+        int16_t co2;
+        Diag_t diag;
+        Snapshot_t snap;
+        Stats_t stats;
+        uint8_t scratch = (uint8_t)(id + i);
+        Error_t ret;
+
+        switch((id + i) % 6U)
+        {
+            case 0:
+                ret = in->cotwo->getCO2(co2);
+                if(XENSIV_PASCO2_READ_NRDY == ret)
+                {
+                    in->notReady++;
+                    continue;
+                }
+                break;
+            case 1:
+                ret = in->cotwo->getDiagnosis(diag);
+                break;
+            case 2:
+                ret = in->cotwo->readSnapshot(snap);
+                break;
+            case 3:
+                ret = in->cotwo->setPressRef((uint16_t)(1000U + (i % 30U)));
+                break;
+            case 4:
+                ret = in->cotwo->setRegister(XENSIV_PASCO2_REG_SCRATCH_PAD, &scratch, 1);
+                break;
+            default:
+                ret = in->cotwo->getStats(stats);
+                if(XENSIV_PASCO2_BUSY == ret)
+                {
+                    in->statsBusy++;
+                    continue;
+                }
+                break;
+        }
+
+        if(XENSIV_PASCO2_OK == ret)
+        {
+            in->ok++;
+        }
+        else
+        {
+            in->failed++;
+        }
+
+        delay(1);
+    }
+}
+
+static void otherDriverTask()
+{
+    for(uint16_t i = 0; i < muxWrites; i++)
+    {
+        uint8_t channels = (uint8_t)i;
+
+        xensiv_pasco2_plat_bus_lock(&Wire);
+        (void)xensiv_pasco2_plat_i2c_transfer(&Wire, muxAddr, &channels, 1, nullptr, 0);
+        xensiv_pasco2_plat_bus_unlock(&Wire);
+
+        delay(1);
+    }
+}
+
+static bool check(bool cond, const char * what)
+{
+    printf("  %-52s %s\n", what, cond ? "ok" : "FAILED");
+
+    return cond;
+}
+
+static bool report(Inst_t & in, uint32_t otherLocks)
+{
+    Stats_t stats;
+    xensiv_pasco2_sim_stats_t simStats;
+    bool pass = true;
+
+    (void)in.cotwo->getStats(stats);
+    xensiv_pasco2_sim_get_stats(&in.sim, &simStats);
+
+    uint32_t xfers = stats.read_xfers + stats.write_xfers;
+
+    printf("%s: %u ok, %u not ready, %u stats busy, %u failed, %u instance locks, %u bus locks, %u transactions, %u sim transfers\n",
+           in.name, (unsigned)in.ok, (unsigned)in.notReady, (unsigned)in.statsBusy, (unsigned)in.failed, (unsigned)in.inst.locks,
+           (unsigned)in.bus.locks, (unsigned)xfers, (unsigned)simStats.transfers);
+
+    pass &= check(0U == in.failed, "calls return OK, READ_NRDY or BUSY");
+    pass &= check((in.ok + in.notReady + in.statsBusy) == ((uint32_t)threadsPerInst * callsPerThread), "all calls completed");
+    pass &= check(0U == in.inst.overlaps, "instance mutex exclusive");
+    pass &= check(0U == in.bus.overlaps, "bus mutex exclusive");
+    pass &= check(0U == in.bus.unguarded, "sensor transfers under the instance mutex");
+    pass &= check(in.bus.sensorLocks == xfers, "bus locks match the driver transactions");
+    pass &= check((in.bus.locks - in.bus.sensorLocks) == otherLocks, "bus locks match the other driver transfers");
+    pass &= check(0U == stats.comm_errors, "no communication errors");
+
+    if(&Wire == (void *)in.sim.ctx)
+    {
+        pass &= check(simStats.transfers == xfers, "driver transactions match the simulated transfers");
+    }
+
+    return pass;
+}
+
+static bool setup(Inst_t & in)
+{
+    in.instMutex = { instLock, instUnlock, &in.inst };
+    in.busMutex  = { busLock, busUnlock, &in.bus };
+
+    Error_t ret = in.cotwo->begin();
+    if(XENSIV_PASCO2_OK == ret) { ret = in.cotwo->startMeasure(periodSec); }
+    if(XENSIV_PASCO2_OK == ret) { ret = in.cotwo->setMutex(&in.instMutex); }
+    if(XENSIV_PASCO2_OK == ret) { ret = in.cotwo->setBusMutex(&in.busMutex); }
+    if(XENSIV_PASCO2_OK == ret) { ret = in.cotwo->resetStats(); }
+
+    xensiv_pasco2_sim_reset_stats(&in.sim);
+
+    if(XENSIV_PASCO2_OK != ret)
+    {
+        printf("%s: setup failed with %d\n", in.name, (int)ret);
+    }
+
+    return (XENSIV_PASCO2_OK == ret);
+}
+
+int main()
+{
+    static Inst_t i2c;
+    static Inst_t uart;
+    PASCO2Ino cotwoI2C(&Wire);
+    PASCO2Ino cotwoUART(&Serial1);
+
+    i2c.name   = "i2c";
+    i2c.cotwo  = &cotwoI2C;
+    uart.name  = "uart";
+    uart.cotwo = &cotwoUART;
+
+    xensiv_pasco2_sim_init(&i2c.sim, &Wire, XENSIV_PASCO2_SIM_I2C);
+    xensiv_pasco2_sim_init(&uart.sim, &Serial1, XENSIV_PASCO2_SIM_UART);
+    xensiv_pasco2_sim_add_mux(&Wire, muxAddr);
+
+    if(!setup(i2c) || !setup(uart))
+    {
+        return 1;
+    }
+
+    printf("%u threads per instance, %u calls per thread, %u other driver transfers\n",
+           (unsigned)threadsPerInst, (unsigned)callsPerThread, (unsigned)muxWrites);
+
+    std::vector<std::thread> threads;
+
+    for(uint8_t t = 0; t < threadsPerInst; t++)
+    {
+        threads.emplace_back(sensorTask, &i2c, t);
+        threads.emplace_back(sensorTask, &uart, t);
+    }
+
+    threads.emplace_back(otherDriverTask);
+
+    for(std::thread & t : threads)
+    {
+        t.join();
+    }
+
+    uint32_t muxCount;
+    (void)xensiv_pasco2_sim_get_mux(&Wire, muxAddr, &muxCount);
+
+    bool pass = true;
+    pass &= report(i2c, muxCount);
+    pass &= report(uart, 0U);
+    pass &= check(0U == xensiv_pasco2_sim_get_collisions(), "no address collisions");
+
+    printf("%s\n", pass ? "PASS" : "FAIL");
+
+    return pass ? 0 : 1;
+}
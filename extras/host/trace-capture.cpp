@@ -0,0 +1,128 @@
+/**
+ * @file        trace-capture.cpp
+ * @brief       Captures a XENSIV™ PAS CO2 bus transaction trace on the host simulator
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @details     Runs a PASCO2Ino session on the simulated sensor with the
+ *              tracing enabled and writes the recorded transactions to a file
+ *              in the format read by trace-replay. The session begins the
+ *              sensor, starts the continuous mode, polls getCO2() every
+ *              100 ms for a number of measurements, reads the diagnosis and
+ *              stops the measurement.
+ *
+ *              Build and run from this directory:
+ *
+ *              @code
+ *              gcc -c -I../../src ../../src/xensiv_pasco2.c xensiv_pasco2_sim.c
+ *              g++ -std=c++11 -pthread -Iarduino -I../../src -I. trace-capture.cpp arduino/arduino_shim.cpp \
+ *                  ../../src/pas-co2-ino.cpp ../../src/pas-co2-mutex-ino.cpp xensiv_pasco2.o xensiv_pasco2_sim.o -o trace-capture
+ *              ./trace-capture [--uart] [--meas N] trace.bin
+ *              @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <Arduino.h>
+#include <Wire.h>
+#include "pas-co2-ino.hpp"
+#include "xensiv_pasco2_sim.h"
+
+static constexpr uint16_t traceSize   = 1024;    /**< Trace capacity in records */
+static constexpr int16_t  periodSec   = 5;       /**< Continuous mode period */
+static constexpr uint16_t pollMs      = 100;     /**< getCO2() poll interval */
+
+static TraceRec_t traceBuf[traceSize];
+
+int main(int argc, char ** argv)
+{
+    const char * path = nullptr;
+    bool uart = false;
+    int meas = 10;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(0 == strcmp(argv[i], "--uart"))
+        {
+            uart = true;
+        }
+        else if((0 == strcmp(argv[i], "--meas")) && ((i + 1) < argc))
+        {
+            meas = atoi(argv[++i]);
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    if(nullptr == path)
+    {
+        fprintf(stderr, "usage: %s [--uart] [--meas N] trace.bin\n", argv[0]);
+        return 2;
+    }
+
+    xensiv_pasco2_sim_t sim;
+    xensiv_pasco2_sim_init(&sim, uart ? (void *)&Serial1 : (void *)&Wire, uart ? XENSIV_PASCO2_SIM_UART : XENSIV_PASCO2_SIM_I2C);
+
+    PASCO2Ino cotwoI2C(&Wire);
+    PASCO2Ino cotwoUART(&Serial1);
+    PASCO2Ino & cotwo = uart ? cotwoUART : cotwoI2C;
+    int16_t co2;
+    Diag_t diag;
+    Error_t ret;
+
+    cotwo.startTrace(traceBuf, traceSize);
+
+    ret = cotwo.begin();
+    if(XENSIV_PASCO2_OK != ret)
+    {
+        fprintf(stderr, "begin() failed: %d\n", (int)ret);
+        return 1;
+    }
+
+    (void)cotwo.startMeasure(periodSec);
+
+    for(int n = 0; n < meas; )
+    {
+        delay(pollMs);
+
+        ret = cotwo.getCO2(co2);
+        if(XENSIV_PASCO2_OK == ret)
+        {
+            n++;
+        }
+        else if(XENSIV_PASCO2_READ_NRDY != ret)
+        {
+            fprintf(stderr, "getCO2() failed: %d\n", (int)ret);
+        }
+    }
+
+    (void)cotwo.getDiagnosis(diag);
+    (void)cotwo.stopMeasure();
+    (void)cotwo.stopTrace();
+
+    FILE * f = fopen(path, "wb");
+    if(nullptr == f)
+    {
+        perror(path);
+        return 1;
+    }
+
+    TraceRec_t rec;
+    uint8_t bin[XENSIV_PASCO2_TRACE_REC_LEN];
+    uint16_t i = 0;
+
+    for(; XENSIV_PASCO2_OK == cotwo.readTrace(i, rec); i++)
+    {
+        xensiv_pasco2_trace_encode(&rec, bin);
+        fwrite(bin, 1, sizeof(bin), f);
+    }
+
+    fclose(f);
+    printf("%u transactions written to %s\n", (unsigned)i, path);
+
+    return 0;
+}
@@ -0,0 +1,276 @@
+/**
+ * @file        trace-replay.c
+ * @brief       Deterministic replay of a XENSIV™ PAS CO2 bus transaction trace
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * @details     Feeds a trace recorded with xensiv_pasco2_trace_start() back
+ *              through the register access path of the core library
+ *              (xensiv_pasco2_get_reg() and xensiv_pasco2_set_reg()). The
+ *              replay transport checks that every access matches the
+ *              recorded one, answers it with the recorded payload and result,
+ *              and takes the recorded bus time on a simulated clock.
+ *
+ *              By default the application time between the recorded
+ *              transactions is reproduced, so the replay shows the timing of
+ *              the original traffic under the library being built. With
+ *              --no-gaps the transactions are issued back to back and the
+ *              report shows the waits the library adds on its own.
+ *
+ *              The trace file is a sequence of records encoded with
+ *              xensiv_pasco2_trace_encode(), as dumped by the application or
+ *              written by trace-capture.
+ *
+ *              Build and run from this directory:
+ *
+ *              @code
+ *              gcc -I../../src trace-replay.c ../../src/xensiv_pasco2.c -o trace-replay
+ *              ./trace-replay [--no-gaps] [--verbose] trace.bin
+ *              @endcode
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "xensiv_pasco2.h"
+
+/** Replay state */
+typedef struct
+{
+    const xensiv_pasco2_trace_rec_t * expect;   /**< Recorded transaction expected next */
+    uint32_t mismatches;                        /**< Accesses differing from the recorded ones */
+} replay_t;
+
+static uint64_t replay_now_us = 0U;             /**< Simulated clock (us) */
+
+void xensiv_pasco2_plat_delay(uint32_t ms)
+{
+    replay_now_us += (uint64_t)ms * 1000U;
+}
+
+uint32_t xensiv_pasco2_plat_get_time_ms(void)
+{
+    return (uint32_t)(replay_now_us / 1000U);
+}
+
+uint32_t xensiv_pasco2_plat_get_time_us(void)
+{
+    return (uint32_t)replay_now_us;
+}
+
+static uint8_t replay_payload_len(const xensiv_pasco2_trace_rec_t * rec)
+{
+    return (rec->len > XENSIV_PASCO2_TRACE_DATA_LEN) ? XENSIV_PASCO2_TRACE_DATA_LEN : rec->len;
+}
+
+static int32_t replay_read(const xensiv_pasco2_t * dev, uint8_t reg_addr, uint8_t * data, uint8_t len)
+{
+    replay_t * replay = (replay_t *)dev->ctx;
+    const xensiv_pasco2_trace_rec_t * rec = replay->expect;
+
+    if ((NULL == rec) || (0U != (rec->flags & XENSIV_PASCO2_TRACE_WRITE)) || (rec->reg_addr != reg_addr) || (rec->len != len))
+    {
+        replay->mismatches++;
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    memset(data, 0, len);
+    memcpy(data, rec->data, replay_payload_len(rec));
+
+    replay->expect = NULL;
+    replay_now_us += rec->duration_us;
+
+    return rec->result;
+}
+
+static int32_t replay_write(const xensiv_pasco2_t * dev, uint8_t reg_addr, const uint8_t * data, uint8_t len)
+{
+    replay_t * replay = (replay_t *)dev->ctx;
+    const xensiv_pasco2_trace_rec_t * rec = replay->expect;
+
+    if ((NULL == rec) || (0U == (rec->flags & XENSIV_PASCO2_TRACE_WRITE)) || (rec->reg_addr != reg_addr) || (rec->len != len) ||
+        (0 != memcmp(data, rec->data, replay_payload_len(rec))))
+    {
+        replay->mismatches++;
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    replay->expect = NULL;
+    replay_now_us += rec->duration_us;
+
+    return rec->result;
+}
+
+static xensiv_pasco2_trace_rec_t * load(const char * path, size_t * count)
+{
+    FILE * f = fopen(path, "rb");
+    uint8_t bin[XENSIV_PASCO2_TRACE_REC_LEN];
+    xensiv_pasco2_trace_rec_t * recs = NULL;
+    size_t n = 0U;
+    size_t cap = 0U;
+
+    if (NULL == f)
+    {
+        perror(path);
+        return NULL;
+    }
+
+    while (sizeof(bin) == fread(bin, 1U, sizeof(bin), f))
+    {
+        if (n == cap)
+        {
+            cap = (0U == cap) ? 256U : (cap * 2U);
+            recs = (xensiv_pasco2_trace_rec_t *)realloc(recs, cap * sizeof(*recs));
+        }
+
+        xensiv_pasco2_trace_decode(bin, &recs[n++]);
+    }
+
+    if (!feof(f))
+    {
+        fprintf(stderr, "%s: trailing bytes ignored\n", path);
+    }
+
+    fclose(f);
+    *count = n;
+
+    return recs;
+}
+
+int main(int argc, char ** argv)
+{
+    const char * path = NULL;
+    int gaps = 1;
+    int verbose = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (0 == strcmp(argv[i], "--no-gaps"))
+        {
+            gaps = 0;
+        }
+        else if (0 == strcmp(argv[i], "--verbose"))
+        {
+            verbose = 1;
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    if (NULL == path)
+    {
+        fprintf(stderr, "usage: %s [--no-gaps] [--verbose] trace.bin\n", argv[0]);
+        return 2;
+    }
+
+    size_t count = 0U;
+    xensiv_pasco2_trace_rec_t * recs = load(path, &count);
+
+    if ((NULL == recs) || (0U == count))
+    {
+        fprintf(stderr, "%s: no records\n", path);
+        return 1;
+    }
+
+    replay_t replay = { NULL, 0U };
+    xensiv_pasco2_t dev;
+
+    memset(&dev, 0, sizeof(dev));
+    dev.ctx = &replay;
+    dev.read = replay_read;
+    dev.write = replay_write;
+
+    uint32_t diverged = 0U;
+    uint64_t wait_us = 0U;
+    uint64_t latency_max_us = 0U;
+    struct timespec cpu0;
+    struct timespec cpu1;
+    uint64_t cpu_ns = 0U;
+
+    if (verbose)
+    {
+        printf("%6s %5s %4s %3s %4s %10s %10s %8s %8s\n", "#", "op", "reg", "len", "res", "rec us", "replay us", "bus us", "wait us");
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const xensiv_pasco2_trace_rec_t * rec = &recs[i];
+        uint8_t data[XENSIV_PASCO2_SNAPSHOT_LEN + 1U];
+        int write = (0U != (rec->flags & XENSIV_PASCO2_TRACE_WRITE));
+
+        /* Application time between the end of the previous transaction and the start of this one */
+        if (gaps && (i > 0U))
+        {
+            const xensiv_pasco2_trace_rec_t * prev = &recs[i - 1U];
+            uint32_t gap = rec->timestamp_us - prev->timestamp_us - prev->duration_us;
+
+            if (gap < 0x80000000U)
+            {
+                replay_now_us += gap;
+            }
+        }
+
+        if (rec->len > sizeof(data))
+        {
+            fprintf(stderr, "record %zu: length %u not supported\n", i, rec->len);
+            diverged++;
+            continue;
+        }
+
+        memset(data, 0, sizeof(data));
+        memcpy(data, rec->data, replay_payload_len(rec));
+
+        replay.expect = rec;
+        uint64_t call_us = replay_now_us;
+
+        clock_gettime(CLOCK_MONOTONIC, &cpu0);
+        int32_t res = write ? xensiv_pasco2_set_reg(&dev, rec->reg_addr, data, rec->len)
+                            : xensiv_pasco2_get_reg(&dev, rec->reg_addr, data, rec->len);
+        clock_gettime(CLOCK_MONOTONIC, &cpu1);
+
+        cpu_ns += (uint64_t)((cpu1.tv_sec - cpu0.tv_sec) * 1000000000LL + (cpu1.tv_nsec - cpu0.tv_nsec));
+
+        uint64_t latency_us = replay_now_us - call_us;
+        uint64_t waited_us = latency_us - rec->duration_us;
+
+        if ((NULL != replay.expect) || (res != rec->result))
+        {
+            diverged++;
+        }
+
+        wait_us += waited_us;
+        if (latency_us > latency_max_us)
+        {
+            latency_max_us = latency_us;
+        }
+
+        if (verbose)
+        {
+            printf("%6zu %5s 0x%02x %3u %4d %10u %10llu %8u %8llu\n", i, write ? "write" : "read", rec->reg_addr, rec->len,
+                   (int)res, (unsigned)rec->timestamp_us, (unsigned long long)call_us, (unsigned)rec->duration_us,
+                   (unsigned long long)waited_us);
+        }
+    }
+
+    xensiv_pasco2_stats_t stats;
+    (void)xensiv_pasco2_get_stats(&dev, &stats);
+
+    uint32_t rec_span_us = recs[count - 1U].timestamp_us + recs[count - 1U].duration_us - recs[0].timestamp_us;
+
+    printf("transactions:        %zu (%u reads, %u writes)\n", count, (unsigned)stats.read_xfers, (unsigned)stats.write_xfers);
+    printf("diverged:            %u (%u access mismatches)\n", (unsigned)diverged, (unsigned)replay.mismatches);
+    printf("comm errors:         %u\n", (unsigned)stats.comm_errors);
+    printf("recorded span:       %.3f ms\n", (double)rec_span_us / 1000.0);
+    printf("replayed span:       %.3f ms\n", (double)replay_now_us / 1000.0);
+    printf("library waits:       %.3f ms (%u ms in delays)\n", (double)wait_us / 1000.0, (unsigned)stats.delay_ms_total);
+    printf("max access latency:  %.3f ms\n", (double)latency_max_us / 1000.0);
+    printf("host cpu per access: %.0f ns\n", (double)cpu_ns / (double)count);
+
+    free(recs);
+
+    return (0U == diverged) ? 0 : 1;
+}
@@ -0,0 +1,1227 @@
+/***********************************************************************************************//**
+ * \file xensiv_pasco2_sim.c
+ *
+ * Description: Host-side register-level simulator of the XENSIV™ PAS CO2 sensor.
+ *
+ ***************************************************************************************************
+ * \copyright
+ * Copyright 2021 Infineon Technologies AG
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **************************************************************************************************/
+
+#include <string.h>
+#include <pthread.h>
+
+#include "xensiv_pasco2_sim.h"
+
+#define XENSIV_PASCO2_SIM_NO_EVENT          (UINT64_MAX)
+
+#define XENSIV_PASCO2_SIM_PROD_ID           (0x42U)
+#define XENSIV_PASCO2_SIM_MEAS_CFG_MSK      (0x3FU)
+#define XENSIV_PASCO2_SIM_INT_CFG_MSK       (0x1FU)
+
+#define XENSIV_PASCO2_SIM_UART_ACK          (0x06U)
+#define XENSIV_PASCO2_SIM_UART_NAK          (0x15U)
+#define XENSIV_PASCO2_SIM_UART_READ_LEN     (4U)
+#define XENSIV_PASCO2_SIM_UART_WRITE_LEN    (7U)
+
+#define XENSIV_PASCO2_SIM_I2C_BITS_PER_BYTE (9U)
+#define XENSIV_PASCO2_SIM_UART_BITS_PER_BYTE (10U)
+
+/** Simulated I2C multiplexer */
+typedef struct
+{
+    const void * ctx;                                   /**< Interface context of the I2C bus. NULL if unused */
+    uint8_t addr;                                       /**< I2C address */
+    uint8_t channels;                                   /**< Control register: enabled channels */
+    uint32_t writes;                                    /**< Control register writes */
+} xensiv_pasco2_sim_mux_t;
+
+static xensiv_pasco2_sim_t * xensiv_pasco2_sim_devices[XENSIV_PASCO2_SIM_MAX_DEVICES];
+static xensiv_pasco2_sim_mux_t xensiv_pasco2_sim_muxes[XENSIV_PASCO2_SIM_MAX_MUXES];
+static uint32_t xensiv_pasco2_sim_collisions;
+static uint64_t xensiv_pasco2_sim_now_us;
+static uint64_t xensiv_pasco2_sim_delay_ms;
+static uint32_t xensiv_pasco2_sim_delay_calls;
+static xensiv_pasco2_sim_wait_t xensiv_pasco2_sim_wait_hook;
+static void * xensiv_pasco2_sim_wait_arg;
+static uint32_t xensiv_pasco2_sim_wait_early;
+static pthread_once_t xensiv_pasco2_sim_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t xensiv_pasco2_sim_mutex;
+
+static void xensiv_pasco2_sim_mutex_init(void)
+{
+    pthread_mutexattr_t attr;
+
+    (void)pthread_mutexattr_init(&attr);
+    /* The interrupt handlers run with the lock held and may call back into the simulator */
+    (void)pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    (void)pthread_mutex_init(&xensiv_pasco2_sim_mutex, &attr);
+    (void)pthread_mutexattr_destroy(&attr);
+}
+
+static void xensiv_pasco2_sim_lock(void)
+{
+    (void)pthread_once(&xensiv_pasco2_sim_once, xensiv_pasco2_sim_mutex_init);
+    (void)pthread_mutex_lock(&xensiv_pasco2_sim_mutex);
+}
+
+static void xensiv_pasco2_sim_unlock(void)
+{
+    (void)pthread_mutex_unlock(&xensiv_pasco2_sim_mutex);
+}
+
+static xensiv_pasco2_sim_mux_t * xensiv_pasco2_sim_find_mux(const void * ctx, uint16_t addr)
+{
+    for (uint8_t i = 0; i < XENSIV_PASCO2_SIM_MAX_MUXES; ++i)
+    {
+        xensiv_pasco2_sim_mux_t * mux = &xensiv_pasco2_sim_muxes[i];
+
+        if ((NULL != mux->ctx) && (ctx == mux->ctx) && (addr == mux->addr))
+        {
+            return mux;
+        }
+    }
+
+    return NULL;
+}
+
+static bool xensiv_pasco2_sim_reachable(const xensiv_pasco2_sim_t * sim)
+{
+    if (0U == sim->mux_addr)
+    {
+        return true;
+    }
+
+    const xensiv_pasco2_sim_mux_t * mux = xensiv_pasco2_sim_find_mux(sim->ctx, sim->mux_addr);
+
+    return (NULL != mux) && (0U != (mux->channels & (1U << sim->mux_channel)));
+}
+
+static xensiv_pasco2_sim_t * xensiv_pasco2_sim_find(const void * ctx, xensiv_pasco2_sim_transport_t transport, uint16_t addr)
+{
+    xensiv_pasco2_sim_t * found = NULL;
+
+    for (uint8_t i = 0; i < XENSIV_PASCO2_SIM_MAX_DEVICES; ++i)
+    {
+        xensiv_pasco2_sim_t * sim = xensiv_pasco2_sim_devices[i];
+
+        if ((NULL != sim) && (ctx == sim->ctx) && (transport == sim->transport) &&
+            ((XENSIV_PASCO2_SIM_UART == transport) || ((addr == sim->i2c_addr) && xensiv_pasco2_sim_reachable(sim))))
+        {
+            if (NULL != found)
+            {
+                /* Several devices drive the bus at once */
+                xensiv_pasco2_sim_collisions++;
+                return NULL;
+            }
+
+            found = sim;
+        }
+    }
+
+    return found;
+}
+
+static uint16_t xensiv_pasco2_sim_get16(const xensiv_pasco2_sim_t * sim, uint8_t reg)
+{
+    return (uint16_t)(((uint16_t)sim->regs[reg] << 8) | sim->regs[reg + 1U]);
+}
+
+static void xensiv_pasco2_sim_update_int(xensiv_pasco2_sim_t * sim)
+{
+    uint8_t int_cfg = sim->regs[XENSIV_PASCO2_REG_INT_CFG];
+    uint8_t int_func = (uint8_t)((int_cfg & XENSIV_PASCO2_REG_INT_CFG_INT_FUNC_MSK) >> XENSIV_PASCO2_REG_INT_CFG_INT_FUNC_POS);
+    bool active_high = (0U != (int_cfg & XENSIV_PASCO2_REG_INT_CFG_INT_TYP_MSK));
+    bool active;
+
+    switch (int_func)
+    {
+        case XENSIV_PASCO2_INTERRUPT_FUNCTION_ALARM:
+        case XENSIV_PASCO2_INTERRUPT_FUNCTION_DRDY:
+            active = (0U != (sim->regs[XENSIV_PASCO2_REG_MEAS_STS] & XENSIV_PASCO2_REG_MEAS_STS_INT_STS_MSK));
+            break;
+
+        case XENSIV_PASCO2_INTERRUPT_FUNCTION_BUSY:
+        case XENSIV_PASCO2_INTERRUPT_FUNCTION_EARLY:
+            active = sim->meas_busy;
+            break;
+
+        default:
+            active = false;
+            break;
+    }
+
+    bool level = (active == active_high);
+
+    if (level != sim->int_level)
+    {
+        sim->int_level = level;
+
+        if (NULL != sim->int_handler)
+        {
+            sim->int_handler(sim->int_arg, level);
+        }
+    }
+}
+
+static void xensiv_pasco2_sim_reset_regs(xensiv_pasco2_sim_t * sim)
+{
+    static const uint8_t reset_regs[XENSIV_PASCO2_SIM_REGS] =
+    {
+        XENSIV_PASCO2_SIM_PROD_ID,      /* PROD_ID */
+        XENSIV_PASCO2_REG_SENS_STS_SEN_RDY_MSK, /* SENS_STS */
+        0x00U, 0x3CU,                   /* MEAS_RATE: 60s */
+        0x24U,                          /* MEAS_CFG: PWM output enabled, ABOC, idle */
+        0x00U, 0x00U,                   /* CO2PPM */
+        0x00U,                          /* MEAS_STS */
+        0x11U,                          /* INT_CFG: active high, no function, low to high alarm */
+        0x00U, 0x00U,                   /* ALARM_TH */
+        0x03U, 0xF7U,                   /* PRESS_REF: 1015hPa */
+        0x01U, 0x90U,                   /* CALIB_REF: 400ppm */
+        0x00U,                          /* SCRATCH_PAD */
+        0x00U                           /* SENS_RST */
+    };
+
+    (void)memcpy(sim->regs, reset_regs, sizeof(reset_regs));
+
+    sim->meas_pending = false;
+    sim->meas_busy = false;
+    sim->comp_offset = sim->comp_offset_nvm;
+    sim->fcs_count = 0U;
+    sim->fcs_sum = 0;
+    sim->aboc_count = 0U;
+    sim->aboc_min = INT16_MAX;
+    sim->uart_line_len = 0U;
+    sim->uart_rx_head = 0U;
+    sim->uart_rx_tail = 0U;
+
+    xensiv_pasco2_sim_update_int(sim);
+}
+
+static int16_t xensiv_pasco2_sim_sample(xensiv_pasco2_sim_t * sim)
+{
+    uint16_t press_ref = xensiv_pasco2_sim_get16(sim, XENSIV_PASCO2_REG_PRESS_REF_H);
+    int32_t raw = (int32_t)sim->env_ppm;
+
+    if (0U != press_ref)
+    {
+        raw = (raw * (int32_t)sim->env_hpa) / (int32_t)press_ref;
+    }
+
+    raw += sim->sens_offset;
+
+    if (0U != sim->noise_ppm)
+    {
+        /* xorshift32 */
+        sim->rng ^= sim->rng << 13;
+        sim->rng ^= sim->rng >> 17;
+        sim->rng ^= sim->rng << 5;
+        raw += (int32_t)(sim->rng % (2U * sim->noise_ppm + 1U)) - (int32_t)sim->noise_ppm;
+    }
+
+    return (int16_t)((raw < 0) ? 0 : ((raw > INT16_MAX) ? INT16_MAX : raw));
+}
+
+static void xensiv_pasco2_sim_meas_complete(xensiv_pasco2_sim_t * sim)
+{
+    uint8_t meas_cfg = sim->regs[XENSIV_PASCO2_REG_MEAS_CFG];
+    uint8_t op_mode = (uint8_t)(meas_cfg & XENSIV_PASCO2_REG_MEAS_CFG_OP_MODE_MSK);
+    uint8_t boc_cfg = (uint8_t)((meas_cfg & XENSIV_PASCO2_REG_MEAS_CFG_BOC_CFG_MSK) >> XENSIV_PASCO2_REG_MEAS_CFG_BOC_CFG_POS);
+    int16_t calib_ref = (int16_t)xensiv_pasco2_sim_get16(sim, XENSIV_PASCO2_REG_CALIB_REF_H);
+    int16_t raw = xensiv_pasco2_sim_sample(sim);
+
+    /* Baseline offset compensation */
+    if ((XENSIV_PASCO2_BOC_CFG_FORCED == boc_cfg) && (XENSIV_PASCO2_OP_MODE_CONTINUOUS == op_mode))
+    {
+        sim->fcs_sum += raw;
+
+        if (++sim->fcs_count >= XENSIV_PASCO2_SIM_FCS_MEAS)
+        {
+            sim->comp_offset = (int16_t)((sim->fcs_sum / sim->fcs_count) - calib_ref);
+            sim->fcs_count = 0U;
+            sim->fcs_sum = 0;
+            sim->regs[XENSIV_PASCO2_REG_MEAS_CFG] &= (uint8_t)~XENSIV_PASCO2_REG_MEAS_CFG_BOC_CFG_MSK;
+        }
+    }
+    else if (XENSIV_PASCO2_BOC_CFG_AUTOMATIC == boc_cfg)
+    {
+        if (raw < sim->aboc_min)
+        {
+            sim->aboc_min = raw;
+        }
+
+        if (++sim->aboc_count >= sim->aboc_meas)
+        {
+            sim->comp_offset = (int16_t)(sim->aboc_min - calib_ref);
+            sim->aboc_count = 0U;
+            sim->aboc_min = INT16_MAX;
+        }
+    }
+
+    int32_t result = (int32_t)raw - sim->comp_offset;
+    result = (result < 0) ? 0 : ((result > INT16_MAX) ? INT16_MAX : result);
+
+    sim->regs[XENSIV_PASCO2_REG_CO2PPM_H] = (uint8_t)((uint16_t)result >> 8);
+    sim->regs[XENSIV_PASCO2_REG_CO2PPM_L] = (uint8_t)result;
+
+    /* Status and interrupt */
+    uint8_t int_cfg = sim->regs[XENSIV_PASCO2_REG_INT_CFG];
+    uint8_t int_func = (uint8_t)((int_cfg & XENSIV_PASCO2_REG_INT_CFG_INT_FUNC_MSK) >> XENSIV_PASCO2_REG_INT_CFG_INT_FUNC_POS);
+    int32_t alarm_th = (int32_t)xensiv_pasco2_sim_get16(sim, XENSIV_PASCO2_REG_ALARM_TH_H);
+    bool alarm = (0U != (int_cfg & XENSIV_PASCO2_REG_INT_CFG_ALARM_TYP_MSK)) ? (result > alarm_th) : (result < alarm_th);
+
+    sim->regs[XENSIV_PASCO2_REG_MEAS_STS] |= XENSIV_PASCO2_REG_MEAS_STS_DRDY_MSK;
+
+    if (alarm)
+    {
+        sim->regs[XENSIV_PASCO2_REG_MEAS_STS] |= XENSIV_PASCO2_REG_MEAS_STS_ALARM_MSK;
+    }
+
+    if ((XENSIV_PASCO2_INTERRUPT_FUNCTION_DRDY == int_func) || ((XENSIV_PASCO2_INTERRUPT_FUNCTION_ALARM == int_func) && alarm))
+    {
+        sim->regs[XENSIV_PASCO2_REG_MEAS_STS] |= XENSIV_PASCO2_REG_MEAS_STS_INT_STS_MSK;
+    }
+
+    /* Next sequence */
+    sim->meas_busy = false;
+
+    if (XENSIV_PASCO2_OP_MODE_CONTINUOUS == op_mode)
+    {
+        uint16_t rate = xensiv_pasco2_sim_get16(sim, XENSIV_PASCO2_REG_MEAS_RATE_H);
+        rate = (rate < XENSIV_PASCO2_MEAS_RATE_MIN) ? (uint16_t)XENSIV_PASCO2_MEAS_RATE_MIN : rate;
+
+        sim->meas_pending = true;
+        sim->meas_start_us += (uint64_t)rate * 1000000U;
+    }
+    else
+    {
+        sim->regs[XENSIV_PASCO2_REG_MEAS_CFG] &= (uint8_t)~XENSIV_PASCO2_REG_MEAS_CFG_OP_MODE_MSK;
+    }
+
+    xensiv_pasco2_sim_update_int(sim);
+}
+
+static uint64_t xensiv_pasco2_sim_next_event(const xensiv_pasco2_sim_t * sim)
+{
+    if (sim->meas_busy)
+    {
+        return sim->meas_end_us;
+    }
+
+    return sim->meas_pending ? sim->meas_start_us : XENSIV_PASCO2_SIM_NO_EVENT;
+}
+
+static void xensiv_pasco2_sim_process(xensiv_pasco2_sim_t * sim)
+{
+    if (sim->meas_busy)
+    {
+        xensiv_pasco2_sim_meas_complete(sim);
+    }
+    else if (sim->meas_pending)
+    {
+        sim->meas_pending = false;
+        sim->meas_busy = true;
+        sim->meas_end_us = sim->meas_start_us + ((uint64_t)XENSIV_PASCO2_SIM_MEAS_TIME_MS * 1000U);
+        xensiv_pasco2_sim_update_int(sim);
+    }
+}
+
+static void xensiv_pasco2_sim_advance_to(uint64_t t)
+{
+    /* Process the events of all the devices in time order */
+    for (;;)
+    {
+        xensiv_pasco2_sim_t * next = NULL;
+        uint64_t next_us = XENSIV_PASCO2_SIM_NO_EVENT;
+
+        for (uint8_t i = 0; i < XENSIV_PASCO2_SIM_MAX_DEVICES; ++i)
+        {
+            xensiv_pasco2_sim_t * sim = xensiv_pasco2_sim_devices[i];
+
+            if (NULL != sim)
+            {
+                uint64_t ev = xensiv_pasco2_sim_next_event(sim);
+
+                if ((ev <= t) && (ev < next_us))
+                {
+                    next = sim;
+                    next_us = ev;
+                }
+            }
+        }
+
+        if (NULL == next)
+        {
+            break;
+        }
+
+        if (next_us > xensiv_pasco2_sim_now_us)
+        {
+            xensiv_pasco2_sim_now_us = next_us;
+        }
+
+        xensiv_pasco2_sim_process(next);
+    }
+
+    if (t > xensiv_pasco2_sim_now_us)
+    {
+        xensiv_pasco2_sim_now_us = t;
+    }
+}
+
+static void xensiv_pasco2_sim_bus(xensiv_pasco2_sim_t * sim, size_t tx_bytes, size_t rx_bytes, uint32_t bits_per_byte)
+{
+    uint64_t us = (((uint64_t)(tx_bytes + rx_bytes) * bits_per_byte * 1000000U) + sim->bus_hz - 1U) / sim->bus_hz;
+
+    sim->stats.transfers++;
+    sim->stats.tx_bytes += (uint32_t)tx_bytes;
+    sim->stats.rx_bytes += (uint32_t)rx_bytes;
+    sim->stats.bus_us += us;
+
+    xensiv_pasco2_sim_advance_to(xensiv_pasco2_sim_now_us + us);
+}
+
+static bool xensiv_pasco2_sim_responds(xensiv_pasco2_sim_t * sim)
+{
+    if (xensiv_pasco2_sim_now_us < sim->boot_end_us)
+    {
+        return false;
+    }
+
+    if (sim->nack > 0U)
+    {
+        sim->nack--;
+        return false;
+    }
+
+    return true;
+}
+
+static void xensiv_pasco2_sim_cmd(xensiv_pasco2_sim_t * sim, uint8_t cmd)
+{
+    switch (cmd)
+    {
+        case XENSIV_PASCO2_CMD_SOFT_RESET:
+            xensiv_pasco2_sim_reset_regs(sim);
+            sim->boot_end_us = xensiv_pasco2_sim_now_us + ((uint64_t)sim->boot_ms * 1000U);
+            break;
+
+        case XENSIV_PASCO2_CMD_RESET_ABOC:
+            sim->aboc_count = 0U;
+            sim->aboc_min = INT16_MAX;
+            break;
+
+        case XENSIV_PASCO2_CMD_SAVE_FCS_CALIB_OFFSET:
+            sim->comp_offset_nvm = sim->comp_offset;
+            break;
+
+        case XENSIV_PASCO2_CMD_RESET_FCS:
+            sim->comp_offset = 0;
+            sim->comp_offset_nvm = 0;
+            break;
+
+        default:
+            sim->regs[XENSIV_PASCO2_REG_SENS_STS] |= XENSIV_PASCO2_REG_SENS_STS_ICCER_MSK;
+            break;
+    }
+}
+
+static void xensiv_pasco2_sim_write_reg(xensiv_pasco2_sim_t * sim, uint8_t reg, uint8_t val)
+{
+    switch (reg)
+    {
+        case XENSIV_PASCO2_REG_SENS_STS:
+            /* Each clear bit is three positions below its flag */
+            sim->regs[reg] &= (uint8_t)~((val & (XENSIV_PASCO2_REG_SENS_STS_ICCER_CLR_MSK | XENSIV_PASCO2_REG_SENS_STS_ORVS_CLR_MSK |
+                                                 XENSIV_PASCO2_REG_SENS_STS_ORTMP_CLR_MSK)) << 3);
+            break;
+
+        case XENSIV_PASCO2_REG_MEAS_CFG:
+        {
+            uint8_t old_mode = (uint8_t)(sim->regs[reg] & XENSIV_PASCO2_REG_MEAS_CFG_OP_MODE_MSK);
+            uint8_t new_mode = (uint8_t)(val & XENSIV_PASCO2_REG_MEAS_CFG_OP_MODE_MSK);
+            uint8_t boc_cfg = (uint8_t)((val & XENSIV_PASCO2_REG_MEAS_CFG_BOC_CFG_MSK) >> XENSIV_PASCO2_REG_MEAS_CFG_BOC_CFG_POS);
+
+            sim->regs[reg] = (uint8_t)(val & XENSIV_PASCO2_SIM_MEAS_CFG_MSK);
+
+            if (XENSIV_PASCO2_BOC_CFG_FORCED == boc_cfg)
+            {
+                sim->fcs_count = 0U;
+                sim->fcs_sum = 0;
+            }
+
+            if ((XENSIV_PASCO2_OP_MODE_SINGLE == new_mode) || ((XENSIV_PASCO2_OP_MODE_CONTINUOUS == new_mode) && (old_mode != new_mode)))
+            {
+                if (!sim->meas_busy)
+                {
+                    sim->meas_pending = true;
+                    sim->meas_start_us = xensiv_pasco2_sim_now_us;
+                }
+            }
+            else if (XENSIV_PASCO2_OP_MODE_CONTINUOUS != new_mode)
+            {
+                /* Idle aborts any measurement sequence */
+                sim->regs[reg] &= (uint8_t)~XENSIV_PASCO2_REG_MEAS_CFG_OP_MODE_MSK;
+                sim->meas_pending = false;
+                sim->meas_busy = false;
+                xensiv_pasco2_sim_update_int(sim);
+            }
+            break;
+        }
+
+        case XENSIV_PASCO2_REG_MEAS_STS:
+            if (0U != (val & XENSIV_PASCO2_REG_MEAS_STS_ALARM_CLR_MSK))
+            {
+                sim->regs[reg] &= (uint8_t)~XENSIV_PASCO2_REG_MEAS_STS_ALARM_MSK;
+            }
+
+            if (0U != (val & XENSIV_PASCO2_REG_MEAS_STS_INT_STS_CLR_MSK))
+            {
+                sim->regs[reg] &= (uint8_t)~XENSIV_PASCO2_REG_MEAS_STS_INT_STS_MSK;
+            }
+
+            xensiv_pasco2_sim_update_int(sim);
+            break;
+
+        case XENSIV_PASCO2_REG_INT_CFG:
+            sim->regs[reg] = (uint8_t)(val & XENSIV_PASCO2_SIM_INT_CFG_MSK);
+            xensiv_pasco2_sim_update_int(sim);
+            break;
+
+        case XENSIV_PASCO2_REG_SENS_RST:
+            xensiv_pasco2_sim_cmd(sim, val);
+            break;
+
+        case XENSIV_PASCO2_REG_PROD_ID:
+        case XENSIV_PASCO2_REG_CO2PPM_H:
+        case XENSIV_PASCO2_REG_CO2PPM_L:
+            /* Read only */
+            break;
+
+        default:
+            sim->regs[reg] = val;
+            break;
+    }
+}
+
+static uint8_t xensiv_pasco2_sim_read_reg(xensiv_pasco2_sim_t * sim, uint8_t reg)
+{
+    uint8_t val = sim->regs[reg];
+
+    if (XENSIV_PASCO2_REG_MEAS_STS == reg)
+    {
+        sim->regs[reg] &= (uint8_t)~XENSIV_PASCO2_REG_MEAS_STS_DRDY_MSK;
+    }
+
+    return val;
+}
+
+static void xensiv_pasco2_sim_uart_put(xensiv_pasco2_sim_t * sim, uint8_t byte)
+{
+    if ((sim->uart_rx_tail - sim->uart_rx_head) < XENSIV_PASCO2_SIM_UART_BUF_SIZE)
+    {
+        sim->uart_rx[sim->uart_rx_tail % XENSIV_PASCO2_SIM_UART_BUF_SIZE] = byte;
+        sim->uart_rx_tail++;
+    }
+}
+
+static int32_t xensiv_pasco2_sim_hex(const uint8_t * ascii, uint8_t * val)
+{
+    uint8_t v = 0U;
+
+    for (uint8_t i = 0; i < 2U; ++i)
+    {
+        uint8_t c = ascii[i];
+
+        if ((c >= (uint8_t)'0') && (c <= (uint8_t)'9'))
+        {
+            c = (uint8_t)(c - (uint8_t)'0');
+        }
+        else if ((c >= (uint8_t)'A') && (c <= (uint8_t)'F'))
+        {
+            c = (uint8_t)(c - (uint8_t)'A' + 10U);
+        }
+        else if ((c >= (uint8_t)'a') && (c <= (uint8_t)'f'))
+        {
+            c = (uint8_t)(c - (uint8_t)'a' + 10U);
+        }
+        else
+        {
+            return XENSIV_PASCO2_ICCERR;
+        }
+
+        v = (uint8_t)((v << 4) | c);
+    }
+
+    *val = v;
+
+    return XENSIV_PASCO2_OK;
+}
+
+static void xensiv_pasco2_sim_uart_frame(xensiv_pasco2_sim_t * sim)
+{
+    static const uint8_t hex_digits[] = "0123456789ABCDEF";
+    const uint8_t * line = sim->uart_line;
+    uint8_t reg = 0U;
+    uint8_t val = 0U;
+    int32_t res = XENSIV_PASCO2_ICCERR;
+
+    if ((line[1] == (uint8_t)',') && (XENSIV_PASCO2_OK == xensiv_pasco2_sim_hex(&line[2], &reg)) && (reg < XENSIV_PASCO2_SIM_REGS))
+    {
+        if (((line[0] == (uint8_t)'r') || (line[0] == (uint8_t)'R')) && (XENSIV_PASCO2_SIM_UART_READ_LEN == sim->uart_line_len))
+        {
+            val = xensiv_pasco2_sim_read_reg(sim, reg);
+            xensiv_pasco2_sim_uart_put(sim, hex_digits[val >> 4]);
+            xensiv_pasco2_sim_uart_put(sim, hex_digits[val & 0x0FU]);
+            xensiv_pasco2_sim_uart_put(sim, (uint8_t)'\n');
+            return;
+        }
+
+        if (((line[0] == (uint8_t)'w') || (line[0] == (uint8_t)'W')) && (XENSIV_PASCO2_SIM_UART_WRITE_LEN == sim->uart_line_len) &&
+            (line[4] == (uint8_t)','))
+        {
+            res = xensiv_pasco2_sim_hex(&line[5], &val);
+        }
+    }
+
+    if (XENSIV_PASCO2_OK == res)
+    {
+        xensiv_pasco2_sim_write_reg(sim, reg, val);
+
+        /* Acknowledged after the write, so a soft reset still answers */
+        xensiv_pasco2_sim_uart_put(sim, XENSIV_PASCO2_SIM_UART_ACK);
+        xensiv_pasco2_sim_uart_put(sim, (uint8_t)'\n');
+    }
+    else
+    {
+        sim->regs[XENSIV_PASCO2_REG_SENS_STS] |= XENSIV_PASCO2_REG_SENS_STS_ICCER_MSK;
+        xensiv_pasco2_sim_uart_put(sim, XENSIV_PASCO2_SIM_UART_NAK);
+        xensiv_pasco2_sim_uart_put(sim, (uint8_t)'\n');
+    }
+}
+
+int32_t xensiv_pasco2_sim_init(xensiv_pasco2_sim_t * sim, void * ctx, xensiv_pasco2_sim_transport_t transport)
+{
+    xensiv_pasco2_plat_assert(sim != NULL);
+
+    int32_t res = XENSIV_PASCO2_ERR_ILLEGAL_ARG;
+
+    xensiv_pasco2_sim_lock();
+
+    xensiv_pasco2_sim_deinit(sim);
+
+    for (uint8_t i = 0; i < XENSIV_PASCO2_SIM_MAX_DEVICES; ++i)
+    {
+        if (NULL == xensiv_pasco2_sim_devices[i])
+        {
+            (void)memset(sim, 0, sizeof(*sim));
+
+            sim->ctx = ctx;
+            sim->transport = transport;
+            sim->i2c_addr = XENSIV_PASCO2_I2C_ADDR;
+            sim->bus_hz = (XENSIV_PASCO2_SIM_I2C == transport) ? XENSIV_PASCO2_SIM_I2C_FREQ_HZ : XENSIV_PASCO2_SIM_UART_BAUD;
+            sim->boot_ms = XENSIV_PASCO2_SIM_BOOT_MS;
+            sim->env_ppm = XENSIV_PASCO2_SIM_DEFAULT_CO2_PPM;
+            sim->env_hpa = XENSIV_PASCO2_SIM_DEFAULT_PRESS_HPA;
+            sim->rng = 1U;
+            sim->aboc_meas = XENSIV_PASCO2_SIM_ABOC_MEAS;
+
+            /* Idle level of the reset INT_CFG (active high) */
+            sim->int_level = false;
+            xensiv_pasco2_sim_reset_regs(sim);
+
+            xensiv_pasco2_sim_devices[i] = sim;
+
+            res = XENSIV_PASCO2_OK;
+            break;
+        }
+    }
+
+    xensiv_pasco2_sim_unlock();
+
+    return res;
+}
+
+void xensiv_pasco2_sim_deinit(xensiv_pasco2_sim_t * sim)
+{
+    xensiv_pasco2_sim_lock();
+
+    for (uint8_t i = 0; i < XENSIV_PASCO2_SIM_MAX_DEVICES; ++i)
+    {
+        if (sim == xensiv_pasco2_sim_devices[i])
+        {
+            xensiv_pasco2_sim_devices[i] = NULL;
+        }
+    }
+
+    xensiv_pasco2_sim_unlock();
+}
+
+void xensiv_pasco2_sim_reset_all(void)
+{
+    xensiv_pasco2_sim_lock();
+
+    (void)memset(xensiv_pasco2_sim_devices, 0, sizeof(xensiv_pasco2_sim_devices));
+    (void)memset(xensiv_pasco2_sim_muxes, 0, sizeof(xensiv_pasco2_sim_muxes));
+    xensiv_pasco2_sim_collisions = 0U;
+    xensiv_pasco2_sim_now_us = 0U;
+    xensiv_pasco2_sim_reset_delay();
+    xensiv_pasco2_sim_set_wait(NULL, NULL);
+
+    xensiv_pasco2_sim_unlock();
+}
+
+void xensiv_pasco2_sim_set_i2c_addr(xensiv_pasco2_sim_t * sim, uint8_t addr)
+{
+    xensiv_pasco2_sim_lock();
+
+    sim->i2c_addr = addr;
+
+    xensiv_pasco2_sim_unlock();
+}
+
+int32_t xensiv_pasco2_sim_add_mux(void * ctx, uint8_t addr)
+{
+    xensiv_pasco2_plat_assert(ctx != NULL);
+
+    int32_t res = XENSIV_PASCO2_ERR_ILLEGAL_ARG;
+
+    xensiv_pasco2_sim_lock();
+
+    for (uint8_t i = 0; i < XENSIV_PASCO2_SIM_MAX_MUXES; ++i)
+    {
+        xensiv_pasco2_sim_mux_t * mux = &xensiv_pasco2_sim_muxes[i];
+
+        if (NULL == mux->ctx)
+        {
+            mux->ctx = ctx;
+            mux->addr = addr;
+            mux->channels = 0U;
+            mux->writes = 0U;
+
+            res = XENSIV_PASCO2_OK;
+            break;
+        }
+    }
+
+    xensiv_pasco2_sim_unlock();
+
+    return res;
+}
+
+void xensiv_pasco2_sim_set_mux_channel(xensiv_pasco2_sim_t * sim, uint8_t mux_addr, uint8_t channel)
+{
+    xensiv_pasco2_plat_assert(channel < XENSIV_PASCO2_SIM_MUX_CHANNELS);
+
+    xensiv_pasco2_sim_lock();
+
+    sim->mux_addr = mux_addr;
+    sim->mux_channel = channel;
+
+    xensiv_pasco2_sim_unlock();
+}
+
+uint8_t xensiv_pasco2_sim_get_mux(const void * ctx, uint8_t addr, uint32_t * writes)
+{
+    xensiv_pasco2_sim_lock();
+
+    const xensiv_pasco2_sim_mux_t * mux = xensiv_pasco2_sim_find_mux(ctx, addr);
+    uint8_t channels = (NULL != mux) ? mux->channels : 0U;
+
+    if (NULL != writes)
+    {
+        *writes = (NULL != mux) ? mux->writes : 0U;
+    }
+
+    xensiv_pasco2_sim_unlock();
+
+    return channels;
+}
+
+uint32_t xensiv_pasco2_sim_get_collisions(void)
+{
+    xensiv_pasco2_sim_lock();
+
+    uint32_t val = xensiv_pasco2_sim_collisions;
+
+    xensiv_pasco2_sim_unlock();
+
+    return val;
+}
+
+void xensiv_pasco2_sim_set_bus_speed(xensiv_pasco2_sim_t * sim, uint32_t hz)
+{
+    xensiv_pasco2_plat_assert(hz != 0U);
+
+    xensiv_pasco2_sim_lock();
+
+    sim->bus_hz = hz;
+
+    xensiv_pasco2_sim_unlock();
+}
+
+void xensiv_pasco2_sim_set_co2(xensiv_pasco2_sim_t * sim, uint16_t ppm)
+{
+    xensiv_pasco2_sim_lock();
+
+    sim->env_ppm = ppm;
+
+    xensiv_pasco2_sim_unlock();
+}
+
+void xensiv_pasco2_sim_set_pressure(xensiv_pasco2_sim_t * sim, uint16_t hpa)
+{
+    xensiv_pasco2_sim_lock();
+
+    sim->env_hpa = hpa;
+
+    xensiv_pasco2_sim_unlock();
+}
+
+void xensiv_pasco2_sim_set_error(xensiv_pasco2_sim_t * sim, int16_t offset, uint16_t noise, uint32_t seed)
+{
+    xensiv_pasco2_sim_lock();
+
+    sim->sens_offset = offset;
+    sim->noise_ppm = noise;
+    sim->rng = (0U != seed) ? seed : 1U;
+
+    xensiv_pasco2_sim_unlock();
+}
+
+void xensiv_pasco2_sim_set_timing(xensiv_pasco2_sim_t * sim, uint32_t boot_ms, uint16_t aboc_meas)
+{
+    xensiv_pasco2_sim_lock();
+
+    sim->boot_ms = boot_ms;
+    sim->aboc_meas = (0U != aboc_meas) ? aboc_meas : 1U;
+
+    xensiv_pasco2_sim_unlock();
+}
+
+void xensiv_pasco2_sim_inject_status(xensiv_pasco2_sim_t * sim, uint8_t mask)
+{
+    xensiv_pasco2_sim_lock();
+
+    sim->regs[XENSIV_PASCO2_REG_SENS_STS] |= (uint8_t)(mask & (XENSIV_PASCO2_REG_SENS_STS_ICCER_MSK | XENSIV_PASCO2_REG_SENS_STS_ORVS_MSK |
+                                                               XENSIV_PASCO2_REG_SENS_STS_ORTMP_MSK));
+
+    xensiv_pasco2_sim_unlock();
+}
+
+void xensiv_pasco2_sim_inject_nack(xensiv_pasco2_sim_t * sim, uint16_t count)
+{
+    xensiv_pasco2_sim_lock();
+
+    sim->nack = count;
+
+    xensiv_pasco2_sim_unlock();
+}
+
+void xensiv_pasco2_sim_set_int_handler(xensiv_pasco2_sim_t * sim, xensiv_pasco2_sim_int_handler_t handler, void * arg)
+{
+    xensiv_pasco2_sim_lock();
+
+    sim->int_handler = handler;
+    sim->int_arg = arg;
+
+    xensiv_pasco2_sim_unlock();
+}
+
+bool xensiv_pasco2_sim_get_int_pin(const xensiv_pasco2_sim_t * sim)
+{
+    xensiv_pasco2_sim_lock();
+
+    bool val = sim->int_level;
+
+    xensiv_pasco2_sim_unlock();
+
+    return val;
+}
+
+bool xensiv_pasco2_sim_is_measuring(const xensiv_pasco2_sim_t * sim)
+{
+    xensiv_pasco2_sim_lock();
+
+    bool val = sim->meas_busy;
+
+    xensiv_pasco2_sim_unlock();
+
+    return val;
+}
+
+const uint8_t * xensiv_pasco2_sim_get_regs(const xensiv_pasco2_sim_t * sim)
+{
+    return sim->regs;
+}
+
+void xensiv_pasco2_sim_get_stats(const xensiv_pasco2_sim_t * sim, xensiv_pasco2_sim_stats_t * stats)
+{
+    xensiv_pasco2_sim_lock();
+
+    *stats = sim->stats;
+
+    xensiv_pasco2_sim_unlock();
+}
+
+void xensiv_pasco2_sim_reset_stats(xensiv_pasco2_sim_t * sim)
+{
+    xensiv_pasco2_sim_lock();
+
+    (void)memset(&sim->stats, 0, sizeof(sim->stats));
+
+    xensiv_pasco2_sim_unlock();
+}
+
+size_t xensiv_pasco2_sim_uart_available(void * ctx)
+{
+    size_t count = 0U;
+
+    xensiv_pasco2_sim_lock();
+
+    xensiv_pasco2_sim_t * sim = xensiv_pasco2_sim_find(ctx, XENSIV_PASCO2_SIM_UART, 0U);
+
+    if (NULL != sim)
+    {
+        xensiv_pasco2_sim_advance_to(xensiv_pasco2_sim_now_us);
+        count = sim->uart_rx_tail - sim->uart_rx_head;
+    }
+
+    xensiv_pasco2_sim_unlock();
+
+    return count;
+}
+
+uint64_t xensiv_pasco2_sim_time_us(void)
+{
+    xensiv_pasco2_sim_lock();
+
+    uint64_t val = xensiv_pasco2_sim_now_us;
+
+    xensiv_pasco2_sim_unlock();
+
+    return val;
+}
+
+void xensiv_pasco2_sim_advance_us(uint64_t us)
+{
+    xensiv_pasco2_sim_lock();
+
+    xensiv_pasco2_sim_advance_to(xensiv_pasco2_sim_now_us + us);
+
+    xensiv_pasco2_sim_unlock();
+}
+
+uint64_t xensiv_pasco2_sim_get_delay_ms(uint32_t * calls)
+{
+    xensiv_pasco2_sim_lock();
+
+    uint64_t delay_ms = xensiv_pasco2_sim_delay_ms;
+
+    if (NULL != calls)
+    {
+        *calls = xensiv_pasco2_sim_delay_calls;
+    }
+
+    xensiv_pasco2_sim_unlock();
+
+    return delay_ms;
+}
+
+void xensiv_pasco2_sim_reset_delay(void)
+{
+    xensiv_pasco2_sim_lock();
+
+    xensiv_pasco2_sim_delay_ms = 0U;
+    xensiv_pasco2_sim_delay_calls = 0U;
+    xensiv_pasco2_sim_wait_early = 0U;
+
+    xensiv_pasco2_sim_unlock();
+}
+
+void xensiv_pasco2_sim_set_wait(xensiv_pasco2_sim_wait_t wait, void * arg)
+{
+    xensiv_pasco2_sim_lock();
+
+    xensiv_pasco2_sim_wait_hook = wait;
+    xensiv_pasco2_sim_wait_arg = arg;
+
+    xensiv_pasco2_sim_unlock();
+}
+
+void xensiv_pasco2_sim_wait(uint32_t ms)
+{
+    xensiv_pasco2_sim_lock();
+
+    uint64_t deadline = xensiv_pasco2_sim_now_us + ((uint64_t)ms * 1000U);
+    xensiv_pasco2_sim_wait_t hook = xensiv_pasco2_sim_wait_hook;
+    void * arg = xensiv_pasco2_sim_wait_arg;
+
+    xensiv_pasco2_sim_unlock();
+
+    /* The other threads keep running on the simulator while the hook waits */
+    if (NULL != hook)
+    {
+        hook(arg, ms);
+    }
+
+    xensiv_pasco2_sim_lock();
+
+    if ((NULL != hook) && (xensiv_pasco2_sim_now_us < deadline))
+    {
+        xensiv_pasco2_sim_wait_early++;
+    }
+
+    xensiv_pasco2_sim_advance_to((xensiv_pasco2_sim_now_us < deadline) ? deadline : xensiv_pasco2_sim_now_us);
+
+    xensiv_pasco2_sim_unlock();
+}
+
+uint32_t xensiv_pasco2_sim_get_wait_early(void)
+{
+    xensiv_pasco2_sim_lock();
+
+    uint32_t val = xensiv_pasco2_sim_wait_early;
+
+    xensiv_pasco2_sim_unlock();
+
+    return val;
+}
+
+/************************************ Platform hooks **************************************/
+
+static int32_t xensiv_pasco2_sim_mux_transfer(xensiv_pasco2_sim_mux_t * mux, const uint8_t * tx_buffer, size_t tx_len, uint8_t * rx_buffer, size_t rx_len)
+{
+    /* Single control register: the last byte written is latched */
+    if ((NULL == rx_buffer) && (tx_len > 0U))
+    {
+        mux->channels = tx_buffer[tx_len - 1U];
+        mux->writes++;
+    }
+
+    for (size_t i = 0; (NULL != rx_buffer) && (i < rx_len); ++i)
+    {
+        rx_buffer[i] = mux->channels;
+    }
+
+    xensiv_pasco2_sim_advance_to(xensiv_pasco2_sim_now_us +
+                                 ((uint64_t)(1U + tx_len + rx_len) * XENSIV_PASCO2_SIM_I2C_BITS_PER_BYTE * 1000000U) / XENSIV_PASCO2_SIM_I2C_FREQ_HZ);
+
+    return XENSIV_PASCO2_OK;
+}
+
+static int32_t xensiv_pasco2_sim_i2c_transfer(void * ctx, uint16_t dev_addr, const uint8_t * tx_buffer, size_t tx_len, uint8_t * rx_buffer, size_t rx_len)
+{
+    xensiv_pasco2_sim_mux_t * mux = xensiv_pasco2_sim_find_mux(ctx, dev_addr);
+
+    if (NULL != mux)
+    {
+        return xensiv_pasco2_sim_mux_transfer(mux, tx_buffer, tx_len, rx_buffer, rx_len);
+    }
+
+    xensiv_pasco2_sim_t * sim = xensiv_pasco2_sim_find(ctx, XENSIV_PASCO2_SIM_I2C, dev_addr);
+
+    if (NULL == sim)
+    {
+        /* Nobody acknowledges the address byte */
+        xensiv_pasco2_sim_advance_to(xensiv_pasco2_sim_now_us +
+                                     (XENSIV_PASCO2_SIM_I2C_BITS_PER_BYTE * 1000000U) / XENSIV_PASCO2_SIM_I2C_FREQ_HZ);
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    xensiv_pasco2_sim_advance_to(xensiv_pasco2_sim_now_us);
+
+    if (!xensiv_pasco2_sim_responds(sim) || (0U == tx_len) || (tx_buffer[0] >= XENSIV_PASCO2_SIM_REGS))
+    {
+        sim->stats.errors++;
+        xensiv_pasco2_sim_bus(sim, 1U, 0U, XENSIV_PASCO2_SIM_I2C_BITS_PER_BYTE);
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    int32_t res = XENSIV_PASCO2_OK;
+    uint8_t reg = tx_buffer[0];
+
+    if (NULL == rx_buffer)
+    {
+        for (size_t i = 1; i < tx_len; ++i)
+        {
+            /* A soft reset stops acknowledging the remaining bytes */
+            if ((reg >= XENSIV_PASCO2_SIM_REGS) || (xensiv_pasco2_sim_now_us < sim->boot_end_us))
+            {
+                res = XENSIV_PASCO2_ERR_COMM;
+                break;
+            }
+
+            xensiv_pasco2_sim_write_reg(sim, reg++, tx_buffer[i]);
+        }
+
+        xensiv_pasco2_sim_bus(sim, 1U + tx_len, 0U, XENSIV_PASCO2_SIM_I2C_BITS_PER_BYTE);
+    }
+    else
+    {
+        for (size_t i = 0; i < rx_len; ++i)
+        {
+            rx_buffer[i] = (reg < XENSIV_PASCO2_SIM_REGS) ? xensiv_pasco2_sim_read_reg(sim, reg) : 0xFFU;
+            reg++;
+        }
+
+        /* Write address and register, repeated start, read address and data */
+        xensiv_pasco2_sim_bus(sim, 2U + tx_len, rx_len, XENSIV_PASCO2_SIM_I2C_BITS_PER_BYTE);
+    }
+
+    if (XENSIV_PASCO2_OK != res)
+    {
+        sim->stats.errors++;
+    }
+
+    return res;
+}
+
+static int32_t xensiv_pasco2_sim_uart_write(void * ctx, const uint8_t * data, size_t len)
+{
+    xensiv_pasco2_sim_t * sim = xensiv_pasco2_sim_find(ctx, XENSIV_PASCO2_SIM_UART, 0U);
+
+    if (NULL == sim)
+    {
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    xensiv_pasco2_sim_advance_to(xensiv_pasco2_sim_now_us);
+
+    /* The frames sent while the sensor boots or fails are lost */
+    if (xensiv_pasco2_sim_responds(sim))
+    {
+        for (size_t i = 0; (i < len) && (xensiv_pasco2_sim_now_us >= sim->boot_end_us); ++i)
+        {
+            if ((uint8_t)'\n' == data[i])
+            {
+                xensiv_pasco2_sim_uart_frame(sim);
+                sim->uart_line_len = 0U;
+            }
+            else if (sim->uart_line_len < sizeof(sim->uart_line))
+            {
+                sim->uart_line[sim->uart_line_len++] = data[i];
+            }
+        }
+    }
+
+    xensiv_pasco2_sim_bus(sim, len, 0U, XENSIV_PASCO2_SIM_UART_BITS_PER_BYTE);
+
+    return XENSIV_PASCO2_OK;
+}
+
+/* A failed read waits for the receive timeout, out of the lock */
+static int32_t xensiv_pasco2_sim_uart_read(void * ctx, uint8_t * data, size_t len)
+{
+    xensiv_pasco2_sim_t * sim = xensiv_pasco2_sim_find(ctx, XENSIV_PASCO2_SIM_UART, 0U);
+
+    if (NULL == sim)
+    {
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    xensiv_pasco2_sim_advance_to(xensiv_pasco2_sim_now_us);
+
+    size_t count = 0U;
+
+    while ((count < len) && (sim->uart_rx_head != sim->uart_rx_tail))
+    {
+        data[count++] = sim->uart_rx[sim->uart_rx_head % XENSIV_PASCO2_SIM_UART_BUF_SIZE];
+        sim->uart_rx_head++;
+    }
+
+    xensiv_pasco2_sim_bus(sim, 0U, count, XENSIV_PASCO2_SIM_UART_BITS_PER_BYTE);
+
+    if (count < len)
+    {
+        sim->stats.errors++;
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    return XENSIV_PASCO2_OK;
+}
+
+int32_t xensiv_pasco2_plat_i2c_transfer(void * ctx, uint16_t dev_addr, const uint8_t * tx_buffer, size_t tx_len, uint8_t * rx_buffer, size_t rx_len)
+{
+    xensiv_pasco2_sim_lock();
+
+    int32_t res = xensiv_pasco2_sim_i2c_transfer(ctx, dev_addr, tx_buffer, tx_len, rx_buffer, rx_len);
+
+    xensiv_pasco2_sim_unlock();
+
+    return res;
+}
+
+int32_t xensiv_pasco2_plat_uart_write(void * ctx, uint8_t * data, size_t len)
+{
+    xensiv_pasco2_sim_lock();
+
+    int32_t res = xensiv_pasco2_sim_uart_write(ctx, data, len);
+
+    xensiv_pasco2_sim_unlock();
+
+    return res;
+}
+
+int32_t xensiv_pasco2_plat_uart_read(void * ctx, uint8_t * data, size_t len)
+{
+    xensiv_pasco2_sim_lock();
+
+    int32_t res = xensiv_pasco2_sim_uart_read(ctx, data, len);
+
+    xensiv_pasco2_sim_unlock();
+
+    if (XENSIV_PASCO2_OK != res)
+    {
+        xensiv_pasco2_sim_wait(XENSIV_PASCO2_SIM_UART_TIMEOUT_MS);
+    }
+
+    return res;
+}
+
+void xensiv_pasco2_plat_delay(uint32_t ms)
+{
+    xensiv_pasco2_sim_lock();
+
+    xensiv_pasco2_sim_delay_ms += ms;
+    xensiv_pasco2_sim_delay_calls++;
+
+    xensiv_pasco2_sim_unlock();
+
+    xensiv_pasco2_sim_wait(ms);
+}
+
+uint32_t xensiv_pasco2_plat_get_time_ms(void)
+{
+    xensiv_pasco2_sim_lock();
+
+    uint32_t val = (uint32_t)(xensiv_pasco2_sim_now_us / 1000U);
+
+    xensiv_pasco2_sim_unlock();
+
+    return val;
+}
+
+uint32_t xensiv_pasco2_plat_get_time_us(void)
+{
+    xensiv_pasco2_sim_lock();
+
+    uint32_t val = (uint32_t)xensiv_pasco2_sim_now_us;
+
+    xensiv_pasco2_sim_unlock();
+
+    return val;
+}
@@ -0,0 +1,449 @@
+/***********************************************************************************************//**
+ * \file xensiv_pasco2_sim.h
+ *
+ * Description: Host-side register-level simulator of the XENSIV™ PAS CO2 sensor.
+ *              It implements the platform hooks of the core library (I2C, UART,
+ *              delay and time) on a simulated clock, so that the driver can be
+ *              built and exercised on a Linux host without hardware.
+ *
+ ***************************************************************************************************
+ * \copyright
+ * Copyright 2021 Infineon Technologies AG
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **************************************************************************************************/
+
+#ifndef XENSIV_PASCO2_SIM_H_
+#define XENSIV_PASCO2_SIM_H_
+
+/**
+ * \addtogroup group_board_libs_sim XENSIV™ PAS CO2 host simulator
+ * \{
+ * Virtual sensor behind the weak platform hooks of xensiv_pasco2.c.
+ *
+ * Build the core library together with xensiv_pasco2_sim.c, and without any
+ * other platform layer:
+ *
+ * \code
+ * gcc -pthread -I../../src app.c ../../src/xensiv_pasco2.c xensiv_pasco2_sim.c
+ * \endcode
+ *
+ * Each simulated device is bound to the interface context passed to the core
+ * library init function (plus the I2C address for I2C devices), so several
+ * sensors can be simulated at once:
+ *
+ * \code
+ * static int bus;
+ * xensiv_pasco2_sim_t sim;
+ * xensiv_pasco2_t dev;
+ *
+ * xensiv_pasco2_sim_init(&sim, &bus, XENSIV_PASCO2_SIM_I2C);
+ * xensiv_pasco2_sim_set_co2(&sim, 800);
+ * xensiv_pasco2_init_i2c(&dev, &bus);
+ * \endcode
+ *
+ * Model summary:
+ * - All the 17 registers, with their reset values, read-only and clear-on-write bits.
+ * - Idle, single and continuous operating modes. A measurement sequence lasts
+ *   XENSIV_PASCO2_SIM_MEAS_TIME_MS. In continuous mode a sequence starts every MEAS_RATE seconds.
+ * - MEAS_STS.DRDY is set at the end of each sequence and cleared when MEAS_STS is read.
+ * - MEAS_STS.ALARM is set when a result is above (low to high INT_CFG.ALARM_TYP) or below
+ *   (high to low) ALARM_TH, and cleared by ALARM_CLR.
+ * - MEAS_STS.INT_STS is set on data ready or alarm (depending on INT_CFG.INT_FUNC),
+ *   and cleared by INT_STS_CLR. The INT pin follows INT_STS, or the measurement
+ *   sequence for the busy and early notification functions, with the INT_CFG.INT_TYP polarity.
+ * - Forced compensation: after XENSIV_PASCO2_SIM_FCS_MEAS continuous measurements, the offset to
+ *   CALIB_REF is computed and MEAS_CFG.BOC_CFG is cleared. SAVE_FCS_CALIB_OFFSET keeps it over
+ *   soft resets; RESET_FCS clears it.
+ * - Automatic baseline compensation: after every aboc_meas measurements, the offset is set so
+ *   that the lowest result of the window reads CALIB_REF. RESET_ABOC restarts the window.
+ * - Pressure compensation: results are scaled by the ratio of the environment pressure to PRESS_REF.
+ * - Soft reset: registers are restored and the sensor does not respond for boot_ms.
+ * - UART: the ASCII protocol ("w,AA,DD\n" answered with ACK/NAK, "r,AA\n" answered with "DD\n").
+ *   Malformed frames are answered with NAK and flag SENS_STS.ICCER.
+ * - Bus timing: I2C transfers take 9 clock cycles per byte including the address byte.
+ *   UART transfers take 10 bit times per byte.
+ * - I2C multiplexers: TCA9548A compatible 8-channel switches with a single control register.
+ *   A device placed behind a multiplexer channel is only reachable while the channel is enabled.
+ *   Devices at the same address reachable at once collide and the transfer fails.
+ *
+ * Threads: the device table, the buses and the clock are guarded by a single global lock,
+ * so the simulator API and the platform hooks can be called from several threads. Each
+ * transfer is atomic. The lock is released while the wait hook runs. Interrupt handlers
+ * run with the lock held; they may call back into the simulator but must not block.
+ * The simulated clock is shared: the waits of all the threads advance it.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "xensiv_pasco2.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/************************************** Macros *******************************************/
+
+/** Maximum number of simultaneously simulated devices */
+#define XENSIV_PASCO2_SIM_MAX_DEVICES       (16U)
+/** Maximum number of simulated I2C multiplexers */
+#define XENSIV_PASCO2_SIM_MAX_MUXES         (8U)
+/** Number of channels of a simulated I2C multiplexer */
+#define XENSIV_PASCO2_SIM_MUX_CHANNELS      (8U)
+/** Number of sensor registers */
+#define XENSIV_PASCO2_SIM_REGS              (XENSIV_PASCO2_REG_SENS_RST + 1U)
+/** Duration of a measurement sequence */
+#define XENSIV_PASCO2_SIM_MEAS_TIME_MS      (1150U)
+/** Default time the sensor does not respond after a soft reset */
+#define XENSIV_PASCO2_SIM_BOOT_MS           (1000U)
+/** Number of continuous measurements needed by the forced compensation */
+#define XENSIV_PASCO2_SIM_FCS_MEAS          (3U)
+/** Default number of measurements of the automatic baseline compensation window */
+#define XENSIV_PASCO2_SIM_ABOC_MEAS         (100U)
+/** Time consumed by a UART read that does not get all the requested bytes */
+#define XENSIV_PASCO2_SIM_UART_TIMEOUT_MS   (500U)
+/** Size of the UART receive and transmit buffers */
+#define XENSIV_PASCO2_SIM_UART_BUF_SIZE     (256U)
+/** Default I2C clock frequency */
+#define XENSIV_PASCO2_SIM_I2C_FREQ_HZ       (100000U)
+/** Default UART baud rate */
+#define XENSIV_PASCO2_SIM_UART_BAUD         (9600U)
+/** Environment CO2 concentration at init */
+#define XENSIV_PASCO2_SIM_DEFAULT_CO2_PPM   (420U)
+/** Environment pressure at init */
+#define XENSIV_PASCO2_SIM_DEFAULT_PRESS_HPA (1015U)
+
+/******************************** Type definitions ***************************************/
+
+/** Simulated device interface */
+typedef enum
+{
+    XENSIV_PASCO2_SIM_I2C = 0U,                         /**< I2C device at XENSIV_PASCO2_I2C_ADDR */
+    XENSIV_PASCO2_SIM_UART = 1U                         /**< UART device */
+} xensiv_pasco2_sim_transport_t;
+
+/** Bus usage counters of a simulated device */
+typedef struct
+{
+    uint32_t transfers;                                 /**< Platform transfer calls (I2C transfers, UART reads and writes) */
+    uint32_t tx_bytes;                                  /**< Bytes sent to the device, I2C address bytes included */
+    uint32_t rx_bytes;                                  /**< Bytes received from the device */
+    uint32_t errors;                                    /**< Transfers that failed */
+    uint64_t bus_us;                                    /**< Time spent on the wire */
+} xensiv_pasco2_sim_stats_t;
+
+/** INT pin level change handler */
+typedef void (*xensiv_pasco2_sim_int_handler_t)(void * arg, bool level);
+
+/** Wait hook. Must advance the simulated clock by at least ms before returning */
+typedef void (*xensiv_pasco2_sim_wait_t)(void * arg, uint32_t ms);
+
+/** Simulated device. All fields are private, use the API functions */
+typedef struct
+{
+    void * ctx;                                         /**< Interface context the device is bound to */
+    xensiv_pasco2_sim_transport_t transport;            /**< Interface type */
+    uint8_t i2c_addr;                                   /**< I2C address */
+    uint8_t mux_addr;                                   /**< I2C address of the multiplexer in front. 0 if none */
+    uint8_t mux_channel;                                /**< Multiplexer channel the device is placed on */
+    uint32_t bus_hz;                                    /**< I2C clock frequency or UART baud rate */
+
+    uint8_t regs[XENSIV_PASCO2_SIM_REGS];               /**< Register file */
+
+    uint64_t boot_end_us;                               /**< End of the soft reset boot */
+    uint32_t boot_ms;                                   /**< Soft reset boot duration */
+    bool meas_pending;                                  /**< A measurement sequence is scheduled */
+    bool meas_busy;                                     /**< A measurement sequence is running */
+    uint64_t meas_start_us;                             /**< Start of the next or current sequence */
+    uint64_t meas_end_us;                               /**< End of the current sequence */
+
+    uint16_t env_ppm;                                   /**< Environment CO2 concentration */
+    uint16_t env_hpa;                                   /**< Environment pressure */
+    int16_t sens_offset;                                /**< Uncompensated sensor offset error [ppm] */
+    uint16_t noise_ppm;                                 /**< Uniform noise amplitude [ppm] */
+    uint32_t rng;                                       /**< Noise generator state */
+
+    int16_t comp_offset;                                /**< Active offset compensation [ppm] */
+    int16_t comp_offset_nvm;                            /**< Offset compensation in non-volatile memory [ppm] */
+    uint8_t fcs_count;                                  /**< Forced compensation measurements taken */
+    int32_t fcs_sum;                                    /**< Forced compensation raw results sum */
+    uint16_t aboc_meas;                                 /**< Automatic compensation window length */
+    uint16_t aboc_count;                                /**< Automatic compensation window measurements taken */
+    int16_t aboc_min;                                   /**< Automatic compensation window lowest raw result */
+
+    uint16_t nack;                                      /**< Number of upcoming transfers to fail */
+    bool int_level;                                     /**< INT pin level */
+    xensiv_pasco2_sim_int_handler_t int_handler;        /**< INT pin change handler */
+    void * int_arg;                                     /**< INT pin change handler argument */
+
+    uint8_t uart_line[16];                              /**< UART frame being received */
+    uint8_t uart_line_len;                              /**< UART frame length */
+    uint8_t uart_rx[XENSIV_PASCO2_SIM_UART_BUF_SIZE];   /**< UART bytes to be read by the host */
+    size_t uart_rx_head;                                /**< UART read position */
+    size_t uart_rx_tail;                                /**< UART write position */
+
+    xensiv_pasco2_sim_stats_t stats;                    /**< Bus usage counters */
+} xensiv_pasco2_sim_t;
+
+/******************************* Function prototypes *************************************/
+
+/**
+ * @brief Initializes a simulated device in its power-on state and binds it to an interface context
+ *
+ * @param[out] sim Pointer to the simulated device
+ * @param[in] ctx Interface context the core library device is initialized with
+ * @param[in] transport Interface type
+ * @return XENSIV_PASCO2_OK if the device was registered; XENSIV_PASCO2_ERR_ILLEGAL_ARG if
+ * XENSIV_PASCO2_SIM_MAX_DEVICES devices are already registered
+ */
+int32_t xensiv_pasco2_sim_init(xensiv_pasco2_sim_t * sim, void * ctx, xensiv_pasco2_sim_transport_t transport);
+
+/**
+ * @brief Unbinds a simulated device from its interface context
+ *
+ * @param[in] sim Pointer to the simulated device
+ */
+void xensiv_pasco2_sim_deinit(xensiv_pasco2_sim_t * sim);
+
+/**
+ * @brief Unbinds all the simulated devices, removes the multiplexers and resets the simulated clock and delay counters
+ */
+void xensiv_pasco2_sim_reset_all(void);
+
+/**
+ * @brief Sets the I2C address of a simulated I2C device
+ *
+ * @param[in] sim Pointer to the simulated device
+ * @param[in] addr 7-bit I2C address
+ */
+void xensiv_pasco2_sim_set_i2c_addr(xensiv_pasco2_sim_t * sim, uint8_t addr);
+
+/**
+ * @brief Adds an I2C multiplexer on an interface context, with all the channels disabled
+ *
+ * @param[in] ctx Interface context of the I2C bus
+ * @param[in] addr 7-bit I2C address of the multiplexer
+ * @return XENSIV_PASCO2_OK if the multiplexer was added; XENSIV_PASCO2_ERR_ILLEGAL_ARG if
+ * XENSIV_PASCO2_SIM_MAX_MUXES multiplexers are already added
+ */
+int32_t xensiv_pasco2_sim_add_mux(void * ctx, uint8_t addr);
+
+/**
+ * @brief Places a simulated I2C device behind a multiplexer channel
+ *
+ * @param[in] sim Pointer to the simulated device
+ * @param[in] mux_addr 7-bit I2C address of the multiplexer, added with xensiv_pasco2_sim_add_mux().
+ * 0 connects the device directly to the bus
+ * @param[in] channel Multiplexer channel, 0 to XENSIV_PASCO2_SIM_MUX_CHANNELS - 1
+ */
+void xensiv_pasco2_sim_set_mux_channel(xensiv_pasco2_sim_t * sim, uint8_t mux_addr, uint8_t channel);
+
+/**
+ * @brief Gets the control register of a simulated I2C multiplexer
+ *
+ * @param[in] ctx Interface context of the I2C bus
+ * @param[in] addr 7-bit I2C address of the multiplexer
+ * @param[out] writes Number of control register writes. Can be NULL
+ * @return Enabled channels bit mask
+ */
+uint8_t xensiv_pasco2_sim_get_mux(const void * ctx, uint8_t addr, uint32_t * writes);
+
+/**
+ * @brief Gets the number of transfers failed because several devices at the same address were reachable
+ *
+ * @return Number of address collisions
+ */
+uint32_t xensiv_pasco2_sim_get_collisions(void);
+
+/**
+ * @brief Sets the I2C clock frequency or UART baud rate used for the bus timing
+ *
+ * @param[in] sim Pointer to the simulated device
+ * @param[in] hz I2C frequency or UART baud rate
+ */
+void xensiv_pasco2_sim_set_bus_speed(xensiv_pasco2_sim_t * sim, uint32_t hz);
+
+/**
+ * @brief Sets the environment CO2 concentration
+ *
+ * @param[in] sim Pointer to the simulated device
+ * @param[in] ppm CO2 concentration
+ */
+void xensiv_pasco2_sim_set_co2(xensiv_pasco2_sim_t * sim, uint16_t ppm);
+
+/**
+ * @brief Sets the environment pressure
+ *
+ * @param[in] sim Pointer to the simulated device
+ * @param[in] hpa Pressure
+ */
+void xensiv_pasco2_sim_set_pressure(xensiv_pasco2_sim_t * sim, uint16_t hpa);
+
+/**
+ * @brief Sets the sensor offset error and the result noise
+ *
+ * @param[in] sim Pointer to the simulated device
+ * @param[in] offset Offset error added to the results before compensation [ppm]
+ * @param[in] noise Uniform noise amplitude [ppm]
+ * @param[in] seed Noise generator seed
+ */
+void xensiv_pasco2_sim_set_error(xensiv_pasco2_sim_t * sim, int16_t offset, uint16_t noise, uint32_t seed);
+
+/**
+ * @brief Sets the soft reset boot duration and the automatic compensation window
+ *
+ * @param[in] sim Pointer to the simulated device
+ * @param[in] boot_ms Time the sensor does not respond after a soft reset
+ * @param[in] aboc_meas Measurements per automatic compensation window
+ */
+void xensiv_pasco2_sim_set_timing(xensiv_pasco2_sim_t * sim, uint32_t boot_ms, uint16_t aboc_meas);
+
+/**
+ * @brief Raises sensor status flags (SENS_STS.ORTMP, ORVS or ICCER)
+ *
+ * @param[in] sim Pointer to the simulated device
+ * @param[in] mask SENS_STS flags to set
+ */
+void xensiv_pasco2_sim_inject_status(xensiv_pasco2_sim_t * sim, uint8_t mask);
+
+/**
+ * @brief Makes the next transfers fail
+ *
+ * @param[in] sim Pointer to the simulated device
+ * @param[in] count Number of transfers to fail
+ */
+void xensiv_pasco2_sim_inject_nack(xensiv_pasco2_sim_t * sim, uint16_t count);
+
+/**
+ * @brief Registers the INT pin level change handler
+ * The handler is called from the simulated clock advance, at the simulated time of the change.
+ *
+ * @param[in] sim Pointer to the simulated device
+ * @param[in] handler Handler, NULL to remove it
+ * @param[in] arg Handler argument
+ */
+void xensiv_pasco2_sim_set_int_handler(xensiv_pasco2_sim_t * sim, xensiv_pasco2_sim_int_handler_t handler, void * arg);
+
+/**
+ * @brief Gets the INT pin level
+ *
+ * @param[in] sim Pointer to the simulated device
+ * @return INT pin level
+ */
+bool xensiv_pasco2_sim_get_int_pin(const xensiv_pasco2_sim_t * sim);
+
+/**
+ * @brief Gets whether a measurement sequence is running
+ *
+ * @param[in] sim Pointer to the simulated device
+ * @return True during a measurement sequence
+ */
+bool xensiv_pasco2_sim_is_measuring(const xensiv_pasco2_sim_t * sim);
+
+/**
+ * @brief Gets the register file, bypassing the bus.
+ * The registers are read without the simulator lock
+ *
+ * @param[in] sim Pointer to the simulated device
+ * @return Pointer to the XENSIV_PASCO2_SIM_REGS registers
+ */
+const uint8_t * xensiv_pasco2_sim_get_regs(const xensiv_pasco2_sim_t * sim);
+
+/**
+ * @brief Gets the bus usage counters
+ *
+ * @param[in] sim Pointer to the simulated device
+ * @param[out] stats Counters
+ */
+void xensiv_pasco2_sim_get_stats(const xensiv_pasco2_sim_t * sim, xensiv_pasco2_sim_stats_t * stats);
+
+/**
+ * @brief Resets the bus usage counters
+ *
+ * @param[in] sim Pointer to the simulated device
+ */
+void xensiv_pasco2_sim_reset_stats(xensiv_pasco2_sim_t * sim);
+
+/**
+ * @brief Gets the number of bytes ready to be read from a simulated UART device
+ *
+ * @param[in] ctx Interface context of the device
+ * @return Number of bytes available
+ */
+size_t xensiv_pasco2_sim_uart_available(void * ctx);
+
+/**
+ * @brief Gets the simulated time
+ *
+ * @return Simulated time since start [us]
+ */
+uint64_t xensiv_pasco2_sim_time_us(void);
+
+/**
+ * @brief Advances the simulated time.
+ * The measurement sequences and INT pin changes of all the devices are processed in time order.
+ *
+ * @param[in] us Time to advance [us]
+ */
+void xensiv_pasco2_sim_advance_us(uint64_t us);
+
+/**
+ * @brief Gets the simulated time spent in xensiv_pasco2_plat_delay()
+ *
+ * @param[out] calls Number of delay calls. Can be NULL
+ * @return Accumulated delay [ms]
+ */
+uint64_t xensiv_pasco2_sim_get_delay_ms(uint32_t * calls);
+
+/**
+ * @brief Resets the delay counters
+ */
+void xensiv_pasco2_sim_reset_delay(void);
+
+/**
+ * @brief Sets the hook of the platform waits.
+ * The waits of xensiv_pasco2_plat_delay() and of the UART receive timeout are passed to the hook
+ * instead of advancing the simulated clock directly, so that a cooperative scheduler can run
+ * other work on the simulated clock meanwhile
+ *
+ * @param[in] wait Wait hook. NULL to advance the simulated clock directly
+ * @param[in] arg User argument passed to the hook
+ */
+void xensiv_pasco2_sim_set_wait(xensiv_pasco2_sim_wait_t wait, void * arg);
+
+/**
+ * @brief Waits through the wait hook.
+ * If the hook returns before ms has elapsed, the simulated clock is advanced to the deadline and
+ * the wait is counted as early
+ *
+ * @param[in] ms Time to wait [ms]. 0 for a yield request
+ */
+void xensiv_pasco2_sim_wait(uint32_t ms);
+
+/**
+ * @brief Gets the number of waits on which the hook returned before the deadline
+ *
+ * @return Early waits since the last \ref xensiv_pasco2_sim_reset_delay
+ */
+uint32_t xensiv_pasco2_sim_get_wait_early(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+/** \} group_board_libs_sim */
+
+#endif /* XENSIV_PASCO2_SIM_H_ */
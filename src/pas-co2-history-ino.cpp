@@ -0,0 +1,630 @@
+/**
+ * @file        pas-co2-history-ino.cpp
+ * @brief       XENSIV™ PAS CO2 Arduino Compressed History
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <string.h>
+#include "pas-co2-history-ino.hpp"
+
+/**
+ * @brief   Unary run marking an escaped record
+ */
+#define HIST_ESCAPE_RUN         (12U)
+
+/**
+ * @brief   Escape flags
+ */
+#define HIST_FLAG_ABS           (0x4U)  /**< Absolute ppm instead of a delta */
+#define HIST_FLAG_DIAG          (0x2U)  /**< Sensor status change */
+#define HIST_FLAG_TIME          (0x1U)  /**< Timestamp correction */
+
+/**
+ * @brief   Largest timestamp correction in ms
+ */
+#define HIST_MAX_CORRECTION     (0x1FFFFFFFL)
+
+static uint32_t zigzag(int32_t v)
+{
+    return (v < 0) ? (((uint32_t)(-(v + 1)) << 1) | 1U) : ((uint32_t)v << 1);
+}
+
+static int32_t unzigzag(uint32_t v)
+{
+    return (0U != (v & 1U)) ? (-(int32_t)(v >> 1) - 1) : (int32_t)(v >> 1);
+}
+
+static uint8_t bitLength(uint32_t v)
+{
+    uint8_t len = 0;
+
+    while(0U != v)
+    {
+        len++;
+        v >>= 1;
+    }
+
+    return len;
+}
+
+/**
+ * @brief       Writes the n low bits of v, most significant first
+ * @note        The payload must be cleared beforehand
+ */
+static void putBits(uint8_t * p, uint16_t & pos, uint32_t v, uint8_t n)
+{
+    while(n > 0U)
+    {
+        uint8_t room = (uint8_t)(8U - (pos & 7U));
+        uint8_t take = (n < room) ? n : room;
+        uint8_t bits = (uint8_t)((v >> (n - take)) & ((1U << take) - 1U));
+
+        p[pos >> 3] |= (uint8_t)(bits << (room - take));
+        pos = (uint16_t)(pos + take);
+        n   = (uint8_t)(n - take);
+    }
+}
+
+/**
+ * @brief       Reads n bits, most significant first
+ */
+static uint32_t getBits(const uint8_t * p, uint16_t & pos, uint8_t n)
+{
+    uint32_t v = 0;
+
+    while(n > 0U)
+    {
+        uint8_t room = (uint8_t)(8U - (pos & 7U));
+        uint8_t take = (n < room) ? n : room;
+
+        v  = (v << take) | ((uint32_t)(p[pos >> 3] >> (room - take)) & ((1U << take) - 1U));
+        pos = (uint16_t)(pos + take);
+        n   = (uint8_t)(n - take);
+    }
+
+    return v;
+}
+
+/**
+ * @brief       Counts the leading one bits, up to max
+ * @details     The terminating zero bit is consumed if found before max.
+ */
+static uint8_t getRun(const uint8_t * p, uint16_t & pos, uint8_t max)
+{
+    uint8_t run = 0;
+
+    while(run < max)
+    {
+        if(0U == getBits(p, pos, 1U))
+        {
+            break;
+        }
+
+        run++;
+    }
+
+    return run;
+}
+
+static void putLE(uint8_t * p, uint32_t v, uint8_t len)
+{
+    for(uint8_t i = 0; i < len; i++)
+    {
+        p[i] = (uint8_t)(v >> (8U * i));
+    }
+}
+
+static uint32_t getLE(const uint8_t * p, uint8_t len)
+{
+    uint32_t v = 0;
+
+    for(uint8_t i = len; i > 0U; i--)
+    {
+        v = (v << 8) | p[i - 1U];
+    }
+
+    return v;
+}
+
+/**
+ * @brief       Block header layout: record count, then the keyframe
+ */
+#define HIST_HDR_COUNT          (0U)    /**< Records in the block, 2 bytes */
+#define HIST_HDR_TIME           (2U)    /**< Keyframe timestamp in ms, 4 bytes */
+#define HIST_HDR_PPM            (6U)    /**< Keyframe CO2 concentration, 2 bytes */
+#define HIST_HDR_DIAG           (8U)    /**< Keyframe sensor status, 1 byte */
+#define HIST_HDR_PERIOD         (9U)    /**< Predicted interval in ms, 4 bytes */
+
+/**
+ * @brief       Rice parameter of the next delta
+ */
+static uint8_t riceParam(uint32_t sum, uint16_t num)
+{
+    uint8_t k = 0;
+
+    while((k < 14U) && (((uint32_t)num << k) < sum))
+    {
+        k++;
+    }
+
+    return k;
+}
+
+/**
+ * @brief       Updates the Rice parameter statistics with a delta
+ */
+static void riceUpdate(uint32_t & sum, uint16_t & num, uint32_t zz)
+{
+    sum += (zz > 0xFFFFU) ? 0xFFFFU : zz;
+    num++;
+
+    if(num >= 16U)
+    {
+        sum >>= 1;
+        num  = (uint16_t)(num >> 1);
+    }
+}
+
+/**
+ * @brief       Compressed history constructor
+ *
+ * @param[in]   data        Block storage of numBlocks * blockLen bytes
+ * @param[in]   blockLen    Block size in bytes
+ * @param[in]   numBlocks   Number of blocks
+ * @param[in]   toleranceMs Maximum error of the decoded timestamps in ms
+ * @pre         None
+ */
+PASCO2HistoryBase::PASCO2HistoryBase(uint8_t * data, uint16_t blockLen, uint8_t numBlocks, uint16_t toleranceMs)
+: data(data), blockLen(blockLen), numBlocks(numBlocks), tolerance(toleranceMs)
+{
+    reset();
+}
+
+/**
+ * @brief       Clears the history
+ * @pre         None
+ */
+void PASCO2HistoryBase::reset()
+{
+    first   = 0;
+    used    = 0;
+    held    = 0;
+    dropped = 0;
+
+    memset(&enc, 0, sizeof(enc));
+}
+
+/**
+ * @brief       Adds a result
+ *
+ * @details     The result is coded against the previous one in the last
+ *              block, or starts a new block as its keyframe if it does not
+ *              fit. The oldest block is evicted if all are in use.
+ *
+ * @param[in]   co2PPM      CO2 concentration in ppm
+ * @param[in]   diag        Sensor status flags
+ * @param[in]   timestamp   Result time in ms
+ * @return      False if the oldest block has been evicted to make room
+ * @pre         None
+ */
+bool PASCO2HistoryBase::add(int16_t co2PPM, Diag_t diag, uint32_t timestamp)
+{
+    HistoryRec_t rec;
+    bool kept = true;
+
+    rec.timestamp = timestamp;
+    rec.co2PPM    = co2PPM;
+    rec.diag      = diag;
+
+    if(0U != used)
+    {
+        uint8_t * blk = blockAt((uint8_t)(used - 1U));
+        uint16_t  cnt = blockCount(blk);
+        uint32_t  end = (uint32_t)enc.pos + encode(blk, rec, false);
+
+        if((cnt < 0xFFFFU) && (end <= (8UL * (blockLen - headerSize))))
+        {
+            (void)encode(blk, rec, true);
+            putLE(&blk[HIST_HDR_COUNT], cnt + 1U, 2U);
+            held++;
+
+            return kept;
+        }
+    }
+
+    if(used == numBlocks)
+    {
+        uint16_t cnt = blockCount(blockAt(0));
+
+        held    -= cnt;
+        dropped += cnt;
+        first    = (uint8_t)((first + 1U) % numBlocks);
+        used--;
+        kept     = false;
+    }
+
+    /* New block, the result is its keyframe */
+    uint8_t * blk = blockAt(used);
+    used++;
+
+    memset(blk, 0, blockLen);
+    putLE(&blk[HIST_HDR_COUNT], 1U, 2U);
+    putLE(&blk[HIST_HDR_TIME], timestamp, 4U);
+    putLE(&blk[HIST_HDR_PPM], (uint16_t)co2PPM, 2U);
+    putLE(&blk[HIST_HDR_DIAG], diag.u, 1U);
+    putLE(&blk[HIST_HDR_PERIOD], (uint32_t)enc.period, 4U);
+
+    keyframe(blk, enc, rec);
+    held++;
+
+    return kept;
+}
+
+/**
+ * @brief       Adds a result timestamped with millis()
+ *
+ * @param[in]   co2PPM      CO2 concentration in ppm
+ * @param[in]   diag        Sensor status flags
+ * @return      False if the oldest block has been evicted to make room
+ * @pre         None
+ */
+bool PASCO2HistoryBase::add(int16_t co2PPM, Diag_t diag)
+{
+    return add(co2PPM, diag, (uint32_t)millis());
+}
+
+/**
+ * @brief       Adds an acquired sample
+ *
+ * @param[in]   sample  Sample from service()
+ * @return      False if the oldest block has been evicted to make room
+ * @pre         None
+ */
+bool PASCO2HistoryBase::add(const Sample_t & sample)
+{
+    Diag_t diag;
+
+    diag.u = sample.sensStatus;
+
+    return add(sample.co2PPM, diag, sample.timestamp);
+}
+
+/**
+ * @brief       Decodes a record
+ *
+ * @details     Decodes from the keyframe of its block. Use
+ *              PASCO2HistoryReader to read consecutive records.
+ *
+ * @param[in]   index   Record index, 0 being the oldest one held
+ * @param[out]  rec     Decoded record
+ * @return      False if the index is out of the history
+ * @pre         None
+ */
+bool PASCO2HistoryBase::get(uint32_t index, HistoryRec_t & rec) const
+{
+    PASCO2HistoryReader reader(*this);
+
+    return reader.seek(index) && reader.next(rec);
+}
+
+/**
+ * @brief       Storage in use
+ *
+ * @return      Bytes of the full blocks, plus the header and the coded
+ *              records of the last block
+ * @pre         None
+ */
+size_t PASCO2HistoryBase::size() const
+{
+    if(0U == used)
+    {
+        return 0;
+    }
+
+    return ((size_t)(used - 1U) * blockLen) + headerSize + ((enc.pos + 7U) / 8U);
+}
+
+/**
+ * @brief       Gets a block
+ *
+ * @param[in]   index   Block index from the oldest
+ * @return      Block storage
+ */
+uint8_t * PASCO2HistoryBase::blockAt(uint8_t index) const
+{
+    return &data[(size_t)((first + index) % numBlocks) * blockLen];
+}
+
+/**
+ * @brief       Codes a record after the previous one of the last block
+ *
+ * @details     A plain record is the Rice code of the zigzag ppm delta: the
+ *              quotient in unary, ended by a zero, then the k low bits.
+ *              An escaped record starts with a run of HIST_ESCAPE_RUN ones
+ *              and three flags, followed by the new status flags, the
+ *              Elias gamma code of the zigzag timestamp correction, and the
+ *              absolute ppm value or the Rice code of the delta.
+ *
+ * @param[in]   blk     Block
+ * @param[in]   rec     Record
+ * @param[in]   commit  Writes the code and updates the encoder state.
+ *                      Otherwise only its length is computed
+ * @return      Code length in bits
+ */
+uint16_t PASCO2HistoryBase::encode(uint8_t * blk, const HistoryRec_t & rec, bool commit)
+{
+    uint32_t pred = enc.time + (uint32_t)enc.period;
+    int32_t  corr = (int32_t)(rec.timestamp - pred);
+    uint32_t zz   = zigzag((int32_t)rec.co2PPM - enc.ppm);
+    uint8_t  k    = riceParam(enc.sum, enc.num);
+    uint32_t q    = zz >> k;
+    uint8_t  flags = 0;
+
+    corr = (corr > HIST_MAX_CORRECTION) ? HIST_MAX_CORRECTION : corr;
+    corr = (corr < -HIST_MAX_CORRECTION) ? -HIST_MAX_CORRECTION : corr;
+
+    flags |= (q >= HIST_ESCAPE_RUN) ? HIST_FLAG_ABS : 0U;
+    flags |= (rec.diag.u != enc.diag) ? HIST_FLAG_DIAG : 0U;
+    flags |= ((corr > (int32_t)tolerance) || (corr < -(int32_t)tolerance)) ? HIST_FLAG_TIME : 0U;
+
+    uint32_t gamma = zigzag(corr) + 1U;
+    uint8_t  glen  = bitLength(gamma);
+    uint16_t bits  = (0U != (flags & HIST_FLAG_ABS)) ? 16U : (uint16_t)(q + 1U + k);
+
+    if(0U != flags)
+    {
+        bits = (uint16_t)(bits + HIST_ESCAPE_RUN + 3U);
+        bits = (uint16_t)(bits + ((0U != (flags & HIST_FLAG_DIAG)) ? 8U : 0U));
+        bits = (uint16_t)(bits + ((0U != (flags & HIST_FLAG_TIME)) ? ((2U * glen) - 1U) : 0U));
+    }
+
+    if(!commit)
+    {
+        return bits;
+    }
+
+    uint8_t * p = &blk[headerSize];
+
+    if(0U != flags)
+    {
+        putBits(p, enc.pos, (1UL << HIST_ESCAPE_RUN) - 1U, HIST_ESCAPE_RUN);
+        putBits(p, enc.pos, flags, 3U);
+
+        if(0U != (flags & HIST_FLAG_DIAG))
+        {
+            putBits(p, enc.pos, rec.diag.u, 8U);
+        }
+
+        if(0U != (flags & HIST_FLAG_TIME))
+        {
+            /* Leading zeros are already cleared */
+            enc.pos = (uint16_t)(enc.pos + glen - 1U);
+            putBits(p, enc.pos, gamma, glen);
+        }
+    }
+
+    if(0U != (flags & HIST_FLAG_ABS))
+    {
+        putBits(p, enc.pos, (uint16_t)rec.co2PPM, 16U);
+    }
+    else
+    {
+        putBits(p, enc.pos, (1UL << q) - 1U, (uint8_t)q);
+        enc.pos++;
+        putBits(p, enc.pos, zz, k);
+    }
+
+    /* Same state update as decode() */
+    enc.since = (enc.since < 0xFFFFU) ? (uint16_t)(enc.since + 1U) : enc.since;
+
+    if(0U != (flags & HIST_FLAG_TIME))
+    {
+        /* The error built up since the last exact timestamp */
+        enc.period += corr / (int32_t)enc.since;
+        enc.since   = 0;
+        pred       += (uint32_t)corr;
+    }
+
+    enc.time = pred;
+    enc.ppm  = rec.co2PPM;
+    enc.diag = rec.diag.u;
+    riceUpdate(enc.sum, enc.num, zz);
+
+    return bits;
+}
+
+/**
+ * @brief       Gets the number of records of a block
+ */
+uint16_t PASCO2HistoryBase::blockCount(const uint8_t * blk)
+{
+    return (uint16_t)getLE(&blk[HIST_HDR_COUNT], 2U);
+}
+
+/**
+ * @brief       Loads the keyframe of a block
+ *
+ * @param[in]   blk     Block
+ * @param[out]  s       Codec state after the keyframe
+ * @param[out]  rec     Keyframe record
+ */
+void PASCO2HistoryBase::keyframe(const uint8_t * blk, State_t & s, HistoryRec_t & rec)
+{
+    rec.timestamp = getLE(&blk[HIST_HDR_TIME], 4U);
+    rec.co2PPM    = (int16_t)getLE(&blk[HIST_HDR_PPM], 2U);
+    rec.diag.u    = (uint8_t)getLE(&blk[HIST_HDR_DIAG], 1U);
+
+    s.pos    = 0;
+    s.ppm    = rec.co2PPM;
+    s.diag   = rec.diag.u;
+    s.time   = rec.timestamp;
+    s.period = (int32_t)getLE(&blk[HIST_HDR_PERIOD], 4U);
+    s.since  = 0;
+    s.sum    = 2U;
+    s.num    = 1U;
+}
+
+/**
+ * @brief       Decodes the record following the state
+ *
+ * @param[in]   blk     Block
+ * @param[in]   s       Codec state, updated
+ * @param[out]  rec     Decoded record
+ */
+void PASCO2HistoryBase::decode(const uint8_t * blk, State_t & s, HistoryRec_t & rec)
+{
+    const uint8_t * p = &blk[headerSize];
+    uint8_t  k     = riceParam(s.sum, s.num);
+    uint32_t q     = getRun(p, s.pos, HIST_ESCAPE_RUN);
+    uint8_t  flags = 0;
+    uint32_t pred  = s.time + (uint32_t)s.period;
+    uint32_t zz;
+    int16_t  ppm;
+
+    rec.diag.u = s.diag;
+    s.since    = (s.since < 0xFFFFU) ? (uint16_t)(s.since + 1U) : s.since;
+
+    if(HIST_ESCAPE_RUN == q)
+    {
+        flags = (uint8_t)getBits(p, s.pos, 3U);
+
+        if(0U != (flags & HIST_FLAG_DIAG))
+        {
+            rec.diag.u = (uint8_t)getBits(p, s.pos, 8U);
+        }
+
+        if(0U != (flags & HIST_FLAG_TIME))
+        {
+            uint8_t glen = 1U;
+
+            while(0U == getBits(p, s.pos, 1U))
+            {
+                glen++;
+            }
+
+            /* The leading one has been consumed */
+            int32_t corr = unzigzag(((1UL << (glen - 1U)) | getBits(p, s.pos, (uint8_t)(glen - 1U))) - 1U);
+
+            s.period += corr / (int32_t)s.since;
+            s.since   = 0;
+            pred     += (uint32_t)corr;
+        }
+
+        if(0U == (flags & HIST_FLAG_ABS))
+        {
+            q = getRun(p, s.pos, HIST_ESCAPE_RUN);
+        }
+    }
+
+    if(0U != (flags & HIST_FLAG_ABS))
+    {
+        ppm = (int16_t)getBits(p, s.pos, 16U);
+        zz  = zigzag((int32_t)ppm - s.ppm);
+    }
+    else
+    {
+        zz  = (q << k) | getBits(p, s.pos, k);
+        ppm = (int16_t)(s.ppm + unzigzag(zz));
+    }
+
+    rec.timestamp = pred;
+    rec.co2PPM    = ppm;
+
+    s.time = pred;
+    s.ppm  = ppm;
+    s.diag = rec.diag.u;
+    riceUpdate(s.sum, s.num, zz);
+}
+
+/**
+ * @brief       History reader constructor
+ *
+ * @details     The reader starts at the oldest record.
+ *
+ * @param[in]   history     History to decode
+ * @pre         None
+ */
+PASCO2HistoryReader::PASCO2HistoryReader(const PASCO2HistoryBase & history)
+: history(history), blk(0), idx(0)
+{
+    memset(&state, 0, sizeof(state));
+}
+
+/**
+ * @brief       Moves to a record
+ *
+ * @details     Decodes the block of the record up to it.
+ *
+ * @param[in]   index   Record index, 0 being the oldest one held
+ * @return      False if the index is out of the history
+ * @pre         None
+ */
+bool PASCO2HistoryReader::seek(uint32_t index)
+{
+    HistoryRec_t rec;
+
+    if(index >= history.count())
+    {
+        return false;
+    }
+
+    blk = 0;
+    idx = 0;
+
+    while(index >= PASCO2HistoryBase::blockCount(history.blockAt(blk)))
+    {
+        index -= PASCO2HistoryBase::blockCount(history.blockAt(blk));
+        blk++;
+    }
+
+    while(idx < index)
+    {
+        (void)next(rec);
+    }
+
+    return true;
+}
+
+/**
+ * @brief       Decodes the next record
+ *
+ * @param[out]  rec     Decoded record
+ * @return      False if all the records have been read
+ * @pre         None
+ */
+bool PASCO2HistoryReader::next(HistoryRec_t & rec)
+{
+    if(blk >= history.blocks())
+    {
+        return false;
+    }
+
+    const uint8_t * b = history.blockAt(blk);
+
+    if(idx >= PASCO2HistoryBase::blockCount(b))
+    {
+        if((blk + 1U) >= history.blocks())
+        {
+            return false;
+        }
+
+        blk++;
+        idx = 0;
+        b   = history.blockAt(blk);
+    }
+
+    if(0U == idx)
+    {
+        PASCO2HistoryBase::keyframe(b, state, rec);
+    }
+    else
+    {
+        PASCO2HistoryBase::decode(b, state, rec);
+    }
+
+    idx++;
+
+    return true;
+}
@@ -0,0 +1,227 @@
+/**
+ * @file        pas-co2-history-ino.hpp
+ * @brief       XENSIV™ PAS CO2 Arduino Compressed History
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef PAS_CO2_HISTORY_INO_HPP_
+#define PAS_CO2_HISTORY_INO_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pas-co2-ino.hpp"
+
+/**
+ * @addtogroup co2inoapi
+ * @{
+ */
+
+/**
+ * @brief   Decoded history record
+ */
+typedef struct
+{
+    uint32_t    timestamp;  /**< Result time in ms, within the history tolerance */
+    int16_t     co2PPM;     /**< CO2 concentration in ppm */
+    Diag_t      diag;       /**< Sensor status flags (SENS_STS) */
+} HistoryRec_t;
+
+class PASCO2HistoryReader;
+
+/**
+ * @brief       Compressed history, storage size independent part
+ *
+ * @details     Use PASCO2History to declare the storage.
+ */
+class PASCO2HistoryBase
+{
+    public:
+
+        static constexpr uint8_t   headerSize          = 13U;    /**< Block header (keyframe) size in bytes */
+        static constexpr uint16_t  defaultToleranceMs  = 1000U;  /**< Default timestamp tolerance in ms */
+
+        void     reset      ();
+        bool     add        (int16_t co2PPM, Diag_t diag, uint32_t timestamp);
+        bool     add        (int16_t co2PPM, Diag_t diag);
+        bool     add        (const Sample_t & sample);
+        bool     get        (uint32_t index, HistoryRec_t & rec) const;
+        size_t   size       () const;
+
+        /**
+         * @brief   Number of records held
+         */
+        uint32_t count      () const { return held; }
+
+        /**
+         * @brief   Number of records evicted to make room since the last reset
+         */
+        uint32_t evicted    () const { return dropped; }
+
+        /**
+         * @brief   Storage size in bytes
+         */
+        size_t   capacity   () const { return (size_t)blockLen * numBlocks; }
+
+        /**
+         * @brief   Number of blocks in use, the last one being filled
+         */
+        uint8_t  blocks     () const { return used; }
+
+        /**
+         * @brief   Block size in bytes
+         */
+        uint16_t blockSize  () const { return blockLen; }
+
+        /**
+         * @brief   Raw block, from the oldest one
+         * @details Each block is self-contained: a keyframe header followed
+         *          by the bit-packed records. It can be stored as is.
+         */
+        const uint8_t * block(uint8_t index) const { return blockAt(index); }
+
+    protected:
+
+        PASCO2HistoryBase(uint8_t * data, uint16_t blockLen, uint8_t numBlocks, uint16_t toleranceMs);
+
+    private:
+
+        friend class PASCO2HistoryReader;
+
+        /**
+         * @brief   Codec state, mirrored by the encoder and the decoder
+         */
+        typedef struct
+        {
+            uint16_t    pos;        /**< Bit position in the block payload */
+            int16_t     ppm;        /**< Previous CO2 concentration */
+            uint8_t     diag;       /**< Previous sensor status */
+            uint32_t    time;       /**< Previous decoded timestamp in ms */
+            int32_t     period;     /**< Predicted interval in ms */
+            uint16_t    since;      /**< Records since the last exact timestamp */
+            uint32_t    sum;        /**< Rice parameter: sum of the recent zigzag deltas */
+            uint16_t    num;        /**< Rice parameter: number of recent deltas */
+        } State_t;
+
+        uint8_t       * blockAt     (uint8_t index) const;
+        uint16_t        encode      (uint8_t * blk, const HistoryRec_t & rec, bool commit);
+
+        static uint16_t blockCount  (const uint8_t * blk);
+        static void     keyframe    (const uint8_t * blk, State_t & s, HistoryRec_t & rec);
+        static void     decode      (const uint8_t * blk, State_t & s, HistoryRec_t & rec);
+
+        uint8_t       * data;       /**< Block storage */
+        uint16_t        blockLen;   /**< Block size in bytes */
+        uint8_t         numBlocks;  /**< Number of blocks */
+        uint16_t        tolerance;  /**< Timestamp tolerance in ms */
+        uint8_t         first;      /**< Storage slot of the oldest block */
+        uint8_t         used;       /**< Blocks in use */
+        uint32_t        held;       /**< Records held */
+        uint32_t        dropped;    /**< Records evicted */
+        State_t         enc;        /**< Encoder state of the last block */
+};
+
+/**
+ * @brief       Compressed CO2 history in a fixed RAM buffer
+ *
+ * @details     Stores the results with their sensor status flags and
+ *              timestamps in a few bits each, instead of 7 bytes. The
+ *              buffer is split into blocks, each one starting with a
+ *              keyframe holding a full record, so that any record is
+ *              decoded from its block only. When the buffer is full, the
+ *              oldest block is evicted.
+ *
+ *              Each record after the keyframe is coded against the previous
+ *              one:
+ *              - The ppm delta is zigzag mapped and Rice coded, with a
+ *                parameter following the recent deltas. A steady value
+ *                takes 1 bit, and a few ppm of sensor noise 5 to 7 bits.
+ *              - The timestamp is predicted from the average interval, and
+ *                only coded when it is off by more than the tolerance. The
+ *                decoded timestamps are then within the tolerance of the
+ *                original ones. A zero tolerance keeps them exact, at the
+ *                cost of about 30 bits per result for the readout jitter.
+ *              - The status flags are only coded on a change.
+ *
+ *              The ppm values and the status flags are lossless. At one
+ *              result per minute, 2 KB hold 1.5 to 2 days of results with
+ *              3 to 8 ppm of noise, against less than 5 hours of 7 byte
+ *              records.
+ *
+ *              @code
+ *              PASCO2History<2048> history;
+ *              Sample_t sample;
+ *
+ *              if(XENSIV_PASCO2_OK == cotwo.service(sample))
+ *              {
+ *                  history.add(sample);
+ *              }
+ *
+ *              HistoryRec_t rec;
+ *              PASCO2HistoryReader reader(history);
+ *              while(reader.next(rec))
+ *              {
+ *                  // ... oldest to newest ...
+ *              }
+ *              @endcode
+ *
+ * @tparam      S   Storage size in bytes
+ * @tparam      B   Block size in bytes, 32 to 1024. Smaller blocks evict less
+ *                  history at a time and decode faster, larger ones spend
+ *                  less on the keyframes
+ */
+template<uint16_t S, uint16_t B = 128>
+class PASCO2History : public PASCO2HistoryBase
+{
+    static_assert((B >= 32U) && (B <= 1024U), "block size must be 32 to 1024 bytes");
+    static_assert(((S / B) >= 2U) && ((S / B) <= 255U), "storage must hold 2 to 255 blocks");
+
+    public:
+
+        /**
+         * @brief       Compressed history constructor
+         * @param[in]   toleranceMs Maximum error of the decoded timestamps in ms.
+         *                          0 keeps them exact
+         */
+        PASCO2History(uint16_t toleranceMs = defaultToleranceMs)
+        : PASCO2HistoryBase(storage, B, (uint8_t)(S / B), toleranceMs)
+        {
+
+        }
+
+        /* The base class points to the storage */
+        PASCO2History(const PASCO2History &) = delete;
+        PASCO2History & operator=(const PASCO2History &) = delete;
+
+    private:
+
+        uint8_t storage[(S / B) * B];   /**< Block storage */
+};
+
+/**
+ * @brief       Sequential decoder of a compressed history
+ *
+ * @details     Decodes the records from the oldest one, or from any index
+ *              after seek(). Adding records to the history while reading
+ *              is supported, as long as the block being read is not evicted.
+ */
+class PASCO2HistoryReader
+{
+    public:
+
+                PASCO2HistoryReader (const PASCO2HistoryBase & history);
+        bool    seek                (uint32_t index);
+        bool    next                (HistoryRec_t & rec);
+
+    private:
+
+        const PASCO2HistoryBase   & history;    /**< Decoded history */
+        uint8_t                     blk;        /**< Block being read, from the oldest */
+        uint16_t                    idx;        /**< Next record in the block */
+        PASCO2HistoryBase::State_t  state;      /**< Decoder state */
+};
+
+/** @} */
+
+#endif /** PAS_CO2_HISTORY_INO_HPP_ **/
@@ -23,44 +23,78 @@
  */
 #define PAS_CO2_SERIAL_PAL_INIT_EXTERNAL
 
+template<typename Transport>
+PASCO2<Transport> * PASCO2<Transport>::isrInst[PASCO2<Transport>::maxIsrInst] = {nullptr};
+
 /**
- * @brief      XENSIV™ PAS CO2 I2C Arduino Constructor
- *
- * @param[in]   wire    TwoWire interface instance. Default is the Arduino primary Wire instance.
- * @param[in]   intPin  Interrupt pin. Default is UnusedPin         
- * @pre         None
+ * @brief   Data ready interrupt trampoline
+ * 
+ * @details Only flags the instance of the slot. The sensor is 
+ *          read out by service().
+ * 
+ * @tparam  I   Trampoline slot
  */
-PASCO2Ino::PASCO2Ino(TwoWire * wire,
-                                 uint8_t   intPin)
-: i2c(wire), uart(nullptr), intPin(intPin)
+template<typename Transport>
+template<uint8_t I>
+void PASCO2<Transport>::dataReadyISR()
 {
-
+    isrInst[I]->dataReady = true;
 }
 
 /**
- * @brief      XENSIV™ PAS CO2 UART Arduino Constructor
- * 
- * @param[in]   serial  Serial interface instance
+ * @brief      XENSIV™ PAS CO2 Arduino Constructor
+ *
+ * @param[in]   bus     Serial interface transport. PASCO2I2C and PASCO2Dual default to 
+ *                      the Arduino primary Wire instance. PASCO2Dual is implicitly 
+ *                      constructed from a TwoWire or HardwareSerial instance pointer.
  * @param[in]   intPin  Interrupt pin. Default is UnusedPin         
  * @pre         None
  */
-PASCO2Ino::PASCO2Ino(HardwareSerial * serial,
-                                 uint8_t          intPin)
-: i2c(nullptr), uart(serial), intPin(intPin)
+template<typename Transport>
+PASCO2<Transport>::PASCO2(Transport bus,
+                          uint8_t   intPin)
+: transport(bus), intPin(intPin), uartPipelined(false), shadowCache(false),
+  resetPending(false), resetStart(0), resetStatus(XENSIV_PASCO2_ERR_NOT_READY), dev(),
+  reqData(nullptr), reqLen(0), reqIdx(0), reqStatus(XENSIV_PASCO2_OK),
+  fcs(), fcsStatus(XENSIV_PASCO2_OK), fcsStart(0), fcsLastPoll(0), fcsPoll(fcsPollMs), fcsBocCfg(XENSIV_PASCO2_BOC_CFG_DISABLE),
+  dataReady(false), isrSlot(maxIsrInst), sampleSeq(0),
+  trace(), tracing(false), mutex(nullptr)
 {
 
 }
 
 /**
  * @brief       XENSIV™ PAS CO2 Arduino Destructor 
- * @details     It disables the sensor and deletes all the
- *              dynamically created PAL instances in the 
- *              constructor
+ * @details     Detaches the interrupt pin and releases the interrupt
+ *              trampoline slot, so that a pending sensor interrupt
+ *              does not reach the destroyed instance
  * @pre         None
  */
-PASCO2Ino::~PASCO2Ino()
+template<typename Transport>
+PASCO2<Transport>::~PASCO2()
+{
+    releaseInterrupt();
+}
+
+/**
+ * @brief       Rebinds the serial interface transport
+ * 
+ * @details     Lets instances built in place, e.g. in an array, use 
+ *              another bus than the default one.
+ * 
+ * @param[in]   bus     Serial interface transport
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK always
+ * @pre         Not begun, or after end()
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::init(Transport bus)
 {
+    Lock lock(mutex);
+
+    transport = bus;
 
+    return XENSIV_PASCO2_OK;
 }
 
 /**
@@ -71,51 +105,166 @@ PASCO2Ino::~PASCO2Ino()
  *          Sets the I2C freq or UART baudrate to the default values 
  *          prior the serial interface initialization.
  *          Initializes the interrupt pin if used.
+ *          Blocks while the sensor performs the soft reset. 
  * 
  * @return  XENSIV™ PAS CO2 error code
  * @retval  XENSIV_PASCO2_OK if success 
  * @pre     None
  */
-Error_t PASCO2Ino::begin()
+template<typename Transport>
+Error_t PASCO2<Transport>::begin()
 {
     int32_t ret = XENSIV_PASCO2_OK;
-    xensiv_pasco2_measurement_config_t  measConf;
+
+    ret = beginAsync();
+    INO_ASSERT_RET(ret);
+
+    xensiv_pasco2_delay(&dev, XENSIV_PASCO2_SOFT_RESET_DELAY_MS);
+
+    /**
+     * Finished without poll()'s millis() check: the wait may be timed 
+     * by another clock and return up to a tick before millis() catches up
+     */
+    Lock lock(mutex);
+
+    if(!resetPending)
+    {
+        return resetStatus;
+    }
+
+    return finishReset();
+}
+
+/**
+ * @brief   Begins the sensor without waiting for the soft reset
+ * 
+ * @details Same as begin(), but returns right after triggering
+ *          the sensor soft reset. The sensor is ready when poll() 
+ *          returns XENSIV_PASCO2_OK, which allows to reset several 
+ *          sensors in parallel:
+ * 
+ *          @code
+ *          cotwo1.beginAsync();
+ *          cotwo2.beginAsync();
+ * 
+ *          while((XENSIV_PASCO2_BUSY == cotwo1.poll()) || 
+ *                (XENSIV_PASCO2_BUSY == cotwo2.poll()))
+ *          {
+ *              // ... do something else ... 
+ *          }
+ *          @endcode
+ * 
+ * @return  XENSIV™ PAS CO2 error code
+ * @retval  XENSIV_PASCO2_OK if the soft reset has been triggered 
+ * @pre     None
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::beginAsync()
+{
+    Lock lock(mutex);
+
+    int32_t ret = XENSIV_PASCO2_OK;
 
     /* Initialize sensor interface */
-    if(nullptr != i2c)
+    ret = transport.begin(&dev);
+
+    /* The corelib initialization stops the tracing. Restarted before the interface check and soft reset */
+    if((XENSIV_PASCO2_OK == ret) && tracing)
     {
-        #ifndef PAS_CO2_SERIAL_PAL_INIT_EXTERNAL
-        i2c->begin();
-        i2c->setClock(freqHz);
-        #endif 
-        ret = xensiv_pasco2_init_i2c(&dev, i2c);
+        xensiv_pasco2_trace_start(&dev, &trace);
     }
-    else if(nullptr != uart)
+
+    if(XENSIV_PASCO2_OK == ret)
+    {
+        ret = xensiv_pasco2_reset_start(&dev);
+    }
+
+    if(nullptr != transport.serial())
     {
-        #ifndef PAS_CO2_SERIAL_PAL_INIT_EXTERNAL
-        uart->begin(baudrateBps);   
-        #endif
-        ret = xensiv_pasco2_init_uart(&dev, uart);
+        xensiv_pasco2_set_uart_pipelining(&dev, uartPipelined);
     }
 
+    xensiv_pasco2_set_shadow(&dev, shadowCache);
+
     /* Initialize int_pin */
     if( unusedPin != intPin)
     {
         pinMode(intPin, INPUT_PULLUP);
     }
 
+    resetPending = false;
+    resetStatus  = ret;
+    INO_ASSERT_RET(ret);
+
+    resetStart   = (uint32_t)millis();
+    resetPending = true;
+    resetStatus  = XENSIV_PASCO2_BUSY;
+
+    return ret;
+}
+
+/**
+ * @brief   Polls the asynchronous begin 
+ * 
+ * @details Once the soft reset time has elapsed, checks that the 
+ *          sensor is ready and sets it in idle mode. 
+ *          It never waits. Once the begin has completed, it keeps 
+ *          returning its result.
+ * 
+ * @return  XENSIV™ PAS CO2 error code
+ * @retval  XENSIV_PASCO2_OK if the sensor is ready
+ * @retval  XENSIV_PASCO2_BUSY if the soft reset is still ongoing
+ * @retval  XENSIV_PASCO2_ERR_NOT_READY if beginAsync() has not been called
+ * @pre     beginAsync()
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::poll()
+{
+    Lock lock(mutex);
+
+    if(!resetPending)
+    {
+        return resetStatus;
+    }
+
+    if(((uint32_t)millis() - resetStart) < XENSIV_PASCO2_SOFT_RESET_DELAY_MS)
+    {
+        return XENSIV_PASCO2_BUSY;
+    }
+
+    return finishReset();
+}
+
+/**
+ * @brief   Completes the soft reset started by beginAsync()
+ * 
+ * @details Checks that the sensor is ready and sets it in idle mode. 
+ * 
+ * @return  XENSIV™ PAS CO2 error code
+ * @retval  XENSIV_PASCO2_OK if the sensor is ready
+ * @pre     Instance lock taken, soft reset time elapsed
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::finishReset()
+{
+    int32_t ret = XENSIV_PASCO2_OK;
+
+    resetPending = false;
+
+    ret = xensiv_pasco2_init_finish(&dev);
+
     /**
      * Set the sensor in idle mode.
      * In case PWM_DIS is by hardware configuring 
      * the device to continuous mode
      */
-    ret = xensiv_pasco2_get_measurement_config(&dev, &measConf);
-    INO_ASSERT_RET(ret);
+    if(XENSIV_PASCO2_OK == ret)
+    {
+        ret = setIdleMode();
+    }
 
-    measConf.b.op_mode = XENSIV_PASCO2_OP_MODE_IDLE;
+    resetStatus = ret;
 
-    ret = xensiv_pasco2_set_measurement_config(&dev, measConf);
-     
     return ret;
 }
 
@@ -123,38 +272,47 @@ Error_t PASCO2Ino::begin()
  * @brief   Ends the sensor
  * 
  * @details Deinitializes the serial interface if the deinitialization
- *          is delegated to the PASCO2Ino class. 
+ *          is delegated to the PASCO2 class. 
  *          Deinitializes the interrupt pin if used.
  * 
  * @return  XENSIV™ PAS CO2 error code
  * @retval  XENSIV_PASCO2_OK always
  * @pre     begin()
  */
-Error_t PASCO2Ino::end()
+template<typename Transport>
+Error_t PASCO2<Transport>::end()
 {
+    Lock lock(mutex);
+
     /**< Deinitialize sensor interface*/
-    if(nullptr != i2c)
-    {
-        #ifndef PAS_CO2_SERIAL_PAL_INIT_EXTERNAL
-        #if !defined(ARDUINO_ARCH_ESP32)
-        i2c->end();
-        #endif
-        #endif
-    }   
-    else if(nullptr != uart)
-    {
-        #ifndef PAS_CO2_SERIAL_PAL_INIT_EXTERNAL
-        uart->end();
-        #endif
-    }
+    transport.end();
+
+    resetPending = false;
+    resetStatus  = XENSIV_PASCO2_ERR_NOT_READY;
+
+    releaseInterrupt();
+
+    return XENSIV_PASCO2_OK;
+}
 
-    /* Deinitialize interrupt pin */
+/**
+ * @brief   Deinitializes the interrupt pin and releases the interrupt trampoline slot
+ */
+template<typename Transport>
+void PASCO2<Transport>::releaseInterrupt()
+{
     if(unusedPin != intPin)
     {
         detachInterrupt(digitalPinToInterrupt(intPin));
     }
 
-    return XENSIV_PASCO2_OK;
+    if(maxIsrInst != isrSlot)
+    {
+        noInterrupts();
+        isrInst[isrSlot] = nullptr;
+        interrupts();
+        isrSlot = maxIsrInst;
+    }
 }
 
 /**
@@ -295,8 +453,11 @@ Error_t PASCO2Ino::end()
  * @retval      XENSIV_PASCO2_OK if success
  * @pre         begin()
  */
-Error_t PASCO2Ino::startMeasure(int16_t periodInSec, int16_t alarmTh, void (*cback) (void *), bool earlyNotification)
+template<typename Transport>
+Error_t PASCO2<Transport>::startMeasure(int16_t periodInSec, int16_t alarmTh, void (*cback) (void *), bool earlyNotification)
 {
+    Lock lock(mutex);
+
     xensiv_pasco2_measurement_config_t  measConf;
     xensiv_pasco2_interrupt_config_t intConf; 
     int32_t ret = XENSIV_PASCO2_OK;   
@@ -404,7 +565,23 @@ Error_t PASCO2Ino::startMeasure(int16_t periodInSec, int16_t alarmTh, void (*cba
  * @retval      XENSIV_PASCO2_OK if success
  * @pre         begin()
  */
-Error_t PASCO2Ino::stopMeasure()
+template<typename Transport>
+Error_t PASCO2<Transport>::stopMeasure()
+{
+    Lock lock(mutex);
+
+    return setIdleMode();
+}
+
+/**
+ * @brief       Sets the sensor operation mode to idle
+ * 
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @pre         Instance lock taken
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::setIdleMode()
 {
     int32_t ret = XENSIV_PASCO2_OK;  
 
@@ -421,6 +598,217 @@ Error_t PASCO2Ino::stopMeasure()
     return ret;
 }
 
+/**
+ * @brief       Changes the continuous measurement period
+ * 
+ * @details     The sensor only takes a new MEAS_RATE in idle mode. In 
+ *              continuous mode, the sensor is set in idle mode, MEAS_RATE 
+ *              is written and the previous measurement configuration is 
+ *              restored, so that the continuous mode restarts with the 
+ *              new period. Unlike startMeasure(), the interrupt and alarm 
+ *              configuration is left untouched. A sequence in progress is 
+ *              aborted, and the restart begins a new one at once. 
+ *              In idle mode, the period is used by the next continuous 
+ *              mode start. Between beginConfig() and commit(), the write 
+ *              is staged like the other ones, and commit() goes through 
+ *              idle mode to apply it. 
+ * 
+ * @param[in]   periodInSec     Measurement period. The valid period range 
+ *                              goes between 5 and 4095 seconds
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @retval      XENSIV_PASCO2_ERR_ILLEGAL_ARG if the period is out of range
+ * @pre         begin()
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::setMeasRate(int16_t periodInSec)
+{
+    Lock lock(mutex);
+
+    int32_t ret = XENSIV_PASCO2_OK;
+
+    xensiv_pasco2_measurement_config_t  measConf;
+    xensiv_pasco2_measurement_config_t  idleConf;
+
+    if((periodInSec < (int16_t)XENSIV_PASCO2_MEAS_RATE_MIN) || (periodInSec > (int16_t)XENSIV_PASCO2_MEAS_RATE_MAX))
+    {
+        return XENSIV_PASCO2_ERR_ILLEGAL_ARG;
+    }
+
+    /* A staged write is applied by commit() through idle mode */
+    if(dev.stage_en)
+    {
+        return xensiv_pasco2_set_measurement_rate(&dev, (uint16_t)periodInSec);
+    }
+
+    ret = xensiv_pasco2_get_measurement_config(&dev, &measConf);
+    INO_ASSERT_RET(ret);
+
+    if(XENSIV_PASCO2_OP_MODE_IDLE != measConf.b.op_mode)
+    {
+        idleConf = measConf;
+        idleConf.b.op_mode = XENSIV_PASCO2_OP_MODE_IDLE;
+        ret = xensiv_pasco2_set_measurement_config(&dev, idleConf);
+        INO_ASSERT_RET(ret);
+    }
+
+    ret = xensiv_pasco2_set_measurement_rate(&dev, (uint16_t)periodInSec);
+    INO_ASSERT_RET(ret);
+
+    if(XENSIV_PASCO2_OP_MODE_IDLE != measConf.b.op_mode)
+    {
+        ret = xensiv_pasco2_set_measurement_config(&dev, measConf);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief       Starts the interrupt-driven acquisition
+ * 
+ * @details     Starts the measurement like startMeasure(), with the data ready 
+ *              interrupt routed to an internal minimal ISR which only flags the 
+ *              new sample. The sensor is read out by service(), which is meant 
+ *              to be called from the main loop:
+ * 
+ *              @code
+ *              PASCO2SampleRing<16> ring;
+ *              Sample_t samples[4];
+ * 
+ *              cotwo.startAcquisition(10);
+ * 
+ *              while(1)
+ *              {
+ *                  cotwo.service(ring);
+ * 
+ *                  uint8_t n = ring.drain(samples, 4);
+ *                  // ... process n samples ... 
+ *              }
+ *              @endcode
+ * 
+ *              If no interrupt pin is used, or all the maxIsrInst interrupt slots 
+ *              are taken by other instances, service() polls the measurement 
+ *              status register instead.
+ * 
+ * @param[in]   periodInSec     Continuous measurement period. The default value is 0, 
+ *                              meaning single shot operation. 
+ *                              The valid period range goes between 5 and 4095 seconds
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @pre         begin()
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::startAcquisition(int16_t periodInSec)
+{
+    static void (* const isrTable[maxIsrInst])() = 
+    {
+        dataReadyISR<0>, dataReadyISR<1>, dataReadyISR<2>, dataReadyISR<3>
+    };
+
+    if((unusedPin != intPin) && (maxIsrInst == isrSlot))
+    {
+        noInterrupts();
+        for(uint8_t i = 0; i < maxIsrInst; i++)
+        {
+            if(nullptr == isrInst[i])
+            {
+                isrInst[i] = this;
+                isrSlot = i;
+                break;
+            }
+        }
+        interrupts();
+    }
+
+    dataReady = false;
+
+    if(maxIsrInst == isrSlot)
+    {
+        return startMeasure(periodInSec);
+    }
+
+    return startMeasure(periodInSec, 0, (void (*)(void *))isrTable[isrSlot]);
+}
+
+/**
+ * @brief       Services the acquisition
+ * 
+ * @details     Reads out the new sample if the data ready interrupt has been 
+ *              flagged, or if the sensor reports it in polling mode. Otherwise 
+ *              returns without accessing the sensor.
+ *              The sensor interrupt status is cleared after the readout.
+ *              On a communication error the interrupt flag is kept, so that
+ *              the next call retries the readout.
+ * 
+ * @param[out]  sample  New sample. Timestamped with millis()
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if a new sample has been read
+ * @retval      XENSIV_PASCO2_READ_NRDY if no new sample is available
+ * @pre         startAcquisition()
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::service(Sample_t & sample)
+{
+    Lock lock(mutex);
+
+    uint8_t regs[XENSIV_PASCO2_REG_MEAS_STS - XENSIV_PASCO2_REG_SENS_STS + 1U];
+    int32_t ret = XENSIV_PASCO2_OK;
+    bool flagged = false;
+
+    if(maxIsrInst != isrSlot)
+    {
+        if(!dataReady)
+        {
+            return XENSIV_PASCO2_READ_NRDY;
+        }
+
+        /* Cleared before the readout to catch the next edge */
+        dataReady = false;
+        flagged   = true;
+    }
+
+    /* SENS_STS to MEAS_STS in a single transaction */
+    ret = xensiv_pasco2_get_reg(&dev, (uint8_t)XENSIV_PASCO2_REG_SENS_STS, regs, sizeof(regs));
+    if(XENSIV_PASCO2_OK != ret)
+    {
+        /* Flagged again, so that the next call retries the readout */
+        if(flagged)
+        {
+            dataReady = true;
+        }
+        return ret;
+    }
+
+    uint8_t measSts = regs[XENSIV_PASCO2_REG_MEAS_STS - XENSIV_PASCO2_REG_SENS_STS];
+
+    if(0U == (measSts & XENSIV_PASCO2_REG_MEAS_STS_DRDY_MSK))
+    {
+        return XENSIV_PASCO2_READ_NRDY;
+    }
+
+    if(0U != (measSts & XENSIV_PASCO2_REG_MEAS_STS_INT_STS_MSK))
+    {
+        ret = xensiv_pasco2_clear_measurement_status(&dev, XENSIV_PASCO2_REG_MEAS_STS_INT_STS_CLR_MSK);
+        if(XENSIV_PASCO2_OK != ret)
+        {
+            if(flagged)
+            {
+                dataReady = true;
+            }
+            return ret;
+        }
+    }
+
+    sample.timestamp  = (uint32_t)millis();
+    sample.co2PPM     = (int16_t)(((uint16_t)regs[XENSIV_PASCO2_REG_CO2PPM_H - XENSIV_PASCO2_REG_SENS_STS] << 8) | 
+                                   regs[XENSIV_PASCO2_REG_CO2PPM_L - XENSIV_PASCO2_REG_SENS_STS]);
+    sample.measStatus = measSts;
+    sample.sensStatus = regs[0];
+    sample.seq        = sampleSeq++;
+
+    return ret;
+}
+
 /**
  * @brief       Gets the CO2 concentration measured
  *               
@@ -433,8 +821,11 @@ Error_t PASCO2Ino::stopMeasure()
  * @retval      XENSIV_PASCO2_OK if success
  * @pre         startMeasure()
  */
-Error_t PASCO2Ino::getCO2(int16_t & CO2PPM)
+template<typename Transport>
+Error_t PASCO2<Transport>::getCO2(int16_t & CO2PPM)
 {
+    Lock lock(mutex);
+
     int32_t ret = XENSIV_PASCO2_OK;  
 
     /* Initially set to 0.*/
@@ -469,8 +860,11 @@ Error_t PASCO2Ino::getCO2(int16_t & CO2PPM)
  * @retval      XENSIV_PASCO2_OK if success
  * @pre         None
  */
-Error_t PASCO2Ino::getDiagnosis(Diag_t & diagnosis)
+template<typename Transport>
+Error_t PASCO2<Transport>::getDiagnosis(Diag_t & diagnosis)
 {
+    Lock lock(mutex);
+
     int32_t ret = XENSIV_PASCO2_OK; 
 
     /* Get current status */
@@ -486,61 +880,490 @@ Error_t PASCO2Ino::getDiagnosis(Diag_t & diagnosis)
 }
 
 /**
- * @brief       Configures the sensor automatic baseline compensation
+ * @brief       Reads a snapshot of the complete sensor register file
  * 
- * @param[in]   aboc        Automatic baseline compenstation mode  
- * @param[in]   abocRef     Automatic baseline compensation reference
+ * @details     All the registers from PROD_ID to SCRATCH_PAD are read in a 
+ *              single serial access and decoded into the snapshot struct.
+ *              This replaces the separate register accesses of getCO2() and 
+ *              getDiagnosis() when polling the sensor state:
+ * 
+ *              @code
+ *              Snapshot_t snap;
+ * 
+ *              cotwo.readSnapshot(snap);
+ * 
+ *              if(snap.meas_status.b.drdy)
+ *              {
+ *                  // ... do something with snap.co2_ppm ... 
+ *              }
+ *              @endcode
+ * 
+ *              The status flags are not cleared by this function.
+ * 
+ * @param[out]  snapshot    Struct to store the decoded register values
  * @return      XENSIV™ PAS CO2 error code
  * @retval      XENSIV_PASCO2_OK if success
  * @pre         begin()
  */
-Error_t PASCO2Ino::setABOC(ABOC_t aboc, int16_t abocRef)
+template<typename Transport>
+Error_t PASCO2<Transport>::readSnapshot(Snapshot_t & snapshot)
 {
-    xensiv_pasco2_measurement_config_t  measConf;
-    int32_t ret = XENSIV_PASCO2_OK; 
-
-    /* Get meas configuration */
-    ret = xensiv_pasco2_get_measurement_config(&dev, &measConf);
-    INO_ASSERT_RET(ret);
-
-    /* Set compensation offset */
-    ret = xensiv_pasco2_set_offset_compensation(&dev, (uint16_t) abocRef);
-    INO_ASSERT_RET(ret);
-
-    /* Set meas configuration with ABOC */
-    measConf.b.boc_cfg = aboc;
-    ret = xensiv_pasco2_set_measurement_config(&dev, measConf);
+    Lock lock(mutex);
 
-    return ret;
+    return xensiv_pasco2_get_snapshot(&dev, &snapshot);
 }
 
 /**
- * @brief       Performs force compensation
+ * @brief       Gets the runtime statistics of the sensor communication
  * 
- * @details     Calculates the offset compensation when the sensor is exposed to a CO2 reference
- *              value.
- * @warning     The device is left in idle mode after the compensation value is stored in
- *              non-volatile memory. 
+ * @details     The counters are updated by the corelib on every register 
+ *              transaction and platform delay, and include:
+ *              - Read and write transactions and bytes
+ *              - Communication errors
+ *              - Result reads without new data available
+ *              - Total and maximum time spent in delays
+ *              - Maximum latency of a single register transaction
  * 
- * @param[in]   co2Ref  Automatic baseline compenstation mode  
+ *              No lock is taken. The snapshot is retried if it overlaps with 
+ *              an update from another context (e.g. getCO2() called from a 
+ *              task while the statistics are read from the main loop):
+ * 
+ *              @code
+ *              Stats_t stats;
+ * 
+ *              if(XENSIV_PASCO2_OK == cotwo.getStats(stats))
+ *              {
+ *                  Serial.println(stats.comm_errors);
+ *              }
+ *              @endcode
+ * 
+ * @param[out]  stats       Struct to store the statistics snapshot
  * @return      XENSIV™ PAS CO2 error code
  * @retval      XENSIV_PASCO2_OK if success
- * @pre         begin()
+ * @retval      XENSIV_PASCO2_BUSY if the counters kept being updated during the snapshot
+ * @pre         None
  */
-Error_t PASCO2Ino::performForcedCompensation(uint16_t co2Ref)
+template<typename Transport>
+Error_t PASCO2<Transport>::getStats(Stats_t & stats)
 {
-    return xensiv_pasco2_perform_forced_compensation(&dev, co2Ref);
+    return xensiv_pasco2_get_stats(&dev, &stats) ? XENSIV_PASCO2_OK : XENSIV_PASCO2_BUSY;
 }
 
 /**
- * @brief       Resets the forced calibration correction factor
+ * @brief       Resets the runtime statistics of the sensor communication
  * 
  * @return      XENSIV™ PAS CO2 error code
- * @retval      XENSIV_PASCO2_OK if success
+ * @retval      XENSIV_PASCO2_OK always
+ * @pre         None
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::resetStats()
+{
+    Lock lock(mutex);
+
+    xensiv_pasco2_reset_stats(&dev);
+
+    return XENSIV_PASCO2_OK;
+}
+
+/**
+ * @brief       Starts recording the sensor bus transactions
+ * 
+ * @details     Every register read and write is stored in the buffer with 
+ *              its register address, payload, result, start time and 
+ *              duration in microseconds. When the buffer is full the oldest 
+ *              records are overwritten, so that the buffer always holds the 
+ *              latest transactions before a failure.
+ * 
+ *              The tracing is kept across begin(), including the register 
+ *              accesses of the sensor interface check and soft reset request.
+ *              The UART register reads of requestRegister() are recorded as
+ *              single register reads as the replies are collected.
+ * 
+ *              The records can be dumped in the portable binary format read 
+ *              by the host replay tool in extras/host:
+ * 
+ *              @code
+ *              TraceRec_t rec;
+ *              uint8_t    bin[XENSIV_PASCO2_TRACE_REC_LEN];
+ * 
+ *              for(uint16_t i = 0; XENSIV_PASCO2_OK == cotwo.readTrace(i, rec); i++)
+ *              {
+ *                  xensiv_pasco2_trace_encode(&rec, bin);
+ *                  Serial.write(bin, sizeof(bin));
+ *              }
+ *              @endcode
+ * 
+ * @param[in]   buf         Record storage. Must remain valid while tracing
+ * @param[in]   size        Capacity of buf in records
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @retval      XENSIV_PASCO2_ERR_ILLEGAL_ARG if the buffer is empty
+ * @pre         None
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::startTrace(TraceRec_t * buf, uint16_t size)
+{
+    Lock lock(mutex);
+
+    if((nullptr == buf) || (0U == size))
+    {
+        return XENSIV_PASCO2_ERR_ILLEGAL_ARG;
+    }
+
+    xensiv_pasco2_trace_stop(&dev);
+    xensiv_pasco2_trace_init(&trace, buf, size);
+
+    /* Before begin() there are no transport functions to wrap yet */
+    if(nullptr != dev.read)
+    {
+        xensiv_pasco2_trace_start(&dev, &trace);
+    }
+
+    tracing = true;
+
+    return XENSIV_PASCO2_OK;
+}
+
+/**
+ * @brief       Stops recording the sensor bus transactions
+ * 
+ * @details     The recorded transactions are kept and can be read with 
+ *              readTrace().
+ * 
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK always
+ * @pre         None
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::stopTrace()
+{
+    Lock lock(mutex);
+
+    xensiv_pasco2_trace_stop(&dev);
+    tracing = false;
+
+    return XENSIV_PASCO2_OK;
+}
+
+/**
+ * @brief       Reads a recorded bus transaction
+ * 
+ * @param[in]   index       Record index, 0 being the oldest record in the buffer
+ * @param[out]  rec         Record read
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @retval      XENSIV_PASCO2_READ_NRDY if there is no record at index
+ * @pre         startTrace()
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::readTrace(uint16_t index, TraceRec_t & rec)
+{
+    Lock lock(mutex);
+
+    if(nullptr == trace.buf)
+    {
+        return XENSIV_PASCO2_READ_NRDY;
+    }
+
+    const xensiv_pasco2_trace_rec_t * r = xensiv_pasco2_trace_get(&trace, index);
+
+    if(nullptr == r)
+    {
+        return XENSIV_PASCO2_READ_NRDY;
+    }
+
+    rec = *r;
+
+    return XENSIV_PASCO2_OK;
+}
+
+/**
+ * @brief       Sets the hook of all the driver waits
+ * 
+ * @details     By default the driver blocks in delay() during the 5 ms 
+ *              guard time between register accesses, the 2 s soft reset of 
+ *              begin(), the forced compensation polls, and it 
+ *              spins while waiting for the UART replies. The hook replaces 
+ *              all these waits, so that a scheduler can run other work 
+ *              meanwhile. It must return once at least ms milliseconds have 
+ *              elapsed. A zero ms call is a yield request of a polling loop.
+ * 
+ *              The hook is shared by all the instances and transports.
+ * 
+ *              On FreeRTOS (e.g. ESP32):
+ * 
+ *              @code
+ *              void rtosWait(void * arg, uint32_t ms)
+ *              {
+ *                  vTaskDelay((0U == ms) ? 1 : pdMS_TO_TICKS(ms));
+ *              }
+ * 
+ *              PASCO2Ino::setWaitHook(rtosWait);
+ *              @endcode
+ * 
+ *              On cores with a cooperative yield() the library provides 
+ *              xensiv_pasco2_plat_yield_wait():
+ * 
+ *              @code
+ *              PASCO2Ino::setWaitHook(xensiv_pasco2_plat_yield_wait);
+ *              @endcode
+ * 
+ * @param[in]   hook    Wait hook. nullptr to restore the blocking delay()
+ * @param[in]   arg     User argument passed to the hook
+ * @pre         None
+ */
+template<typename Transport>
+void PASCO2<Transport>::setWaitHook(WaitHook_t hook, void * arg)
+{
+    xensiv_pasco2_plat_set_wait(hook, arg);
+}
+
+/**
+ * @brief       Sets the instance mutex
+ * 
+ * @details     The mutex is taken for the whole duration of each function 
+ *              accessing the sensor, so that the multi-step sequences 
+ *              (e.g. the read and status clear of getCO2(), or the 
+ *              read-modify-write sequences of startMeasure()) of several 
+ *              tasks using the same instance do not interleave.
+ *              begin() does not hold it during the soft reset wait.
+ *              getStats() does not take it.
+ * 
+ *              The mutex does not need to be recursive. It must be set 
+ *              before the tasks using the instance are started.
+ * 
+ *              With FreeRTOS (e.g. ESP32):
+ * 
+ *              @code
+ *              SemaphoreHandle_t sem = xSemaphoreCreateMutex();
+ * 
+ *              void semLock(void * arg)   { xSemaphoreTake((SemaphoreHandle_t)arg, portMAX_DELAY); }
+ *              void semUnlock(void * arg) { xSemaphoreGive((SemaphoreHandle_t)arg); }
+ * 
+ *              Mutex_t mutex = { semLock, semUnlock, sem };
+ * 
+ *              cotwo.setMutex(&mutex);
+ *              @endcode
+ * 
+ * @param[in]   mutex   Instance mutex. Must remain valid while in use. nullptr to disable the locking
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK always
+ * @pre         None
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::setMutex(const Mutex_t * mutex)
+{
+    this->mutex = mutex;
+
+    return XENSIV_PASCO2_OK;
+}
+
+/**
+ * @brief       Sets the mutex of the serial bus of the instance
+ * 
+ * @details     The mutex is taken around every single sensor transfer, 
+ *              and released during the guard time between the transfers.
+ *              It is shared by all the instances on the same TwoWire or 
+ *              HardwareSerial bus. When other drivers use the bus, pass 
+ *              the mutex they already use, so that their transactions 
+ *              do not interleave with the sensor ones.
+ *              It must be set before the tasks using the bus are started.
+ * 
+ * @param[in]   mutex   Bus mutex. Must remain valid while in use. nullptr to remove it
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @retval      XENSIV_PASCO2_ERR_ILLEGAL_ARG if XENSIV_PASCO2_PLAT_BUS_MUTEX_MAX buses already have a mutex
+ * @pre         None
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::setBusMutex(const Mutex_t * mutex)
+{
+    return xensiv_pasco2_plat_set_bus_mutex(transport.bus(), mutex) ? XENSIV_PASCO2_OK : XENSIV_PASCO2_ERR_ILLEGAL_ARG;
+}
+
+/**
+ * @brief       Configures the sensor automatic baseline compensation
+ * 
+ * @param[in]   aboc        Automatic baseline compenstation mode  
+ * @param[in]   abocRef     Automatic baseline compensation reference
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @pre         begin()
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::setABOC(ABOC_t aboc, int16_t abocRef)
+{
+    Lock lock(mutex);
+
+    xensiv_pasco2_measurement_config_t  measConf;
+    int32_t ret = XENSIV_PASCO2_OK; 
+
+    /* Get meas configuration */
+    ret = xensiv_pasco2_get_measurement_config(&dev, &measConf);
+    INO_ASSERT_RET(ret);
+
+    /* Set compensation offset */
+    ret = xensiv_pasco2_set_offset_compensation(&dev, (uint16_t) abocRef);
+    INO_ASSERT_RET(ret);
+
+    /* Set meas configuration with ABOC */
+    measConf.b.boc_cfg = aboc;
+    ret = xensiv_pasco2_set_measurement_config(&dev, measConf);
+
+    return ret;
+}
+
+/**
+ * @brief       Performs force compensation
+ * 
+ * @details     Calculates the offset compensation when the sensor is exposed to a CO2 reference
+ *              value. Blocks for up to XENSIV_PASCO2_FCS_TIMEOUT_MS. On a communication 
+ *              error or on deadline expiry the compensation is aborted as in 
+ *              pollForcedCompensation().
+ * @warning     The device is left in idle mode after the compensation value is stored in
+ *              non-volatile memory. 
+ * 
+ * @param[in]   co2Ref  Automatic baseline compenstation mode  
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @retval      XENSIV_PASCO2_ERR_TIMEOUT if the deadline expired
  * @pre         begin()
  */
-Error_t PASCO2Ino::clearForcedCompensation()
+template<typename Transport>
+Error_t PASCO2<Transport>::performForcedCompensation(uint16_t co2Ref)
+{
+    Lock lock(mutex);
+
+    return xensiv_pasco2_perform_forced_compensation(&dev, co2Ref);
+}
+
+/**
+ * @brief       Starts the force compensation without blocking
+ * 
+ * @details     Non-blocking alternative to performForcedCompensation(). 
+ *              The sensor computes the offset compensation in the background 
+ *              while pollForcedCompensation() is called periodically:
+ * 
+ *              @code
+ *              FCSProgress_t progress;
+ *              cotwo.startForcedCompensation(420);
+ * 
+ *              while(XENSIV_PASCO2_BUSY == cotwo.pollForcedCompensation(progress))
+ *              {
+ *                  // ... do something else ... 
+ *              }
+ *              @endcode
+ * 
+ *              The sensor is accessed at most once every pollMs. If the sensor
+ *              does not complete the compensation within timeoutMs, the procedure 
+ *              is aborted and the device is left in idle mode without storing any 
+ *              offset compensation, and with the automatic baseline compensation
+ *              setting in use before the start.
+ * 
+ * @param[in]   co2Ref      CO2 reference value in ppm
+ * @param[in]   timeoutMs   Procedure deadline in ms. Default is fcsTimeoutMs
+ * @param[in]   pollMs      Sensor state poll interval in ms. Default is fcsPollMs
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if the compensation has been started
+ * @pre         begin()
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::startForcedCompensation(uint16_t co2Ref, uint32_t timeoutMs, uint16_t pollMs)
+{
+    Lock lock(mutex);
+
+    xensiv_pasco2_measurement_config_t measConf;
+
+    /* Restored if the compensation is aborted */
+    int32_t ret = xensiv_pasco2_get_measurement_config(&dev, &measConf);
+
+    if(XENSIV_PASCO2_OK == ret)
+    {
+        fcsBocCfg = (ABOC_t)measConf.b.boc_cfg;
+        ret = xensiv_pasco2_start_forced_compensation(&dev, co2Ref);
+    }
+
+    fcsStart        = (uint32_t)millis();
+    fcsLastPoll     = fcsStart;
+    fcsPoll         = pollMs;
+    fcs.state       = (XENSIV_PASCO2_OK == ret) ? FCS_RUNNING : FCS_FAILED;
+    fcs.elapsedMs   = 0;
+    fcs.timeoutMs   = timeoutMs;
+    fcs.polls       = 0;
+    fcsStatus       = (XENSIV_PASCO2_OK == ret) ? XENSIV_PASCO2_BUSY : ret;
+
+    return ret;
+}
+
+/**
+ * @brief       Polls the non-blocking force compensation
+ * 
+ * @details     Checks the sensor state if the poll interval has elapsed. 
+ *              Once the sensor completes the compensation, the device is set 
+ *              in idle mode and the offset compensation value is stored in 
+ *              non-volatile memory.
+ * 
+ * @param[out]  progress    Procedure progress
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if the compensation is completed and stored
+ * @retval      XENSIV_PASCO2_BUSY if the compensation is still running
+ * @retval      XENSIV_PASCO2_ERR_TIMEOUT if the deadline expired
+ * @pre         startForcedCompensation()
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::pollForcedCompensation(FCSProgress_t & progress)
 {
+    Lock lock(mutex);
+
+    if(XENSIV_PASCO2_BUSY == fcsStatus)
+    {
+        uint32_t now = (uint32_t)millis();
+        fcs.elapsedMs = now - fcsStart;
+
+        if((now - fcsLastPoll) >= fcsPoll)
+        {
+            fcsLastPoll = now;
+            fcs.polls++;
+
+            /* Communication errors are retried until the deadline */
+            if(XENSIV_PASCO2_OK == xensiv_pasco2_get_forced_compensation_state(&dev))
+            {
+                fcsStatus = xensiv_pasco2_finish_forced_compensation(&dev);
+            }
+        }
+
+        if((XENSIV_PASCO2_BUSY == fcsStatus) && (fcs.elapsedMs >= fcs.timeoutMs))
+        {
+            /* Abort the compensation without storing the offset */
+            (void)xensiv_pasco2_abort_forced_compensation(&dev, fcsBocCfg);
+
+            fcsStatus = XENSIV_PASCO2_ERR_TIMEOUT;
+        }
+
+        if(XENSIV_PASCO2_BUSY != fcsStatus)
+        {
+            fcs.state = (XENSIV_PASCO2_OK == fcsStatus) ? FCS_DONE : FCS_FAILED;
+        }
+    }
+
+    progress = fcs;
+
+    return fcsStatus;
+}
+
+/**
+ * @brief       Resets the forced calibration correction factor
+ * 
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @pre         begin()
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::clearForcedCompensation()
+{
+    Lock lock(mutex);
+
     return xensiv_pasco2_cmd(&dev, XENSIV_PASCO2_CMD_RESET_FCS);
 }
 
@@ -552,8 +1375,11 @@ Error_t PASCO2Ino::clearForcedCompensation()
  * @retval      XENSIV_PASCO2_OK if success
  * @pre         begin()
  */
-Error_t PASCO2Ino::setPressRef(uint16_t pressRef)
+template<typename Transport>
+Error_t PASCO2<Transport>::setPressRef(uint16_t pressRef)
 {
+    Lock lock(mutex);
+
     int32_t ret = XENSIV_PASCO2_OK; 
 
     ret = xensiv_pasco2_set_pressure_compensation(&dev, pressRef);
@@ -568,8 +1394,11 @@ Error_t PASCO2Ino::setPressRef(uint16_t pressRef)
  * @retval      XENSIV_PASCO2_OK if success
  * @pre         begin()
  */
-Error_t PASCO2Ino::reset()
+template<typename Transport>
+Error_t PASCO2<Transport>::reset()
 {
+    Lock lock(mutex);
+
     int32_t ret = XENSIV_PASCO2_OK; 
 
     ret = xensiv_pasco2_cmd(&dev, XENSIV_PASCO2_CMD_SOFT_RESET);
@@ -578,6 +1407,65 @@ Error_t PASCO2Ino::reset()
     return ret;
 }
 
+/**
+ * @brief       Starts a configuration transaction
+ * 
+ * @details     Until commit() is called, the measurement rate, measurement 
+ *              configuration, interrupt configuration, alarm threshold, 
+ *              pressure reference and calibration reference written by 
+ *              startMeasure(), stopMeasure(), setMeasRate(), setABOC(), 
+ *              setPressRef() or setRegister() are only staged in the instance.
+ *              commit() then writes the changed registers in one or two
+ *              bursts, instead of one padded access per register:
+ * 
+ *              @code
+ *              cotwo.beginConfig();
+ *              cotwo.setPressRef(900);
+ *              cotwo.startMeasure(60, 1200);
+ *              cotwo.commit();
+ *              @endcode
+ * 
+ *              The status clearing of getCO2() and getDiagnosis() and the
+ *              reset commands are not staged.
+ * 
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK always
+ * @pre         begin()
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::beginConfig()
+{
+    Lock lock(mutex);
+
+    xensiv_pasco2_begin_config(&dev);
+
+    return XENSIV_PASCO2_OK;
+}
+
+/**
+ * @brief       Commits the configuration transaction 
+ * 
+ * @details     Writes only the registers changed since beginConfig().
+ *              The interrupt configuration, alarm threshold and references
+ *              are written first, and the measurement rate and measurement 
+ *              configuration last, so that the new operation mode starts with
+ *              the complete configuration. The sensor is set to idle mode 
+ *              first if the measurement rate or the operation mode changes.
+ *              With the shadow register cache enabled, unchanged registers
+ *              in between are written along to merge the bursts.
+ * 
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @pre         beginConfig()
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::commit()
+{
+    Lock lock(mutex);
+
+    return xensiv_pasco2_commit_config(&dev);
+}
+
 /**
  * @brief       Gets device product identifier 
  *  
@@ -587,8 +1475,11 @@ Error_t PASCO2Ino::reset()
  * @retval      XENSIV_PASCO2_OK if success
  * @pre         begin()
  */
-Error_t PASCO2Ino::getDeviceID(uint8_t & prodID, uint8_t & revID)
+template<typename Transport>
+Error_t PASCO2<Transport>::getDeviceID(uint8_t & prodID, uint8_t & revID)
 {
+    Lock lock(mutex);
+
     int32_t ret = XENSIV_PASCO2_OK; 
     xensiv_pasco2_id_t id;
     
@@ -601,6 +1492,73 @@ Error_t PASCO2Ino::getDeviceID(uint8_t & prodID, uint8_t & revID)
     return ret;
 }
 
+/**
+ * @brief       Enables the UART pipelined register access
+ * 
+ * @details     Multi-register reads send all the register read frames 
+ *              back to back and then parse the replies as they stream in,
+ *              instead of one round trip per register.
+ *              Multi-register writes (i.e. measurement rate, alarm threshold)
+ *              send all the write frames back to back and collect the 
+ *              acknowledges afterwards.
+ *              The setting is kept across begin() calls. It has no effect 
+ *              for the I2C interface, where multi-register reads are already 
+ *              a single transfer.
+ * 
+ * @param[in]   enable  True to enable the pipelined access. Disabled by default
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK always
+ * @pre         None
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::setUARTPipelining(bool enable)
+{
+    Lock lock(mutex);
+
+    uartPipelined = enable;
+
+    if((nullptr != transport.serial()) && (nullptr != dev.read))
+    {
+        xensiv_pasco2_set_uart_pipelining(&dev, uartPipelined);
+    }
+
+    return XENSIV_PASCO2_OK;
+}
+
+/**
+ * @brief       Enables the shadow register cache
+ * 
+ * @details     A copy of the configuration registers written by the host 
+ *              is kept in the instance. The read-modify-write sequences of 
+ *              startMeasure(), stopMeasure(), setABOC() and begin() are then 
+ *              served from the copy, and only the writes access the bus.
+ *              The cache is invalidated by reset() and by any soft reset 
+ *              written with setRegister(). The measurement configuration
+ *              is read from the device while a single shot measurement
+ *              or a forced compensation is in progress, as the sensor
+ *              changes it on its own.
+ *              The setting is kept across begin() calls. 
+ * 
+ * @param[in]   enable  True to enable the cache. Disabled by default
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK always
+ * @pre         None
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::setShadowCache(bool enable)
+{
+    Lock lock(mutex);
+
+    shadowCache = enable;
+
+    if(nullptr != dev.read)
+    {
+        xensiv_pasco2_set_shadow(&dev, shadowCache);
+    }
+
+    return XENSIV_PASCO2_OK;
+}
+
 /**
  * @brief       Reads from the sensor device into the given data buffer
  *  
@@ -611,8 +1569,11 @@ Error_t PASCO2Ino::getDeviceID(uint8_t & prodID, uint8_t & revID)
  * @retval      XENSIV_PASCO2_OK if success
  * @pre         begin()
  */
-Error_t PASCO2Ino::getRegister(uint8_t regAddr, uint8_t * data, uint8_t len)
+template<typename Transport>
+Error_t PASCO2<Transport>::getRegister(uint8_t regAddr, uint8_t * data, uint8_t len)
 {
+    Lock lock(mutex);
+
     return xensiv_pasco2_get_reg(&dev, regAddr, data, len);
 }
 
@@ -626,7 +1587,238 @@ Error_t PASCO2Ino::getRegister(uint8_t regAddr, uint8_t * data, uint8_t len)
  * @retval      XENSIV_PASCO2_OK if success
  * @pre         begin()
  */
-Error_t PASCO2Ino::setRegister(uint8_t regAddr, const uint8_t * data, uint8_t len)
+template<typename Transport>
+Error_t PASCO2<Transport>::setRegister(uint8_t regAddr, const uint8_t * data, uint8_t len)
 {
+    Lock lock(mutex);
+
     return xensiv_pasco2_set_reg(&dev, regAddr, data, len);
-}
\ No newline at end of file
+}
+
+/**
+ * @brief       Starts a non-blocking register read
+ * 
+ * @details     Over UART, the register read frames are sent and the function
+ *              returns without waiting for the replies. The replies are collected 
+ *              by calling pollRegister() until it does not return XENSIV_PASCO2_BUSY.
+ *              Each reply has its own deadline, driven by millis().
+ *              Over I2C, the registers are read right away and pollRegister() 
+ *              returns the transfer result.
+ *              
+ *              @code
+ *              uint8_t co2[2];
+ *              
+ *              cotwo.requestRegister(XENSIV_PASCO2_REG_CO2PPM_H, co2, 2);
+ *              
+ *              while(XENSIV_PASCO2_BUSY == cotwo.pollRegister())
+ *              {
+ *                  // ... service other peripherals ...
+ *              }
+ *              @endcode
+ * 
+ *              No other function of the instance must be called while
+ *              the request is pending.
+ * 
+ * @param[in]   regAddr Start register address
+ * @param[out]  data    Pointer to the data buffer to store the register values.
+ *                      It must remain valid until the request completes
+ * @param[in]   len     Number of bytes of data to be read
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if the request has been started
+ * @retval      XENSIV_PASCO2_BUSY if a previous request is still pending
+ * @pre         begin()
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::requestRegister(uint8_t regAddr, uint8_t * data, uint8_t len)
+{
+    Lock lock(mutex);
+
+    int32_t ret = XENSIV_PASCO2_OK;
+
+    if(XENSIV_PASCO2_BUSY == reqStatus)
+    {
+        return XENSIV_PASCO2_BUSY;
+    }
+
+    if(nullptr != transport.serial())
+    {
+        ret = xensiv_pasco2_uart_read_request(&dev, regAddr, len);
+        INO_ASSERT_RET(ret);
+
+        reqData   = data;
+        reqLen    = len;
+        reqIdx    = 0;
+        reqStatus = XENSIV_PASCO2_BUSY;
+
+        xensiv_pasco2_plat_uart_rx_start(&rxReq, transport.serial(), rxReply, sizeof(rxReply), XENSIV_PASCO2_UART_TIMEOUT_MS);
+    }
+    else
+    {
+        reqStatus = xensiv_pasco2_get_reg(&dev, regAddr, data, len);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief       Pumps a non-blocking register read
+ * 
+ * @details     Decodes the register replies received so far and checks the 
+ *              reply deadline. It never waits for the UART.
+ * 
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if the request has completed successfully
+ * @retval      XENSIV_PASCO2_BUSY if the request is still pending
+ * @retval      XENSIV_PASCO2_ERR_COMM if a reply has not been received in time
+ * @pre         requestRegister()
+ */
+template<typename Transport>
+Error_t PASCO2<Transport>::pollRegister()
+{
+    Lock lock(mutex);
+
+    /* I2C requests complete in requestRegister() */
+    if(nullptr == transport.serial())
+    {
+        return reqStatus;
+    }
+
+    while(XENSIV_PASCO2_BUSY == reqStatus)
+    {
+        int32_t ret = xensiv_pasco2_plat_uart_rx_poll(&rxReq);
+
+        if(XENSIV_PASCO2_BUSY == ret)
+        {
+            break;
+        }
+
+        if(XENSIV_PASCO2_OK == ret)
+        {
+            ret = xensiv_pasco2_uart_read_reply(&dev, rxReply, &reqData[reqIdx]);
+        }
+
+        if(XENSIV_PASCO2_OK != ret)
+        {
+            reqStatus = ret;
+        }
+        else if(++reqIdx == reqLen)
+        {
+            reqStatus = XENSIV_PASCO2_OK;
+        }
+        else
+        {
+            xensiv_pasco2_plat_uart_rx_start(&rxReq, transport.serial(), rxReply, sizeof(rxReply), XENSIV_PASCO2_UART_TIMEOUT_MS);
+        }
+    }
+
+    return reqStatus;
+}
+
+/**
+ * @brief   Begins the I2C interface
+ * 
+ * @details The sensor is not accessed. The soft reset is triggered by
+ *          the caller with xensiv_pasco2_reset_start()
+ * 
+ * @param[inout] dev    Corelib object to initialize
+ * @return  XENSIV™ PAS CO2 error code
+ * @retval  XENSIV_PASCO2_OK always
+ */
+int32_t PASCO2I2C::begin(xensiv_pasco2_t * dev)
+{
+    #ifndef PAS_CO2_SERIAL_PAL_INIT_EXTERNAL
+    wire->begin();
+    wire->setClock(freqHz);
+    #endif 
+
+    xensiv_pasco2_bind_i2c(dev, wire);
+
+    return XENSIV_PASCO2_OK;
+}
+
+/**
+ * @brief   Ends the I2C interface
+ */
+void PASCO2I2C::end()
+{
+    #ifndef PAS_CO2_SERIAL_PAL_INIT_EXTERNAL
+    #if !defined(ARDUINO_ARCH_ESP32)
+    wire->end();
+    #endif
+    #endif
+}
+
+/**
+ * @brief   Begins the UART interface
+ * 
+ * @details The sensor is not accessed. The soft reset is triggered by
+ *          the caller with xensiv_pasco2_reset_start()
+ * 
+ * @param[inout] dev    Corelib object to initialize
+ * @return  XENSIV™ PAS CO2 error code
+ * @retval  XENSIV_PASCO2_OK always
+ */
+int32_t PASCO2UART::begin(xensiv_pasco2_t * dev)
+{
+    #ifndef PAS_CO2_SERIAL_PAL_INIT_EXTERNAL
+    uart->begin(baudrateBps);   
+    #endif
+
+    xensiv_pasco2_bind_uart(dev, uart);
+
+    return XENSIV_PASCO2_OK;
+}
+
+/**
+ * @brief   Ends the UART interface
+ */
+void PASCO2UART::end()
+{
+    #ifndef PAS_CO2_SERIAL_PAL_INIT_EXTERNAL
+    uart->end();
+    #endif
+}
+
+/**
+ * @brief   Begins the selected interface
+ * 
+ * @param[inout] dev    Corelib object to initialize
+ * @return  XENSIV™ PAS CO2 error code
+ * @retval  XENSIV_PASCO2_OK if an interface is selected
+ */
+int32_t PASCO2Dual::begin(xensiv_pasco2_t * dev)
+{
+    if(nullptr != wire)
+    {
+        return PASCO2I2C(wire).begin(dev);
+    }
+    else if(nullptr != uart)
+    {
+        return PASCO2UART(uart).begin(dev);
+    }
+
+    return XENSIV_PASCO2_ERR_COMM;
+}
+
+/**
+ * @brief   Ends the selected interface
+ */
+void PASCO2Dual::end()
+{
+    if(nullptr != wire)
+    {
+        PASCO2I2C(wire).end();
+    }
+    else if(nullptr != uart)
+    {
+        PASCO2UART(uart).end();
+    }
+}
+
+/**
+ * The member functions are compiled once per transport. The linker only keeps
+ * the ones of the transports used by the application.
+ */
+template class PASCO2<PASCO2I2C>;
+template class PASCO2<PASCO2UART>;
+template class PASCO2<PASCO2Dual>;
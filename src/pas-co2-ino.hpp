@@ -13,6 +13,9 @@
 #include <Wire.h>
 #include <HardwareSerial.h>
 #include "pas-co2-platf-ino.hpp"
+#include "pas-co2-pal-ino.hpp"
+#include "pas-co2-ring-ino.hpp"
+#include "pas-co2-transport-ino.hpp"
 #include "xensiv_pasco2.h"
 
 /**
@@ -23,44 +26,214 @@
 typedef int32_t Error_t;
 typedef xensiv_pasco2_status_t Diag_t;
 typedef xensiv_pasco2_boc_cfg_t ABOC_t;
+typedef xensiv_pasco2_snapshot_t Snapshot_t;
+typedef xensiv_pasco2_stats_t Stats_t;
+typedef xensiv_pasco2_trace_rec_t TraceRec_t;
+typedef xensiv_pasco2_plat_wait_t WaitHook_t;
+typedef xensiv_pasco2_plat_mutex_t Mutex_t;
 
-class PASCO2Ino
+/**
+ * @brief   Forced compensation procedure state
+ */
+typedef enum
+{
+    FCS_IDLE = 0,       /**< No forced compensation started */
+    FCS_RUNNING,        /**< Sensor computing the offset compensation */
+    FCS_DONE,           /**< Offset compensation stored in non-volatile memory */
+    FCS_FAILED          /**< Forced compensation aborted on error or deadline expiry */
+} FCSState_t;
+
+/**
+ * @brief   Forced compensation procedure progress
+ */
+typedef struct
+{
+    FCSState_t  state;      /**< Procedure state */
+    uint32_t    elapsedMs;  /**< Time elapsed since the procedure start in ms */
+    uint32_t    timeoutMs;  /**< Procedure deadline in ms */
+    uint16_t    polls;      /**< Number of sensor state polls performed */
+} FCSProgress_t;
+
+/**
+ * @brief   Acquired CO2 sample
+ */
+typedef struct
+{
+    uint32_t    timestamp;  /**< Acquisition time in ms */
+    int16_t     co2PPM;     /**< CO2 concentration in ppm */
+    uint8_t     measStatus; /**< Measurement status register (MEAS_STS) */
+    uint8_t     sensStatus; /**< Sensor status register (SENS_STS) */
+    uint16_t    seq;        /**< Sample sequence number */
+} Sample_t;
+
+/**
+ * @brief   Sample ring buffer for PASCO2Ino::service()
+ * @tparam  N   Capacity. Power of two, up to 128
+ */
+template<uint8_t N>
+using PASCO2SampleRing = PASCO2Ring<Sample_t, N>;
+
+/**
+ * @brief   XENSIV™ PAS CO2 Arduino API
+ * 
+ * @details The serial interface is selected at compile time by the
+ *          transport, so that only its protocol is linked:
+ *          - PASCO2I2C for I2C
+ *          - PASCO2UART for UART
+ *          - PASCO2Dual to select the interface at run time (PASCO2Ino)
+ * 
+ * @tparam  Transport   PASCO2I2C, PASCO2UART or PASCO2Dual
+ */
+template<typename Transport>
+class PASCO2
 {
     public:
 
         static constexpr uint8_t       unusedPin = 0xFFU; /**< Unused pin */        
+        static constexpr uint32_t      fcsTimeoutMs = XENSIV_PASCO2_FCS_TIMEOUT_MS; /**< Default forced compensation deadline in ms */
+        static constexpr uint16_t      fcsPollMs    = 1000U;   /**< Default forced compensation poll interval in ms */
+        static constexpr uint8_t       maxIsrInst   = 4U;      /**< Maximum instances with interrupt-driven acquisition */
+
+                PASCO2 (Transport bus = Transport(), uint8_t intPin = unusedPin);
+                ~PASCO2();
+
+        /* The destructor releases the interrupt slot of the instance */
+                PASCO2 (const PASCO2 &) = delete;
+        PASCO2 & operator=(const PASCO2 &) = delete;
 
-                PASCO2Ino (TwoWire * wire = &Wire, uint8_t intPin = unusedPin);
-                PASCO2Ino (HardwareSerial * serial, uint8_t intPin = unusedPin);
-                ~PASCO2Ino();
+        Error_t init            (Transport bus);
         Error_t begin           ();
+        Error_t beginAsync      ();
+        Error_t poll            ();
         Error_t end             ();
         Error_t startMeasure    (int16_t  periodInSec = 0, int16_t alarmTh = 0, void (*cback) (void *) = nullptr, bool earlyNotification = false);
         Error_t stopMeasure     ();
+        Error_t setMeasRate     (int16_t  periodInSec);
+        Error_t startAcquisition(int16_t  periodInSec = 0);
+        Error_t service         (Sample_t & sample);
+        template<uint8_t N>
+        Error_t service         (PASCO2SampleRing<N> & ring);
         Error_t getCO2          (int16_t & CO2PPM);
         Error_t getDiagnosis    (Diag_t & diagnosis);
+        Error_t readSnapshot    (Snapshot_t & snapshot);
+        Error_t getStats        (Stats_t & stats);
+        Error_t resetStats      ();
+        Error_t startTrace      (TraceRec_t * buf, uint16_t size);
+        Error_t stopTrace       ();
+        Error_t readTrace       (uint16_t index, TraceRec_t & rec);
+        static void setWaitHook (WaitHook_t hook, void * arg = nullptr);
+        Error_t setMutex        (const Mutex_t * mutex);
+        Error_t setBusMutex     (const Mutex_t * mutex);
         Error_t setABOC         (ABOC_t aboc, int16_t abocRef);
         Error_t setPressRef     (uint16_t pressRef);
         Error_t performForcedCompensation(uint16_t co2Ref);
+        Error_t startForcedCompensation  (uint16_t co2Ref, uint32_t timeoutMs = fcsTimeoutMs, uint16_t pollMs = fcsPollMs);
+        Error_t pollForcedCompensation   (FCSProgress_t & progress);
         Error_t clearForcedCompensation  ();
         Error_t reset           ();
+        Error_t beginConfig     ();
+        Error_t commit          ();
         Error_t getDeviceID     (uint8_t & prodID, uint8_t & revID);
+        Error_t setUARTPipelining(bool enable);
+        Error_t setShadowCache  (bool enable);
 
         Error_t getRegister     (uint8_t regAddr, uint8_t * data, uint8_t len);
         Error_t setRegister     (uint8_t regAddr, const uint8_t * data, uint8_t len);
 
+        Error_t requestRegister (uint8_t regAddr, uint8_t * data, uint8_t len);
+        Error_t pollRegister    ();
+
     private:
 
-        TwoWire         * i2c;          /**< I2C interface*/
-        HardwareSerial  * uart;         /**< UART interface */   
+        Transport         transport;    /**< Serial interface transport */
         uint8_t           intPin;       /**< Interrupt pin */
-
-        static constexpr uint16_t baudrateBps = 9600;      /**< UART baud rate in bps */
-        static constexpr uint32_t freqHz      = 100000;    /**< I2C frequency in Hz*/
+        bool              uartPipelined;/**< UART pipelined register access enabled */
+        bool              shadowCache;  /**< Shadow register cache enabled */
+        bool              resetPending; /**< Asynchronous begin waiting for the sensor soft reset */
+        uint32_t          resetStart;   /**< Asynchronous begin soft reset time in ms */
+        int32_t           resetStatus;  /**< Asynchronous begin status returned by poll() */
 
         xensiv_pasco2_t   dev;          /**< XENSIV™ PAS CO2 corelib object */
+
+        xensiv_pasco2_plat_uart_rx_t rxReq;                             /**< UART non-blocking receive request */
+        uint8_t           rxReply[XENSIV_PASCO2_UART_READ_REPLY_LEN];   /**< UART register read reply */
+        uint8_t         * reqData;      /**< Non-blocking read data buffer */
+        uint8_t           reqLen;       /**< Non-blocking read length */
+        uint8_t           reqIdx;       /**< Non-blocking read registers completed */
+        int32_t           reqStatus;    /**< Non-blocking read status */
+
+        FCSProgress_t     fcs;          /**< Forced compensation progress */
+        int32_t           fcsStatus;    /**< Forced compensation status */
+        uint32_t          fcsStart;     /**< Forced compensation start time in ms */
+        uint32_t          fcsLastPoll;  /**< Forced compensation last poll time in ms */
+        uint16_t          fcsPoll;      /**< Forced compensation poll interval in ms */
+        ABOC_t            fcsBocCfg;    /**< Automatic baseline compensation setting restored on abort */
+
+        volatile bool     dataReady;    /**< Data ready interrupt flag */
+        uint8_t           isrSlot;      /**< Interrupt trampoline slot */
+        uint16_t          sampleSeq;    /**< Next sample sequence number */
+
+        xensiv_pasco2_trace_t trace;    /**< Bus transaction trace recorder */
+        bool              tracing;      /**< Bus transaction tracing enabled */
+
+        const Mutex_t   * mutex;        /**< Instance mutex. nullptr if unused */
+
+        /**
+         * @brief   Scoped instance lock
+         */
+        class Lock
+        {
+            public:
+                Lock(const Mutex_t * mutex) : mutex(mutex) { if(nullptr != mutex) { mutex->lock(mutex->arg); } }
+                ~Lock() { if(nullptr != mutex) { mutex->unlock(mutex->arg); } }
+            private:
+                const Mutex_t * mutex;
+        };
+
+        Error_t            finishReset();
+        Error_t            setIdleMode();
+        void               releaseInterrupt();
+
+        static PASCO2   * isrInst[maxIsrInst];   /**< Instances per interrupt trampoline slot */
+        template<uint8_t I>
+        static void        dataReadyISR();
 };
 
+/**
+ * @brief   XENSIV™ PAS CO2 Arduino API on I2C or UART, selected by the constructor argument
+ */
+typedef PASCO2<PASCO2Dual> PASCO2Ino;
+
+/**
+ * @brief       Services the acquisition into a ring buffer
+ * 
+ * @details     Same as service(Sample_t &), but the new sample is pushed 
+ *              into the ring buffer. If the ring is full, the sample is 
+ *              dropped and counted in the ring dropped() counter, and the 
+ *              call still returns XENSIV_PASCO2_OK: the sample has been 
+ *              read out of the sensor either way. 
+ * 
+ * @param[in]   ring    Sample ring buffer
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if a new sample has been read, pushed or dropped
+ * @retval      XENSIV_PASCO2_READ_NRDY if no new sample is available
+ * @pre         startAcquisition()
+ */
+template<typename Transport>
+template<uint8_t N>
+Error_t PASCO2<Transport>::service(PASCO2SampleRing<N> & ring)
+{
+    Sample_t sample;
+    int32_t ret = service(sample);
+
+    if(XENSIV_PASCO2_OK == ret)
+    {
+        (void)ring.push(sample);
+    }
+
+    return ret;
+}
+
 /** @} */
 
 #endif /** PAS_CO2_INO_HPP_ **/
\ No newline at end of file
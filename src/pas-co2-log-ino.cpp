@@ -0,0 +1,526 @@
+/**
+ * @file        pas-co2-log-ino.cpp
+ * @brief       XENSIV™ PAS CO2 Arduino Persistent Log
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "pas-co2-log-ino.hpp"
+
+/**
+ * @brief       Page header layout
+ */
+#define LOG_HDR_MAGIC           (0U)    /**< Magic number, 2 bytes */
+#define LOG_HDR_SEQ             (2U)    /**< Page sequence number, 4 bytes */
+#define LOG_HDR_CRC             (6U)    /**< CRC-16 of the header, 2 bytes */
+
+/**
+ * @brief       Record layout
+ */
+#define LOG_REC_TYPE            (0U)    /**< Record type, 1 byte */
+#define LOG_REC_CODE            (1U)    /**< Sensor status or event code, 1 byte */
+#define LOG_REC_VALUE           (2U)    /**< CO2 concentration or event argument, 2 bytes */
+#define LOG_REC_TIME            (4U)    /**< Timestamp in ms, 4 bytes */
+#define LOG_REC_BOOT            (8U)    /**< Boot number, 2 bytes */
+#define LOG_REC_CRC             (10U)   /**< CRC-16 of the record, 2 bytes */
+
+/**
+ * @brief       Page header magic number, "PL"
+ */
+#define LOG_MAGIC               (0x4C50U)
+
+static void putLE(uint8_t * p, uint32_t v, uint8_t len)
+{
+    for(uint8_t i = 0; i < len; i++)
+    {
+        p[i] = (uint8_t)(v >> (8U * i));
+    }
+}
+
+static uint32_t getLE(const uint8_t * p, uint8_t len)
+{
+    uint32_t v = 0;
+
+    for(uint8_t i = len; i > 0U; i--)
+    {
+        v = (v << 8) | p[i - 1U];
+    }
+
+    return v;
+}
+
+/**
+ * @brief       Persistent log constructor
+ *
+ * @param[in]   store   Page storage. It must outlive the log
+ * @pre         None
+ */
+PASCO2Log::PASCO2Log(const LogStore_t * store)
+: store(store), head(0), headSeq(0), slot(0), used(0), bootNum(0), torn(0)
+{
+    perPage = (uint16_t)((store->pageSize - headerLen) / recLen);
+}
+
+/**
+ * @brief       CRC-16/CCITT-FALSE
+ *
+ * @details     Polynomial 0x1021, initial value 0xFFFF. Computed bitwise,
+ *              a 12 byte record does not need a table.
+ *
+ * @param[in]   data    Data
+ * @param[in]   len     Data length in bytes
+ * @return      CRC of the data
+ * @pre         None
+ */
+uint16_t PASCO2Log::crc16(const uint8_t * data, uint16_t len)
+{
+    uint16_t crc = 0xFFFFU;
+
+    for(uint16_t i = 0; i < len; i++)
+    {
+        crc ^= (uint16_t)((uint16_t)data[i] << 8);
+
+        for(uint8_t b = 0; b < 8U; b++)
+        {
+            crc = (0U != (crc & 0x8000U)) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/**
+ * @brief       Recovers the log
+ *
+ * @details     Finds the last written page from the page headers, the pages
+ *              in use by walking back the consecutive sequence numbers, and
+ *              the next free record by scanning the last page. Torn records
+ *              are counted and skipped. A storage without any valid page is
+ *              formatted.
+ *
+ *              The boot number is incremented from the last record, and a
+ *              boot record holding the number of torn records found is
+ *              appended.
+ *
+ *              The scan reads pages * 8 bytes of headers and one page of
+ *              records at most.
+ *
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @retval      XENSIV_PASCO2_ERR_COMM if the storage failed
+ * @pre         None
+ */
+Error_t PASCO2Log::begin()
+{
+    Error_t  res;
+    uint32_t seq;
+    bool     valid;
+    bool     found = false;
+
+    used    = 0;
+    torn    = 0;
+    bootNum = 0;
+
+    for(uint16_t p = 0; p < store->pages; p++)
+    {
+        res = readHeader(p, seq, valid);
+        if(XENSIV_PASCO2_OK != res)
+        {
+            return res;
+        }
+
+        if(valid && (!found || (seq > headSeq)))
+        {
+            head    = p;
+            headSeq = seq;
+            found   = true;
+        }
+    }
+
+    if(!found)
+    {
+        res = format();
+    }
+    else
+    {
+        LogRec_t rec;
+        Slot_t   state = SLOT_ERASED;
+        uint16_t last  = 0;
+        uint16_t page  = head;
+
+        /* Pages in use, back from the last one */
+        used = 1;
+        while(used < store->pages)
+        {
+            uint16_t prev = (uint16_t)((page + store->pages - 1U) % store->pages);
+
+            res = readHeader(prev, seq, valid);
+            if(XENSIV_PASCO2_OK != res)
+            {
+                return res;
+            }
+
+            if(!valid || (seq != (headSeq - used)))
+            {
+                break;
+            }
+
+            page = prev;
+            used++;
+        }
+
+        /* Next free record of the last page */
+        for(slot = 0; slot < perPage; slot++)
+        {
+            res = readSlot(head, slot, rec, state);
+            if(XENSIV_PASCO2_OK != res)
+            {
+                return res;
+            }
+
+            if(SLOT_ERASED == state)
+            {
+                break;
+            }
+            else if(SLOT_VALID == state)
+            {
+                last = rec.boot;
+            }
+            else
+            {
+                torn++;
+            }
+        }
+
+        /* Boot number of the last record, from the previous page if none yet */
+        if((0U == last) && (used > 1U))
+        {
+            uint16_t prev = (uint16_t)((head + store->pages - 1U) % store->pages);
+
+            for(uint16_t i = perPage; (i > 0U) && (0U == last); i--)
+            {
+                res = readSlot(prev, (uint16_t)(i - 1U), rec, state);
+                if(XENSIV_PASCO2_OK != res)
+                {
+                    return res;
+                }
+
+                last = (SLOT_VALID == state) ? rec.boot : 0U;
+            }
+        }
+
+        bootNum = last;
+    }
+
+    if(XENSIV_PASCO2_OK == res)
+    {
+        LogRec_t rec;
+
+        rec.type      = LOG_BOOT;
+        rec.code      = 0;
+        rec.value     = (int16_t)torn;
+        rec.timestamp = (uint32_t)millis();
+
+        bootNum++;
+        res = append(rec);
+    }
+
+    return res;
+}
+
+/**
+ * @brief       Erases the log
+ *
+ * @details     Erases all the pages, then opens the first one. The boot
+ *              number is kept.
+ *
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @retval      XENSIV_PASCO2_ERR_COMM if the storage failed
+ * @pre         None
+ */
+Error_t PASCO2Log::format()
+{
+    used = 0;
+
+    for(uint16_t p = 0; p < store->pages; p++)
+    {
+        if(XENSIV_PASCO2_OK != store->erase(store->arg, p))
+        {
+            return XENSIV_PASCO2_ERR_COMM;
+        }
+    }
+
+    return openPage(0, 1U);
+}
+
+/**
+ * @brief       Appends a record
+ *
+ * @details     When the last page is full, the next page is erased, the
+ *              oldest one once the log has wrapped, and opened. The boot
+ *              number of the record is set. A record slot is used even if
+ *              the write fails, as it may have been partly written.
+ *
+ * @param[inout] rec    Record to append
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @retval      XENSIV_PASCO2_ERR_COMM if the storage failed
+ * @retval      XENSIV_PASCO2_ERR_NOT_READY if the log is not begun
+ * @pre         begin()
+ */
+Error_t PASCO2Log::append(LogRec_t & rec)
+{
+    uint8_t buf[recLen];
+
+    if(0U == used)
+    {
+        return XENSIV_PASCO2_ERR_NOT_READY;
+    }
+
+    if(slot >= perPage)
+    {
+        Error_t res = openPage((uint16_t)((head + 1U) % store->pages), headSeq + 1U);
+        if(XENSIV_PASCO2_OK != res)
+        {
+            return res;
+        }
+    }
+
+    rec.boot = bootNum;
+
+    putLE(&buf[LOG_REC_TYPE], rec.type, 1U);
+    putLE(&buf[LOG_REC_CODE], rec.code, 1U);
+    putLE(&buf[LOG_REC_VALUE], (uint16_t)rec.value, 2U);
+    putLE(&buf[LOG_REC_TIME], rec.timestamp, 4U);
+    putLE(&buf[LOG_REC_BOOT], rec.boot, 2U);
+    putLE(&buf[LOG_REC_CRC], crc16(buf, LOG_REC_CRC), 2U);
+
+    uint32_t addr = slotAddr(head, slot);
+    slot++;
+
+    return (XENSIV_PASCO2_OK == store->write(store->arg, addr, buf, recLen)) ? XENSIV_PASCO2_OK : XENSIV_PASCO2_ERR_COMM;
+}
+
+/**
+ * @brief       Logs a result
+ *
+ * @param[in]   co2PPM      CO2 concentration in ppm
+ * @param[in]   diag        Sensor status flags
+ * @param[in]   timestamp   Result time in ms
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @retval      XENSIV_PASCO2_ERR_COMM if the storage failed
+ * @retval      XENSIV_PASCO2_ERR_NOT_READY if the log is not begun
+ * @pre         begin()
+ */
+Error_t PASCO2Log::logSample(int16_t co2PPM, Diag_t diag, uint32_t timestamp)
+{
+    LogRec_t rec;
+
+    rec.type      = LOG_SAMPLE;
+    rec.code      = diag.u;
+    rec.value     = co2PPM;
+    rec.timestamp = timestamp;
+
+    return append(rec);
+}
+
+/**
+ * @brief       Logs a result timestamped with millis()
+ *
+ * @param[in]   co2PPM      CO2 concentration in ppm
+ * @param[in]   diag        Sensor status flags
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @retval      XENSIV_PASCO2_ERR_COMM if the storage failed
+ * @retval      XENSIV_PASCO2_ERR_NOT_READY if the log is not begun
+ * @pre         begin()
+ */
+Error_t PASCO2Log::logSample(int16_t co2PPM, Diag_t diag)
+{
+    return logSample(co2PPM, diag, (uint32_t)millis());
+}
+
+/**
+ * @brief       Logs a sample of the acquisition service
+ *
+ * @param[in]   sample      Sample from PASCO2::service()
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @retval      XENSIV_PASCO2_ERR_COMM if the storage failed
+ * @retval      XENSIV_PASCO2_ERR_NOT_READY if the log is not begun
+ * @pre         begin()
+ */
+Error_t PASCO2Log::logSample(const Sample_t & sample)
+{
+    Diag_t diag;
+
+    diag.u = sample.sensStatus;
+
+    return logSample(sample.co2PPM, diag, sample.timestamp);
+}
+
+/**
+ * @brief       Logs a driver event
+ *
+ * @param[in]   code        Event code, LogEvent_t or from LOG_EVENT_USER
+ * @param[in]   value       Event argument
+ * @param[in]   timestamp   Event time in ms
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @retval      XENSIV_PASCO2_ERR_COMM if the storage failed
+ * @retval      XENSIV_PASCO2_ERR_NOT_READY if the log is not begun
+ * @pre         begin()
+ */
+Error_t PASCO2Log::logEvent(uint8_t code, int16_t value, uint32_t timestamp)
+{
+    LogRec_t rec;
+
+    rec.type      = LOG_EVENT;
+    rec.code      = code;
+    rec.value     = value;
+    rec.timestamp = timestamp;
+
+    return append(rec);
+}
+
+/**
+ * @brief       Logs a driver event timestamped with millis()
+ *
+ * @param[in]   code        Event code, LogEvent_t or from LOG_EVENT_USER
+ * @param[in]   value       Event argument
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @retval      XENSIV_PASCO2_ERR_COMM if the storage failed
+ * @retval      XENSIV_PASCO2_ERR_NOT_READY if the log is not begun
+ * @pre         begin()
+ */
+Error_t PASCO2Log::logEvent(uint8_t code, int16_t value)
+{
+    return logEvent(code, value, (uint32_t)millis());
+}
+
+/**
+ * @brief       Reads a record
+ *
+ * @param[in]   index   Record slot, from the oldest one
+ * @param[out]  rec     Record
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @retval      XENSIV_PASCO2_ERR_COMM if the record is torn or the storage failed
+ * @retval      XENSIV_PASCO2_ERR_ILLEGAL_ARG if the index is out of range
+ * @pre         begin()
+ */
+Error_t PASCO2Log::read(uint32_t index, LogRec_t & rec) const
+{
+    Slot_t state;
+
+    if(index >= count())
+    {
+        return XENSIV_PASCO2_ERR_ILLEGAL_ARG;
+    }
+
+    uint16_t page = (uint16_t)((head + store->pages - (used - 1U) + (index / perPage)) % store->pages);
+    Error_t  res  = readSlot(page, (uint16_t)(index % perPage), rec, state);
+
+    return ((XENSIV_PASCO2_OK == res) && (SLOT_VALID != state)) ? XENSIV_PASCO2_ERR_COMM : res;
+}
+
+/**
+ * @brief       Erases a page and writes its header
+ */
+Error_t PASCO2Log::openPage(uint16_t page, uint32_t seq)
+{
+    uint8_t buf[headerLen];
+
+    if(XENSIV_PASCO2_OK != store->erase(store->arg, page))
+    {
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    putLE(&buf[LOG_HDR_MAGIC], LOG_MAGIC, 2U);
+    putLE(&buf[LOG_HDR_SEQ], seq, 4U);
+    putLE(&buf[LOG_HDR_CRC], crc16(buf, LOG_HDR_CRC), 2U);
+
+    if(XENSIV_PASCO2_OK != store->write(store->arg, (uint32_t)page * store->pageSize, buf, headerLen))
+    {
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    /* Once wrapped, the erased page was the oldest one */
+    used    = (used < store->pages) ? (uint16_t)(used + 1U) : used;
+    head    = page;
+    headSeq = seq;
+    slot    = 0;
+
+    return XENSIV_PASCO2_OK;
+}
+
+/**
+ * @brief       Reads and checks a page header
+ */
+Error_t PASCO2Log::readHeader(uint16_t page, uint32_t & seq, bool & valid) const
+{
+    uint8_t buf[headerLen];
+
+    if(XENSIV_PASCO2_OK != store->read(store->arg, (uint32_t)page * store->pageSize, buf, headerLen))
+    {
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    seq   = getLE(&buf[LOG_HDR_SEQ], 4U);
+    valid = (LOG_MAGIC == getLE(&buf[LOG_HDR_MAGIC], 2U)) &&
+            (crc16(buf, LOG_HDR_CRC) == getLE(&buf[LOG_HDR_CRC], 2U));
+
+    return XENSIV_PASCO2_OK;
+}
+
+/**
+ * @brief       Reads and checks a record slot
+ */
+Error_t PASCO2Log::readSlot(uint16_t page, uint16_t index, LogRec_t & rec, Slot_t & state) const
+{
+    uint8_t buf[recLen];
+    uint8_t ones = 0xFFU;
+
+    if(XENSIV_PASCO2_OK != store->read(store->arg, slotAddr(page, index), buf, recLen))
+    {
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    for(uint8_t i = 0; i < recLen; i++)
+    {
+        ones &= buf[i];
+    }
+
+    rec.type      = (uint8_t)getLE(&buf[LOG_REC_TYPE], 1U);
+    rec.code      = (uint8_t)getLE(&buf[LOG_REC_CODE], 1U);
+    rec.value     = (int16_t)getLE(&buf[LOG_REC_VALUE], 2U);
+    rec.timestamp = getLE(&buf[LOG_REC_TIME], 4U);
+    rec.boot      = (uint16_t)getLE(&buf[LOG_REC_BOOT], 2U);
+
+    if(0xFFU == ones)
+    {
+        state = SLOT_ERASED;
+    }
+    else if(crc16(buf, LOG_REC_CRC) == getLE(&buf[LOG_REC_CRC], 2U))
+    {
+        state = SLOT_VALID;
+    }
+    else
+    {
+        state = SLOT_TORN;
+    }
+
+    return XENSIV_PASCO2_OK;
+}
+
+/**
+ * @brief       Storage address of a record slot
+ */
+uint32_t PASCO2Log::slotAddr(uint16_t page, uint16_t index) const
+{
+    return ((uint32_t)page * store->pageSize) + headerLen + ((uint32_t)index * recLen);
+}
@@ -0,0 +1,206 @@
+/**
+ * @file        pas-co2-log-ino.hpp
+ * @brief       XENSIV™ PAS CO2 Arduino Persistent Log
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef PAS_CO2_LOG_INO_HPP_
+#define PAS_CO2_LOG_INO_HPP_
+
+#include <stdint.h>
+#include "pas-co2-ino.hpp"
+
+/**
+ * @addtogroup co2inoapi
+ * @{
+ */
+
+/**
+ * @brief   Pluggable page storage
+ *
+ * @details Wraps a flash or EEPROM area of pages, the page being the erase
+ *          unit, e.g. the flash of the target, an SPI NOR flash or the
+ *          emulated EEPROM of the core. An erased page reads 0xFF, and a
+ *          write only needs to clear bits of erased bytes, as NOR flash
+ *          programming does. The addresses are relative to the area start.
+ */
+typedef struct
+{
+    int32_t  (* read)   (void * arg, uint32_t addr, uint8_t * buf, uint16_t len);          /**< Reads len bytes. Returns an XENSIV™ PAS CO2 error code */
+    int32_t  (* write)  (void * arg, uint32_t addr, const uint8_t * buf, uint16_t len);    /**< Programs len bytes. Returns an XENSIV™ PAS CO2 error code */
+    int32_t  (* erase)  (void * arg, uint16_t page);                                        /**< Erases a page to 0xFF. Returns an XENSIV™ PAS CO2 error code */
+    void      * arg;        /**< Storage object passed to the functions */
+    uint16_t    pageSize;   /**< Page size in bytes, at least 32 */
+    uint16_t    pages;      /**< Number of pages, at least 2 */
+} LogStore_t;
+
+/**
+ * @brief   Log record type
+ */
+typedef enum
+{
+    LOG_SAMPLE = 0x01,      /**< CO2 result: value in ppm, code the sensor status (SENS_STS) */
+    LOG_EVENT  = 0x02,      /**< Driver event: code from LogEvent_t, value its argument */
+    LOG_BOOT   = 0x03       /**< Log begun: value the number of corrupted records found */
+} LogType_t;
+
+/**
+ * @brief   Driver event code
+ */
+typedef enum
+{
+    LOG_EVENT_ERROR     = 0x01,     /**< Driver call failed, value the error code */
+    LOG_EVENT_MEAS_RATE = 0x02,     /**< Measurement period changed, value the period in s */
+    LOG_EVENT_FCS       = 0x03,     /**< Forced compensation, value the reference in ppm */
+    LOG_EVENT_USER      = 0x80      /**< First application defined code */
+} LogEvent_t;
+
+/**
+ * @brief   Log record
+ */
+typedef struct
+{
+    uint8_t     type;       /**< Record type, LogType_t */
+    uint8_t     code;       /**< Sensor status or event code */
+    int16_t     value;      /**< CO2 concentration in ppm or event argument */
+    uint32_t    timestamp;  /**< Time in ms, millis() of the boot by default */
+    uint16_t    boot;       /**< Boot number the record was written in */
+} LogRec_t;
+
+/**
+ * @brief       Wear-leveled persistent log of samples and driver events
+ *
+ * @details     Appends fixed-size records to a page storage used as a
+ *              circular log, so that all the pages are erased in turn, the
+ *              same number of times. When the log is full, the oldest page
+ *              is erased to make room.
+ *
+ *              Each page starts with a header holding a sequence number,
+ *              and each record of 12 bytes is protected by a CRC-16. A
+ *              record or a header torn by a brown-out is detected and
+ *              skipped, and never overwritten. The log written before is
+ *              kept.
+ *
+ *              begin() recovers the log with a scan of the page headers and
+ *              of the records of the last page only. It then appends a boot
+ *              record, so that the timestamps, relative to the boot by
+ *              default, can be told apart.
+ *
+ *              @code
+ *              PASCO2Log log(&store);
+ *
+ *              log.begin();
+ *              log.capture(cotwo);     // getCO2() and getDiagnosis()
+ *              @endcode
+ */
+class PASCO2Log
+{
+    public:
+
+        static constexpr uint8_t   recLen      = 12U;  /**< Record size in bytes */
+        static constexpr uint8_t   headerLen   = 8U;   /**< Page header size in bytes */
+
+                 PASCO2Log      (const LogStore_t * store);
+        Error_t  begin          ();
+        Error_t  format         ();
+        Error_t  append         (LogRec_t & rec);
+        Error_t  logSample      (int16_t co2PPM, Diag_t diag, uint32_t timestamp);
+        Error_t  logSample      (int16_t co2PPM, Diag_t diag);
+        Error_t  logSample      (const Sample_t & sample);
+        Error_t  logEvent       (uint8_t code, int16_t value, uint32_t timestamp);
+        Error_t  logEvent       (uint8_t code, int16_t value);
+        Error_t  read           (uint32_t index, LogRec_t & rec) const;
+        template<typename Transport>
+        Error_t  capture        (PASCO2<Transport> & sensor);
+
+        /**
+         * @brief   Number of record slots from the oldest one, torn ones included
+         */
+        uint32_t count          () const { return (0U == used) ? 0U : (((uint32_t)(used - 1U) * perPage) + slot); }
+
+        /**
+         * @brief   Number of records always held once the log has wrapped
+         */
+        uint32_t capacity       () const { return (uint32_t)perPage * (store->pages - 1U); }
+
+        /**
+         * @brief   Current boot number
+         */
+        uint16_t boot           () const { return bootNum; }
+
+        /**
+         * @brief   Number of torn records found by begin()
+         */
+        uint16_t corrupted      () const { return torn; }
+
+        static uint16_t crc16   (const uint8_t * data, uint16_t len);
+
+    private:
+
+        /**
+         * @brief   Record slot state
+         */
+        typedef enum
+        {
+            SLOT_VALID,     /**< Record with a matching CRC */
+            SLOT_ERASED,    /**< Free slot */
+            SLOT_TORN       /**< Partly written or corrupted record */
+        } Slot_t;
+
+        Error_t  openPage       (uint16_t page, uint32_t seq);
+        Error_t  readHeader     (uint16_t page, uint32_t & seq, bool & valid) const;
+        Error_t  readSlot       (uint16_t page, uint16_t index, LogRec_t & rec, Slot_t & state) const;
+        uint32_t slotAddr       (uint16_t page, uint16_t index) const;
+
+        const LogStore_t  * store;      /**< Page storage */
+        uint16_t            perPage;    /**< Records per page */
+        uint16_t            head;       /**< Page being written */
+        uint32_t            headSeq;    /**< Sequence number of the page being written */
+        uint16_t            slot;       /**< Next record of the page being written */
+        uint16_t            used;       /**< Pages in use, the one being written included */
+        uint16_t            bootNum;    /**< Current boot number */
+        uint16_t            torn;       /**< Torn records found by begin() */
+};
+
+/**
+ * @brief       Logs a sample of a sensor
+ *
+ * @details     Reads the CO2 concentration with getCO2() and the sensor
+ *              status with getDiagnosis(), and logs them as a sample
+ *              timestamped with millis(). A failing driver call is logged
+ *              as an error event instead.
+ *
+ * @param[in]   sensor  Sensor in continuous or single shot mode
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if a sample has been logged
+ * @retval      Driver error code if an error event has been logged instead
+ * @retval      XENSIV_PASCO2_ERR_COMM if the storage failed
+ * @pre         begin()
+ */
+template<typename Transport>
+Error_t PASCO2Log::capture(PASCO2<Transport> & sensor)
+{
+    int16_t co2PPM = 0;
+    Diag_t  diag;
+    Error_t ret = sensor.getCO2(co2PPM);
+
+    if(XENSIV_PASCO2_OK == ret)
+    {
+        ret = sensor.getDiagnosis(diag);
+    }
+
+    if(XENSIV_PASCO2_OK != ret)
+    {
+        Error_t res = logEvent(LOG_EVENT_ERROR, ret);
+
+        return (XENSIV_PASCO2_OK == res) ? ret : res;
+    }
+
+    return logSample(co2PPM, diag);
+}
+
+/** @} */
+
+#endif /** PAS_CO2_LOG_INO_HPP_ **/
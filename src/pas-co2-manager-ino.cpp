@@ -0,0 +1,575 @@
+/**
+ * @file        pas-co2-manager-ino.cpp
+ * @brief       XENSIV™ PAS CO2 Arduino Multi-Sensor Manager
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "pas-co2-manager-ino.hpp"
+
+/**
+ * @brief   Assertion of XENSIV™ PAS CO2 return code
+ */
+#define INO_ASSERT_RET(x)   if( x != XENSIV_PASCO2_OK ) { return x; }
+
+/**
+ * @brief       I2C multiplexer chain constructor
+ *
+ * @param[in]   wire        I2C interface of the multiplexers
+ * @param[in]   baseAddr    Address of the first multiplexer. Default is 0x70
+ * @pre         None
+ */
+PASCO2Mux::PASCO2Mux(TwoWire * wire, uint8_t baseAddr)
+: wire(wire), baseAddr(baseAddr), channel(noChannel), enabled(0), writes(0)
+{
+
+}
+
+/**
+ * @brief       Disables all the channels of the multiplexers
+ *
+ * @details     The multiplexers keep their channels across a reset of
+ *              the controller. This brings them to a known state. The
+ *              multiplexers which do not acknowledge are not accessed
+ *              by deselect() afterwards.
+ *
+ * @param[in]   muxMask     Multiplexers of the chain, one bit each from the
+ *                          base address
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if all the multiplexers are disabled
+ * @pre         None
+ */
+Error_t PASCO2Mux::reset(uint8_t muxMask)
+{
+    int32_t ret = XENSIV_PASCO2_OK;
+
+    channel = noChannel;
+    enabled = 0;
+
+    for(uint8_t m = 0; m < 8U; m++)
+    {
+        if(0U != (muxMask & (1U << m)))
+        {
+            int32_t res = write(m, 0);
+
+            if(XENSIV_PASCO2_OK == ret)
+            {
+                ret = res;
+            }
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief       Enables a channel
+ *
+ * @details     Returns without accessing the bus if the channel is already
+ *              enabled. Otherwise the channel of another multiplexer is
+ *              disabled first.
+ *
+ * @param[in]   channel     Channel of the chain, port channel % 8 of the
+ *                          multiplexer channel / 8
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if the channel is enabled
+ * @retval      XENSIV_PASCO2_ERR_ILLEGAL_ARG if the channel is out of the chain
+ * @pre         None
+ */
+Error_t PASCO2Mux::select(uint8_t channel)
+{
+    int32_t ret = XENSIV_PASCO2_OK;
+
+    if(channel == this->channel)
+    {
+        return ret;
+    }
+
+    if(channel >= (8U * portsPerMux))
+    {
+        return XENSIV_PASCO2_ERR_ILLEGAL_ARG;
+    }
+
+    uint8_t mux = channel / portsPerMux;
+
+    /* Disable the other multiplexers */
+    for(uint8_t m = 0; m < 8U; m++)
+    {
+        if((m != mux) && (0U != (enabled & (1U << m))))
+        {
+            ret = write(m, 0);
+            INO_ASSERT_RET(ret);
+        }
+    }
+
+    /* The channel is unknown until the write is acknowledged */
+    this->channel = noChannel;
+
+    ret = write(mux, (uint8_t)(1U << (channel % portsPerMux)));
+    INO_ASSERT_RET(ret);
+
+    this->channel = channel;
+
+    return ret;
+}
+
+/**
+ * @brief       Disables the enabled channel
+ *
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if no channel is enabled
+ * @pre         None
+ */
+Error_t PASCO2Mux::deselect()
+{
+    int32_t ret = XENSIV_PASCO2_OK;
+
+    for(uint8_t m = 0; m < 8U; m++)
+    {
+        if(0U != (enabled & (1U << m)))
+        {
+            ret = write(m, 0);
+            INO_ASSERT_RET(ret);
+        }
+    }
+
+    channel = noChannel;
+
+    return ret;
+}
+
+/**
+ * @brief       Writes the control register of a multiplexer
+ *
+ * @param[in]   mux     Multiplexer of the chain
+ * @param[in]   mask    Channels to enable
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if the write is acknowledged
+ */
+Error_t PASCO2Mux::write(uint8_t mux, uint8_t mask)
+{
+    int32_t ret = XENSIV_PASCO2_OK;
+
+    xensiv_pasco2_plat_bus_lock(wire);
+    ret = xensiv_pasco2_plat_i2c_transfer(wire, (uint16_t)(baseAddr + mux), &mask, 1U, nullptr, 0U);
+    xensiv_pasco2_plat_bus_unlock(wire);
+
+    writes++;
+
+    if(XENSIV_PASCO2_OK != ret)
+    {
+        /* Unreachable, its state does not matter */
+        enabled &= (uint8_t)~(1U << mux);
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    if(0U != mask)
+    {
+        enabled |= (uint8_t)(1U << mux);
+    }
+    else
+    {
+        enabled &= (uint8_t)~(1U << mux);
+    }
+
+    return ret;
+}
+
+/**
+ * @brief       Multi-sensor manager constructor
+ *
+ * @param[in]   wire    I2C interface of the multiplexers and sensors
+ * @param[in]   muxAddr Address of the first multiplexer
+ * @param[in]   sensors Sensor array
+ * @param[in]   slots   Sensors scheduling state array
+ * @param[in]   num     Number of sensors
+ * @pre         None
+ */
+PASCO2ManagerBase::PASCO2ManagerBase(TwoWire * wire, uint8_t muxAddr, PASCO2<PASCO2I2C> * sensors, MuxSlot_t * slots, uint8_t num)
+: muxChain(wire, muxAddr), sensors(sensors), slots(slots), num(num), periodMs(0)
+{
+
+}
+
+/**
+ * @brief       Binds a sensor to a multiplexer channel
+ *
+ * @details     By default, the sensor i is on the channel i.
+ *
+ * @param[in]   index   Sensor index
+ * @param[in]   channel Multiplexer channel
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @retval      XENSIV_PASCO2_ERR_ILLEGAL_ARG if the index or the channel is out of range
+ * @pre         Called before begin()
+ */
+Error_t PASCO2ManagerBase::bind(uint8_t index, uint8_t channel)
+{
+    if((index >= num) || (channel >= (8U * PASCO2Mux::portsPerMux)))
+    {
+        return XENSIV_PASCO2_ERR_ILLEGAL_ARG;
+    }
+
+    slots[index].channel = channel;
+
+    return XENSIV_PASCO2_OK;
+}
+
+/**
+ * @brief       Begins all the sensors in continuous mode
+ *
+ * @details     Resets the multiplexers in use, then soft resets all the
+ *              sensors in parallel. Blocks during the soft reset. A sensor
+ *              failing to begin is not scheduled, the others are.
+ *
+ *              Staggered, the k-th of the n sensors begun starts its
+ *              continuous mode from service(), k * period / n after
+ *              begin() returns. At most ceil(n * 1.15 s / period) sensors
+ *              are then measuring at a time, and the readouts are evenly
+ *              spaced over the period. Otherwise the continuous mode of
+ *              all the sensors is started right away and their
+ *              measurements overlap.
+ *
+ * @param[in]   periodInSec Continuous measurement period, between 5 and 4095 seconds
+ * @param[in]   staggered   Continuous mode starts spread over the period. Default is true
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if all the sensors are begun
+ * @retval      First sensor error code otherwise. See slot() for each sensor status.
+ * @pre         None
+ */
+Error_t PASCO2ManagerBase::begin(int16_t periodInSec, bool staggered)
+{
+    int32_t ret = XENSIV_PASCO2_OK;
+    bool pending = false;
+    uint8_t begun = 0;
+
+    periodMs = (uint32_t)periodInSec * 1000U;
+
+    (void)muxChain.reset(muxMask());
+
+    for(uint8_t i = 0; i < num; i++)
+    {
+        MuxSlot_t & s = slots[i];
+
+        s.active    = false;
+        s.measuring = false;
+        s.retried   = false;
+        s.phase     = 0;
+        s.samples   = 0;
+        s.notReady  = 0;
+
+        s.status = muxChain.select(s.channel);
+        if(XENSIV_PASCO2_OK == s.status)
+        {
+            s.status = sensors[i].beginAsync();
+        }
+
+        if(XENSIV_PASCO2_OK == ret)
+        {
+            ret = s.status;
+        }
+    }
+
+    xensiv_pasco2_plat_wait(XENSIV_PASCO2_SOFT_RESET_DELAY_MS);
+
+    do
+    {
+        pending = false;
+
+        for(uint8_t i = 0; i < num; i++)
+        {
+            MuxSlot_t & s = slots[i];
+
+            if(s.active || (XENSIV_PASCO2_OK != s.status))
+            {
+                continue;
+            }
+
+            s.status = muxChain.select(s.channel);
+            if(XENSIV_PASCO2_OK == s.status)
+            {
+                s.status = sensors[i].poll();
+            }
+
+            if(XENSIV_PASCO2_BUSY == s.status)
+            {
+                s.status = XENSIV_PASCO2_OK;
+                pending  = true;
+                continue;
+            }
+
+            if((XENSIV_PASCO2_OK == s.status) && !staggered)
+            {
+                s.status = sensors[i].startMeasure(periodInSec);
+            }
+
+            if(XENSIV_PASCO2_OK == s.status)
+            {
+                /* The first measurement sequence starts right away */
+                s.active    = true;
+                s.measuring = !staggered;
+                s.due       = (uint32_t)millis() + measTimeMs;
+                begun++;
+            }
+            else if(XENSIV_PASCO2_OK == ret)
+            {
+                ret = s.status;
+            }
+        }
+
+        if(pending)
+        {
+            xensiv_pasco2_plat_wait(retryMs);
+        }
+    }
+    while(pending);
+
+    if(staggered)
+    {
+        uint32_t start = (uint32_t)millis();
+        uint8_t k = 0;
+
+        for(uint8_t i = 0; i < num; i++)
+        {
+            if(slots[i].active)
+            {
+                slots[i].phase = (periodMs * k++) / begun;
+                slots[i].due   = start + slots[i].phase;
+            }
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * @brief       Ends all the sensors
+ *
+ * @details     Stops the measurement of the active sensors and disables
+ *              the multiplexer channel.
+ *
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success
+ * @retval      First sensor error code otherwise
+ * @pre         begin()
+ */
+Error_t PASCO2ManagerBase::end()
+{
+    int32_t ret = XENSIV_PASCO2_OK;
+
+    for(uint8_t i = 0; i < num; i++)
+    {
+        MuxSlot_t & s = slots[i];
+
+        if(!s.active)
+        {
+            continue;
+        }
+
+        s.active = false;
+
+        s.status = muxChain.select(s.channel);
+        if(XENSIV_PASCO2_OK == s.status)
+        {
+            s.status = sensors[i].stopMeasure();
+            (void)sensors[i].end();
+        }
+
+        if(XENSIV_PASCO2_OK == ret)
+        {
+            ret = s.status;
+        }
+    }
+
+    int32_t res = muxChain.deselect();
+
+    return (XENSIV_PASCO2_OK == ret) ? res : ret;
+}
+
+/**
+ * @brief       Services the managed sensors
+ *
+ * @details     Reads out the sensor most overdue, or a sensor due on the
+ *              enabled channel if any, so that the channel is not switched
+ *              back and forth. Returns without accessing the bus if no
+ *              sensor is due. A staggered sensor due to start its
+ *              continuous mode is started instead.
+ *
+ *              A readout is due one period after the previous one, minus
+ *              trackMs. A readout finding no data is retried every retryMs,
+ *              and the next one is due one period after the data came in.
+ *              The readouts then follow the sensor clock drift.
+ *
+ * @param[out]  sample  New sample, tagged with the sensor index. The index is
+ *                      also set on error
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if a new sample has been read
+ * @retval      XENSIV_PASCO2_READ_NRDY if no new sample is available
+ * @pre         begin()
+ */
+Error_t PASCO2ManagerBase::service(MuxSample_t & sample)
+{
+    int32_t ret = XENSIV_PASCO2_OK;
+    int16_t i = nextSensor((uint32_t)millis());
+
+    if(i < 0)
+    {
+        return XENSIV_PASCO2_READ_NRDY;
+    }
+
+    MuxSlot_t & s = slots[i];
+
+    sample.sensor = (uint8_t)i;
+
+    ret = muxChain.select(s.channel);
+    if(XENSIV_PASCO2_OK == ret)
+    {
+        ret = s.measuring ? sensors[i].service(sample.sample) : sensors[i].startMeasure((int16_t)(periodMs / 1000U));
+    }
+
+    uint32_t now = (uint32_t)millis();
+
+    if(!s.measuring)
+    {
+        /* Staggered continuous mode start, retried one period later on error */
+        s.measuring = (XENSIV_PASCO2_OK == ret);
+        s.due       = now + (s.measuring ? measTimeMs : periodMs);
+        s.status    = ret;
+
+        return s.measuring ? (Error_t)XENSIV_PASCO2_READ_NRDY : ret;
+    }
+
+    if(XENSIV_PASCO2_OK == ret)
+    {
+        s.samples++;
+        s.due     = s.retried ? (now + periodMs) : (s.due + periodMs - trackMs);
+        s.retried = false;
+    }
+    else if(XENSIV_PASCO2_READ_NRDY == ret)
+    {
+        s.notReady++;
+        s.due     = now + retryMs;
+        s.retried = true;
+    }
+    else
+    {
+        /* Skip to the next period */
+        s.due     = now + periodMs;
+        s.retried = false;
+    }
+
+    s.status = ret;
+
+    return ret;
+}
+
+/**
+ * @brief       Time until the next readout is due
+ *
+ * @details     The controller can sleep in the meantime.
+ *
+ * @return      Time in ms. 0 if a readout is due, 0xFFFFFFFF if no sensor is active
+ * @pre         begin()
+ */
+uint32_t PASCO2ManagerBase::nextDueMs() const
+{
+    uint32_t now  = (uint32_t)millis();
+    uint32_t next = 0xFFFFFFFFU;
+
+    for(uint8_t i = 0; i < num; i++)
+    {
+        if(!slots[i].active)
+        {
+            continue;
+        }
+
+        int32_t left = (int32_t)(slots[i].due - now);
+
+        if(left <= 0)
+        {
+            return 0;
+        }
+
+        if((uint32_t)left < next)
+        {
+            next = (uint32_t)left;
+        }
+    }
+
+    return next;
+}
+
+/**
+ * @brief       Enables the channel of a sensor and gets the sensor
+ *
+ * @details     Gives access to the whole sensor API, e.g. for the
+ *              configuration or the diagnosis. The sensor calls fail
+ *              with XENSIV_PASCO2_ERR_COMM if the channel could not be
+ *              enabled.
+ *
+ *              @code
+ *              Diag_t diag;
+ *              sensors.select(3).getDiagnosis(diag);
+ *              @endcode
+ *
+ * @param[in]   index   Sensor index, below count()
+ * @return      Sensor
+ * @pre         None
+ */
+PASCO2<PASCO2I2C> & PASCO2ManagerBase::select(uint8_t index)
+{
+    (void)muxChain.select(slots[index].channel);
+
+    return sensors[index];
+}
+
+/**
+ * @brief       Gets the sensor to read out
+ *
+ * @param[in]   now     Current time in ms
+ * @return      Sensor index. -1 if none is due
+ */
+int16_t PASCO2ManagerBase::nextSensor(uint32_t now) const
+{
+    int16_t next = -1;
+
+    for(uint8_t i = 0; i < num; i++)
+    {
+        const MuxSlot_t & s = slots[i];
+
+        if(!s.active || ((int32_t)(now - s.due) < 0))
+        {
+            continue;
+        }
+
+        if(s.channel == muxChain.current())
+        {
+            return (int16_t)i;
+        }
+
+        if((next < 0) || ((int32_t)(s.due - slots[next].due) < 0))
+        {
+            next = (int16_t)i;
+        }
+    }
+
+    return next;
+}
+
+/**
+ * @brief       Gets the multiplexers in use
+ *
+ * @return      Multiplexers with a bound sensor, one bit each from the base address
+ */
+uint8_t PASCO2ManagerBase::muxMask() const
+{
+    uint8_t mask = 0;
+
+    for(uint8_t i = 0; i < num; i++)
+    {
+        mask |= (uint8_t)(1U << (slots[i].channel / PASCO2Mux::portsPerMux));
+    }
+
+    return mask;
+}
@@ -0,0 +1,249 @@
+/**
+ * @file        pas-co2-manager-ino.hpp
+ * @brief       XENSIV™ PAS CO2 Arduino Multi-Sensor Manager
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef PAS_CO2_MANAGER_INO_HPP_
+#define PAS_CO2_MANAGER_INO_HPP_
+
+#include <Arduino.h>
+#include <Wire.h>
+#include "pas-co2-ino.hpp"
+
+/**
+ * @addtogroup co2inoapi
+ * @{
+ */
+
+/**
+ * @brief   CO2 sample of a managed sensor
+ */
+typedef struct
+{
+    Sample_t    sample;     /**< Acquired sample */
+    uint8_t     sensor;     /**< Index of the sensor in the manager */
+} MuxSample_t;
+
+/**
+ * @brief   Aggregated sample ring buffer for PASCO2Manager::service()
+ * @tparam  N   Capacity. Power of two, up to 128
+ */
+template<uint8_t N>
+using PASCO2MuxSampleRing = PASCO2Ring<MuxSample_t, N>;
+
+/**
+ * @brief       TCA9548A I2C multiplexer chain
+ *
+ * @details     Up to 8 multiplexers at consecutive addresses from the base
+ *              address. Channel c is the port c % 8 of the multiplexer
+ *              c / 8. A single channel of the whole chain is enabled at a
+ *              time, so that devices with the same address on different
+ *              channels never collide. The current channel is cached and
+ *              the control registers are only written on a change.
+ */
+class PASCO2Mux
+{
+    public:
+
+        static constexpr uint8_t   defaultAddr = 0x70U;   /**< TCA9548A address with A2..A0 low */
+        static constexpr uint8_t   portsPerMux = 8U;      /**< Channels per multiplexer */
+        static constexpr uint8_t   noChannel   = 0xFFU;   /**< No channel enabled, or unknown */
+
+                PASCO2Mux   (TwoWire * wire = &Wire, uint8_t baseAddr = defaultAddr);
+        Error_t reset       (uint8_t muxMask = 0x01U);
+        Error_t select      (uint8_t channel);
+        Error_t deselect    ();
+
+        /**
+         * @brief   Enabled channel. noChannel if none or unknown
+         */
+        uint8_t  current    () const { return channel; }
+
+        /**
+         * @brief   Number of control register writes
+         */
+        uint32_t switches   () const { return writes; }
+
+    private:
+
+        Error_t  write      (uint8_t mux, uint8_t mask);
+
+        TwoWire         * wire;     /**< I2C interface */
+        uint8_t           baseAddr; /**< Address of the first multiplexer */
+        uint8_t           channel;  /**< Enabled channel */
+        uint8_t           enabled;  /**< Multiplexers which may have a channel enabled, one bit each */
+        uint32_t          writes;   /**< Control register writes */
+};
+
+/**
+ * @brief       Scheduling state of a managed sensor
+ */
+typedef struct
+{
+    uint8_t     channel;    /**< Multiplexer channel */
+    bool        active;     /**< Sensor begun */
+    bool        measuring;  /**< Continuous mode started */
+    bool        retried;    /**< Current readout found no data at least once */
+    Error_t     status;     /**< Last error code of the sensor */
+    uint32_t    phase;      /**< Continuous mode start offset within the period in ms */
+    uint32_t    due;        /**< Next continuous mode start or readout time in ms */
+    uint32_t    samples;    /**< Samples read */
+    uint32_t    notReady;   /**< Readouts that found no new data */
+} MuxSlot_t;
+
+/**
+ * @brief       Multi-sensor manager, sensor count independent part
+ *
+ * @details     Use PASCO2Manager to declare the sensors.
+ */
+class PASCO2ManagerBase
+{
+    public:
+
+        static constexpr uint32_t  measTimeMs   = 1150U;  /**< Sensor measurement sequence duration in ms */
+        static constexpr uint16_t  retryMs      = 100U;   /**< Readout retry interval in ms if no data is ready */
+        static constexpr uint16_t  trackMs      = 20U;    /**< Readout advance per period to follow the sensor clock */
+
+        Error_t bind        (uint8_t index, uint8_t channel);
+        Error_t begin       (int16_t periodInSec, bool staggered = true);
+        Error_t end         ();
+        Error_t service     (MuxSample_t & sample);
+        template<uint8_t M>
+        Error_t service     (PASCO2MuxSampleRing<M> & ring);
+        uint32_t nextDueMs  () const;
+        PASCO2<PASCO2I2C> & select(uint8_t index);
+
+        /**
+         * @brief   Number of managed sensors
+         */
+        uint8_t  count      () const { return num; }
+
+        /**
+         * @brief   Scheduling state of a sensor
+         */
+        const MuxSlot_t & slot(uint8_t index) const { return slots[index]; }
+
+        /**
+         * @brief   Multiplexer chain
+         */
+        PASCO2Mux & mux     () { return muxChain; }
+
+    protected:
+
+        PASCO2ManagerBase(TwoWire * wire, uint8_t muxAddr, PASCO2<PASCO2I2C> * sensors, MuxSlot_t * slots, uint8_t num);
+
+    private:
+
+        int16_t   nextSensor  (uint32_t now) const;
+        uint8_t   muxMask     () const;
+
+        PASCO2Mux           muxChain;   /**< Multiplexer chain */
+        PASCO2<PASCO2I2C> * sensors;    /**< Sensor array */
+        MuxSlot_t         * slots;      /**< Scheduling state array */
+        uint8_t             num;        /**< Number of sensors */
+        uint32_t            periodMs;   /**< Measurement period in ms */
+};
+
+/**
+ * @brief       Multi-sensor manager over TCA9548A I2C multiplexers
+ *
+ * @details     Owns N I2C sensors, each one on its own multiplexer channel,
+ *              by default the channel equal to its index. The sensors are
+ *              measuring in continuous mode and are read out in due time
+ *              order into a single stream of samples tagged with the sensor
+ *              index. The multiplexer channel is only switched when the
+ *              sensor to be read out is on another channel.
+ *
+ *              @code
+ *              PASCO2Manager<16> sensors(&Wire);    // Two multiplexers at 0x70 and 0x71
+ *              PASCO2MuxSampleRing<32> ring;
+ *
+ *              sensors.begin(60);
+ *
+ *              while(true)
+ *              {
+ *                  sensors.service(ring);
+ *                  // ... drain the ring, sleep for nextDueMs() ...
+ *              }
+ *              @endcode
+ *
+ *              The continuous mode starts are staggered over the period, so
+ *              that the measurement sequences, with their supply current
+ *              peaks, and the readouts are spread evenly instead of lining
+ *              up.
+ *
+ *              The manager accesses the bus from a single context. Do not
+ *              access the sensors behind its back other than through select().
+ *
+ * @tparam      N   Number of sensors, up to 64
+ */
+template<uint8_t N>
+class PASCO2Manager : public PASCO2ManagerBase
+{
+    static_assert((N > 0U) && (N <= 64U), "up to 64 sensors behind 8 multiplexers");
+
+    public:
+
+        /**
+         * @brief       Multi-sensor manager constructor
+         * @param[in]   wire    I2C interface of the multiplexers and sensors
+         * @param[in]   muxAddr Address of the first multiplexer
+         */
+        PASCO2Manager(TwoWire * wire = &Wire, uint8_t muxAddr = PASCO2Mux::defaultAddr)
+        : PASCO2ManagerBase(wire, muxAddr, sensorArray, slotArray, N)
+        {
+            for(uint8_t i = 0; i < N; i++)
+            {
+                (void)sensorArray[i].init(wire);
+                slotArray[i] = MuxSlot_t();
+                slotArray[i].channel = i;
+            }
+        }
+
+    private:
+
+        PASCO2<PASCO2I2C>   sensorArray[N]; /**< Sensors */
+        MuxSlot_t           slotArray[N];   /**< Sensors scheduling state */
+};
+
+/**
+ * @brief       Services the managed sensors into a ring buffer
+ *
+ * @details     Reads out all the sensors due, in due time order, and pushes
+ *              their samples into the ring buffer. If the ring is full, the
+ *              samples are dropped and counted in the ring dropped() counter.
+ *
+ * @param[in]   ring    Aggregated sample ring buffer
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if at least one new sample has been read, pushed or dropped
+ * @retval      XENSIV_PASCO2_READ_NRDY if no new sample is available
+ * @pre         begin()
+ */
+template<uint8_t M>
+Error_t PASCO2ManagerBase::service(PASCO2MuxSampleRing<M> & ring)
+{
+    MuxSample_t sample;
+    int32_t ret = XENSIV_PASCO2_READ_NRDY;
+    bool pushed = false;
+
+    /* Each sensor is read out at most once */
+    for(uint8_t i = 0; (i < num) && (0U == nextDueMs()); i++)
+    {
+        ret = service(sample);
+
+        if(XENSIV_PASCO2_OK == ret)
+        {
+            (void)ring.push(sample);
+            pushed = true;
+        }
+    }
+
+    return pushed ? (Error_t)XENSIV_PASCO2_OK : ret;
+}
+
+/** @} */
+
+#endif /** PAS_CO2_MANAGER_INO_HPP_ **/
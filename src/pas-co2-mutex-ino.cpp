@@ -0,0 +1,100 @@
+/** 
+ * @file        pas-co2-mutex-ino.cpp
+ * @brief       XENSIV™ PAS CO2 Arduino PAL Bus Mutex Implementation
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *              
+ * SPDX-License-Identifier: MIT
+ *
+ * @details     Kept apart from pas-co2-pal-ino.cpp so that the host builds,
+ *              which replace the rest of the PAL, link the same implementation.
+ */
+
+
+#include <Arduino.h>
+#include "xensiv_pasco2.h"
+#include "pas-co2-pal-ino.hpp"
+
+#define INO_ASSERT(x)   do {                \
+                            if(!(x))        \
+                            {               \
+                                abort();    \
+                            }               \
+                        } while(false)
+
+static void                             * busCtx[XENSIV_PASCO2_PLAT_BUS_MUTEX_MAX]   = {NULL};  /**< Buses with a mutex */
+static const xensiv_pasco2_plat_mutex_t * busMutex[XENSIV_PASCO2_PLAT_BUS_MUTEX_MAX] = {NULL};  /**< Mutex of each bus */
+
+/**
+ * @brief       Sets the mutex of a serial bus
+ * 
+ * @details     The mutex is taken around every transfer of all the sensor
+ *              instances on the bus. To share the bus with other drivers,
+ *              pass the mutex they already use.
+ *              Must be called before the tasks using the bus are started.
+ * 
+ * @param[in]   bus     TwoWire or HardwareSerial instance
+ * @param[in]   mutex   Bus mutex. Must remain valid while in use. NULL to remove it
+ * @return      False if XENSIV_PASCO2_PLAT_BUS_MUTEX_MAX buses already have a mutex
+ */
+bool xensiv_pasco2_plat_set_bus_mutex(void * bus, const xensiv_pasco2_plat_mutex_t * mutex)
+{
+    INO_ASSERT(bus != NULL);
+
+    uint8_t slot = XENSIV_PASCO2_PLAT_BUS_MUTEX_MAX;
+
+    for(uint8_t i = 0; i < XENSIV_PASCO2_PLAT_BUS_MUTEX_MAX; i++)
+    {
+        if(bus == busCtx[i])
+        {
+            slot = i;
+            break;
+        }
+        else if((NULL == busCtx[i]) && (XENSIV_PASCO2_PLAT_BUS_MUTEX_MAX == slot))
+        {
+            slot = i;
+        }
+    }
+
+    if(XENSIV_PASCO2_PLAT_BUS_MUTEX_MAX == slot)
+    {
+        return (NULL == mutex);
+    }
+
+    busMutex[slot] = mutex;
+    busCtx[slot]   = (NULL != mutex) ? bus : NULL;
+
+    return true;
+}
+
+static const xensiv_pasco2_plat_mutex_t * xensiv_pasco2_plat_bus_mutex(void * ctx)
+{
+    for(uint8_t i = 0; i < XENSIV_PASCO2_PLAT_BUS_MUTEX_MAX; i++)
+    {
+        if(ctx == busCtx[i])
+        {
+            return busMutex[i];
+        }
+    }
+
+    return NULL;
+}
+
+void xensiv_pasco2_plat_bus_lock(void * ctx)
+{
+    const xensiv_pasco2_plat_mutex_t * mutex = xensiv_pasco2_plat_bus_mutex(ctx);
+
+    if(NULL != mutex)
+    {
+        mutex->lock(mutex->arg);
+    }
+}
+
+void xensiv_pasco2_plat_bus_unlock(void * ctx)
+{
+    const xensiv_pasco2_plat_mutex_t * mutex = xensiv_pasco2_plat_bus_mutex(ctx);
+
+    if(NULL != mutex)
+    {
+        mutex->unlock(mutex->arg);
+    }
+}
@@ -10,8 +10,7 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include "xensiv_pasco2.h"
-
-#define XENSIV_PASCO2_UART_TIMEOUT_MS           (500U)
+#include "pas-co2-pal-ino.hpp"
 
 #define INO_ASSERT(x)   do {                \
                             if(!(x))        \
@@ -20,6 +19,9 @@
                             }               \
                         } while(false)
 
+static xensiv_pasco2_plat_wait_t waitHook = NULL;  /**< Wait hook. NULL for the Arduino delay() */
+static void                    * waitArg  = NULL;  /**< Wait hook user argument */
+
 int32_t xensiv_pasco2_plat_i2c_transfer(void * ctx, uint16_t dev_addr, const uint8_t * tx_buffer, size_t tx_len, uint8_t * rx_buffer, size_t rx_len)
 {
     INO_ASSERT(ctx != NULL);
@@ -65,29 +67,85 @@ int32_t xensiv_pasco2_plat_i2c_transfer(void * ctx, uint16_t dev_addr, const uin
    return XENSIV_PASCO2_OK;
 }
 
-int32_t xensiv_pasco2_plat_uart_read(void * ctx, uint8_t * data, size_t len)
+/**
+ * @brief       Starts a non-blocking UART receive request
+ * 
+ * @param[out]  rx      Receive request
+ * @param[in]   ctx     UART object
+ * @param[out]  data    Receive buffer
+ * @param[in]   len     Number of bytes to receive
+ * @param[in]   timeout Deadline relative to now in ms 
+ */
+void xensiv_pasco2_plat_uart_rx_start(xensiv_pasco2_plat_uart_rx_t * rx, void * ctx, uint8_t * data, size_t len, uint32_t timeout)
 {
+    INO_ASSERT(rx != NULL);
     INO_ASSERT(ctx != NULL);
     INO_ASSERT(data != NULL);
 
-    HardwareSerial * uart = (HardwareSerial *)ctx;
-    uint32_t timeout = XENSIV_PASCO2_UART_TIMEOUT_MS;
-    size_t xfer_len = 0;
+    rx->ctx     = ctx;
+    rx->data    = data;
+    rx->len     = len;
+    rx->count   = 0;
+    rx->start   = (uint32_t)millis();
+    rx->timeout = timeout;
+    rx->status  = XENSIV_PASCO2_BUSY;
+}
+
+/**
+ * @brief       Pumps a non-blocking UART receive request
+ * 
+ * @details     Moves the bytes already available in the UART
+ *              buffer into the request buffer and checks the
+ *              request deadline. It never waits.
+ * 
+ * @param[inout] rx     Receive request
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if all the bytes have been received
+ * @retval      XENSIV_PASCO2_BUSY if the request is still pending
+ * @retval      XENSIV_PASCO2_ERR_COMM if the deadline expired 
+ */
+int32_t xensiv_pasco2_plat_uart_rx_poll(xensiv_pasco2_plat_uart_rx_t * rx)
+{
+    INO_ASSERT(rx != NULL);
 
-    while (((size_t)(uart->available()) < len) && (timeout > 0U))
+    if(XENSIV_PASCO2_BUSY == rx->status)
     {
-        delay(1);
-        timeout--;
+        HardwareSerial * uart = (HardwareSerial *)rx->ctx;
+
+        while((rx->count < rx->len) && (uart->available() > 0))
+        {
+            rx->data[rx->count++] = (uint8_t)uart->read();
+        }
+
+        if(rx->count == rx->len)
+        {
+            rx->status = XENSIV_PASCO2_OK;
+        }
+        else if(((uint32_t)millis() - rx->start) >= rx->timeout)
+        {
+            rx->status = XENSIV_PASCO2_ERR_COMM;
+        }
     }
 
-    if (timeout != 0U)
+    return rx->status;
+}
+
+int32_t xensiv_pasco2_plat_uart_read(void * ctx, uint8_t * data, size_t len)
+{
+    INO_ASSERT(ctx != NULL);
+    INO_ASSERT(data != NULL);
+
+    xensiv_pasco2_plat_uart_rx_t rx;
+    int32_t ret;
+
+    xensiv_pasco2_plat_uart_rx_start(&rx, ctx, data, len, XENSIV_PASCO2_UART_TIMEOUT_MS);
+
+    while (XENSIV_PASCO2_BUSY == (ret = xensiv_pasco2_plat_uart_rx_poll(&rx)))
     {
-        xfer_len = uart->readBytes(data, len);
+        xensiv_pasco2_plat_wait(0);
     }
 
-    return (len == xfer_len) ? 
-            XENSIV_PASCO2_OK : 
-            XENSIV_PASCO2_ERR_COMM;
+    return ret;
 }
 
 int32_t xensiv_pasco2_plat_uart_write(void * ctx, uint8_t * data, size_t len)
@@ -108,7 +166,77 @@ int32_t xensiv_pasco2_plat_uart_write(void * ctx, uint8_t * data, size_t len)
 
 void xensiv_pasco2_plat_delay(uint32_t ms)
 {
-    delay(ms);
+    xensiv_pasco2_plat_wait(ms);
+}
+
+/**
+ * @brief       Sets the wait hook
+ * 
+ * @details     The hook is shared by all the sensor instances. It must 
+ *              not be changed while a sensor function is running.
+ * 
+ * @param[in]   wait    Wait hook. NULL to restore the Arduino delay()
+ * @param[in]   arg     User argument passed to the hook
+ */
+void xensiv_pasco2_plat_set_wait(xensiv_pasco2_plat_wait_t wait, void * arg)
+{
+    waitHook = wait;
+    waitArg  = arg;
+}
+
+/**
+ * @brief       Waits through the wait hook
+ * 
+ * @details     Without hook, it blocks in delay(). A yield request then 
+ *              waits 1 ms, so that polling loops do not spin on the bus.
+ * 
+ * @param[in]   ms      Time to wait in ms. 0 to yield
+ */
+void xensiv_pasco2_plat_wait(uint32_t ms)
+{
+    xensiv_pasco2_plat_wait_t wait = waitHook;
+
+    if(NULL != wait)
+    {
+        wait(waitArg, ms);
+    }
+    else
+    {
+        delay((ms > 0U) ? ms : 1U);
+    }
+}
+
+/**
+ * @brief       Wait hook running the Arduino yield() 
+ * 
+ * @details     Calls yield() until the time has elapsed, so that the 
+ *              cooperative scheduler of the core (e.g. ESP8266, or the 
+ *              Scheduler library) runs other work during the waits.
+ * 
+ * @param[in]   arg     Unused
+ * @param[in]   ms      Time to wait in ms. 0 to yield once
+ */
+void xensiv_pasco2_plat_yield_wait(void * arg, uint32_t ms)
+{
+    (void)arg;
+
+    /* The microsecond clock avoids returning up to 1 ms early on a millis() tick */
+    uint32_t start = (uint32_t)micros();
+
+    do
+    {
+        yield();
+    } while(((uint32_t)micros() - start) < (ms * 1000UL));
+}
+
+uint32_t xensiv_pasco2_plat_get_time_ms(void)
+{
+    return (uint32_t)millis();
+}
+
+uint32_t xensiv_pasco2_plat_get_time_us(void)
+{
+    return (uint32_t)micros();
 }
 
 uint16_t xensiv_pasco2_plat_htons(uint16_t x)
@@ -0,0 +1,86 @@
+/** 
+ * @file        pas-co2-pal-ino.hpp
+ * @brief       XENSIV™ PAS CO2 Arduino PAL Extensions
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *              
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef PAS_CO2_PAL_INO_HPP_
+#define PAS_CO2_PAL_INO_HPP_
+
+#include <Arduino.h>
+#include "xensiv_pasco2.h"
+
+/**
+ * @addtogroup co2inopal
+ * @{
+ */
+
+/**
+ * @brief UART receive timeout in milliseconds
+ */
+#define XENSIV_PASCO2_UART_TIMEOUT_MS           (500U)
+
+/**
+ * @brief   Non-blocking UART receive request
+ * 
+ * @details The request is started with xensiv_pasco2_plat_uart_rx_start()
+ *          and pumped by the caller with xensiv_pasco2_plat_uart_rx_poll()
+ *          until it completes or its deadline expires.
+ */
+typedef struct
+{
+    void      * ctx;        /**< UART object */
+    uint8_t   * data;       /**< Receive buffer */
+    size_t      len;        /**< Number of bytes to receive */
+    size_t      count;      /**< Number of bytes received so far */
+    uint32_t    start;      /**< Request start time in ms */
+    uint32_t    timeout;    /**< Request timeout in ms */
+    int32_t     status;     /**< Completion status */
+} xensiv_pasco2_plat_uart_rx_t;
+
+void    xensiv_pasco2_plat_uart_rx_start(xensiv_pasco2_plat_uart_rx_t * rx, void * ctx, uint8_t * data, size_t len, uint32_t timeout);
+int32_t xensiv_pasco2_plat_uart_rx_poll (xensiv_pasco2_plat_uart_rx_t * rx);
+
+/**
+ * @brief   Wait hook
+ * 
+ * @details Called for every wait of the driver: the inter-transaction 
+ *          guard times, the soft reset time, the forced compensation polls 
+ *          and the UART receive. It must return once at least ms milliseconds
+ *          have elapsed. A zero ms wait is a yield request of a polling loop, 
+ *          which is repeated until its condition is met.
+ * 
+ * @param[in]   arg     User argument registered with the hook
+ * @param[in]   ms      Time to wait in ms
+ */
+typedef void (*xensiv_pasco2_plat_wait_t)(void * arg, uint32_t ms);
+
+void    xensiv_pasco2_plat_set_wait     (xensiv_pasco2_plat_wait_t wait, void * arg);
+void    xensiv_pasco2_plat_wait         (uint32_t ms);
+void    xensiv_pasco2_plat_yield_wait   (void * arg, uint32_t ms);
+
+/**
+ * @brief Maximum number of serial buses with a mutex
+ */
+#define XENSIV_PASCO2_PLAT_BUS_MUTEX_MAX        (4U)
+
+/**
+ * @brief   Pluggable mutex
+ * 
+ * @details Wraps the mutex of the target RTOS or threading library,
+ *          e.g. a FreeRTOS semaphore or a std::mutex.
+ */
+typedef struct
+{
+    void     (* lock)   (void * arg);   /**< Blocks until the mutex is taken */
+    void     (* unlock) (void * arg);   /**< Releases the mutex */
+    void      * arg;                    /**< Mutex object passed to lock and unlock */
+} xensiv_pasco2_plat_mutex_t;
+
+bool    xensiv_pasco2_plat_set_bus_mutex(void * bus, const xensiv_pasco2_plat_mutex_t * mutex);
+
+/** @} */
+
+#endif /** PAS_CO2_PAL_INO_HPP_ **/
@@ -0,0 +1,441 @@
+/**
+ * @file        pas-co2-quantile-ino.hpp
+ * @brief       XENSIV™ PAS CO2 Arduino Streaming Quantile Sketch
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef PAS_CO2_QUANTILE_INO_HPP_
+#define PAS_CO2_QUANTILE_INO_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pas-co2-ino.hpp"
+
+/**
+ * @addtogroup co2inoapi
+ * @{
+ */
+
+/**
+ * @brief       Streaming quantile sketch of the CO2 concentration
+ *
+ * @details     Log-linear histogram of the ppm results: the values below
+ *              2^(B+1) have a bucket each, and every octave above is split
+ *              into 2^B buckets. Any quantile is then estimated within a
+ *              relative error of 2^-(B+1) of the true value, whatever the
+ *              distribution and the number of results, with a fixed
+ *              memory of (16 - B) * 2^B counters:
+ *
+ *              | B | Buckets | RAM (uint16_t counts) | Max relative error |
+ *              |---|---------|-----------------------|--------------------|
+ *              | 3 | 104     | 208 bytes             | 6.25 %             |
+ *              | 4 | 192     | 384 bytes             | 3.13 %             |
+ *              | 5 | 352     | 704 bytes             | 1.56 %             |
+ *              | 6 | 640     | 1280 bytes            | 0.78 %             |
+ *
+ *              add() is a bit scan and an increment, without division.
+ *              Sketches of the same B and count type are merged exactly by
+ *              adding the counters, e.g. to compute the building quantiles
+ *              from the room sketches, or the week from the days. The
+ *              serialized form only holds the non-empty buckets as varints,
+ *              about 130 bytes for a day of minute results with B = 5.
+ *
+ *              @code
+ *              PASCO2Quantiles<5> day;
+ *
+ *              if(XENSIV_PASCO2_OK == cotwo.getCO2(co2))
+ *              {
+ *                  day.add(co2);
+ *              }
+ *
+ *              int16_t p95 = day.quantile(950);
+ *              @endcode
+ *
+ * @tparam      B   Sub-bucket bits, 2 to 8
+ * @tparam      C   Counter type. A bucket saturates at its maximum value,
+ *                  e.g. uint32_t above 65535 results in a bucket
+ */
+template<uint8_t B = 5, typename C = uint16_t>
+class PASCO2Quantiles
+{
+    static_assert((B >= 2U) && (B <= 8U), "sub-bucket bits must be 2 to 8");
+
+    public:
+
+        static constexpr uint16_t buckets   = (uint16_t)((16U - B) << B);      /**< Number of buckets */
+        static constexpr uint8_t  format    = 1U;                               /**< Serialized format version */
+        static constexpr size_t   maxSerializedSize = 4U + (2U * 5U) + (2U * 3U) + 2U + ((size_t)buckets * (2U + 5U)); /**< Serialized size upper bound */
+
+        PASCO2Quantiles()
+        {
+            reset();
+        }
+
+        /**
+         * @brief       Clears all the counters
+         */
+        void reset()
+        {
+            for(uint16_t i = 0; i < buckets; i++)
+            {
+                counts[i] = 0;
+            }
+
+            total   = 0;
+            dropped = 0;
+            lo      = INT16_MAX;
+            hi      = 0;
+        }
+
+        /**
+         * @brief       Adds a result
+         * @param[in]   co2PPM  CO2 concentration in ppm. Negative values count as 0
+         */
+        void add(int16_t co2PPM)
+        {
+            uint16_t v = (co2PPM < 0) ? 0U : (uint16_t)co2PPM;
+            uint16_t i = index(v);
+
+            if((C)~(C)0 == counts[i])
+            {
+                dropped++;
+                return;
+            }
+
+            counts[i]++;
+            total++;
+
+            lo = ((int16_t)v < lo) ? (int16_t)v : lo;
+            hi = ((int16_t)v > hi) ? (int16_t)v : hi;
+        }
+
+        /**
+         * @brief       Adds an acquired sample
+         * @param[in]   sample  Sample from service()
+         */
+        void add(const Sample_t & sample)
+        {
+            add(sample.co2PPM);
+        }
+
+        /**
+         * @brief       Merges another sketch into this one
+         * @param[in]   other   Sketch of the same resolution and counter type
+         */
+        void merge(const PASCO2Quantiles & other)
+        {
+            for(uint16_t i = 0; i < buckets; i++)
+            {
+                C room = (C)((C)~(C)0 - counts[i]);
+
+                if(other.counts[i] > room)
+                {
+                    dropped   += (uint32_t)(other.counts[i] - room);
+                    total     += room;
+                    counts[i]  = (C)~(C)0;
+                }
+                else
+                {
+                    total     += other.counts[i];
+                    counts[i] += other.counts[i];
+                }
+            }
+
+            dropped += other.dropped;
+            lo = (other.lo < lo) ? other.lo : lo;
+            hi = (other.hi > hi) ? other.hi : hi;
+        }
+
+        /**
+         * @brief       Number of results counted
+         */
+        uint32_t count() const
+        {
+            return total;
+        }
+
+        /**
+         * @brief       Number of results not counted because their bucket was saturated
+         */
+        uint32_t overflows() const
+        {
+            return dropped;
+        }
+
+        /**
+         * @brief       Estimates a quantile
+         *
+         * @details     Nearest-rank quantile: the value of the result of rank
+         *              ceil(q * count / 1000) in ascending order. The middle of
+         *              its bucket is returned, clamped to the min and max
+         *              results, which are exact.
+         *
+         * @param[in]   permille    Quantile in per mille, e.g. 500 for the
+         *                          median and 990 for P99. 0 gives the min
+         * @return      Quantile in ppm. 0 if no result has been counted
+         */
+        int16_t quantile(uint16_t permille) const
+        {
+            if(0U == total)
+            {
+                return 0;
+            }
+
+            if(permille >= 1000U)
+            {
+                return hi;
+            }
+
+            uint32_t rank = (uint32_t)(((uint64_t)permille * total + 999U) / 1000U);
+            uint32_t seen = 0;
+
+            rank = (0U == rank) ? 1U : rank;
+
+            for(uint16_t i = 0; i < buckets; i++)
+            {
+                seen += counts[i];
+
+                if(seen >= rank)
+                {
+                    int32_t mid = (int32_t)lower(i) + (int32_t)((width(i) - 1U) / 2U);
+
+                    mid = (mid < lo) ? lo : mid;
+                    mid = (mid > hi) ? hi : mid;
+
+                    return (int16_t)mid;
+                }
+            }
+
+            return hi;
+        }
+
+        /**
+         * @brief       Lowest result. INT16_MAX if no result has been counted
+         */
+        int16_t minimum() const
+        {
+            return lo;
+        }
+
+        /**
+         * @brief       Highest result. 0 if no result has been counted
+         */
+        int16_t maximum() const
+        {
+            return hi;
+        }
+
+        /**
+         * @brief       Serializes the sketch
+         *
+         * @details     Format: "Q", format version, B, counter size in bytes,
+         *              then as unsigned LEB128 varints the count, the overflows,
+         *              the min and max, and for each non-empty bucket the gap
+         *              to the previous one and its counter, ended by a zero gap
+         *              and count. At most maxSerializedSize bytes.
+         *
+         * @param[out]  buf     Destination buffer
+         * @param[in]   len     Buffer length
+         * @return      Number of bytes written. 0 if the buffer is too small
+         */
+        size_t serialize(uint8_t * buf, size_t len) const
+        {
+            size_t pos = 0;
+            uint16_t prev = 0;
+
+            if(len < 4U)
+            {
+                return 0;
+            }
+
+            buf[pos++] = (uint8_t)'Q';
+            buf[pos++] = format;
+            buf[pos++] = B;
+            buf[pos++] = (uint8_t)sizeof(C);
+
+            bool ok = putVarint(buf, len, pos, total) && putVarint(buf, len, pos, dropped) &&
+                      putVarint(buf, len, pos, (uint16_t)lo) && putVarint(buf, len, pos, (uint16_t)hi);
+
+            for(uint16_t i = 0; ok && (i < buckets); i++)
+            {
+                if(0U != counts[i])
+                {
+                    /* Gaps are one-based, so that a zero gap ends the list */
+                    ok = putVarint(buf, len, pos, (uint32_t)(i + 1U - prev)) && putVarint(buf, len, pos, (uint32_t)counts[i]);
+                    prev = (uint16_t)(i + 1U);
+                }
+            }
+
+            ok = ok && putVarint(buf, len, pos, 0U) && putVarint(buf, len, pos, 0U);
+
+            return ok ? pos : 0U;
+        }
+
+        /**
+         * @brief       Loads a serialized sketch
+         *
+         * @param[in]   buf     Serialized sketch
+         * @param[in]   len     Serialized sketch length
+         * @return      False if the data is malformed or of another resolution
+         *              or counter size, if a bucket count does not fit the
+         *              counter type, or if the count does not match the sum of
+         *              the buckets. The sketch is then cleared
+         */
+        bool deserialize(const uint8_t * buf, size_t len)
+        {
+            size_t pos = 4;
+            uint32_t v[4];
+            uint32_t gap;
+            uint32_t cnt;
+            uint32_t sum = 0;
+            uint16_t prev = 0;
+
+            reset();
+
+            if((len < 4U) || ((uint8_t)'Q' != buf[0]) || (format != buf[1]) || (B != buf[2]) || (sizeof(C) != buf[3]))
+            {
+                return false;
+            }
+
+            for(uint8_t k = 0; k < 4U; k++)
+            {
+                if(!getVarint(buf, len, pos, v[k]))
+                {
+                    reset();
+                    return false;
+                }
+            }
+
+            while(getVarint(buf, len, pos, gap) && getVarint(buf, len, pos, cnt))
+            {
+                if(0U == gap)
+                {
+                    if(sum != v[0])
+                    {
+                        break;
+                    }
+
+                    total   = v[0];
+                    dropped = v[1];
+                    lo      = (int16_t)v[2];
+                    hi      = (int16_t)v[3];
+
+                    return true;
+                }
+
+                if((((uint32_t)prev + gap) > buckets) || (cnt > (uint32_t)(C)~(C)0) || ((sum + cnt) < sum))
+                {
+                    break;
+                }
+
+                sum += cnt;
+                prev = (uint16_t)(prev + gap);
+                counts[prev - 1U] = (C)cnt;
+            }
+
+            reset();
+
+            return false;
+        }
+
+        /**
+         * @brief       Bucket of a value
+         * @param[in]   v   Value in ppm
+         * @return      Bucket index
+         */
+        static uint16_t index(uint16_t v)
+        {
+            if(v < (2U << B))
+            {
+                return v;
+            }
+
+            uint8_t shift = 0;
+
+            while((uint16_t)(v >> shift) >= (uint16_t)(2U << B))
+            {
+                shift++;
+            }
+
+            return (uint16_t)(((uint16_t)shift << B) + (v >> shift));
+        }
+
+        /**
+         * @brief       Lowest value of a bucket
+         * @param[in]   i   Bucket index
+         */
+        static uint16_t lower(uint16_t i)
+        {
+            if(i < (2U << B))
+            {
+                return i;
+            }
+
+            uint8_t shift = (uint8_t)((i >> B) - 1U);
+
+            return (uint16_t)((i - ((uint16_t)shift << B)) << shift);
+        }
+
+        /**
+         * @brief       Number of values of a bucket
+         * @param[in]   i   Bucket index
+         */
+        static uint16_t width(uint16_t i)
+        {
+            return (i < (2U << B)) ? 1U : (uint16_t)(1U << ((i >> B) - 1U));
+        }
+
+    private:
+
+        static bool putVarint(uint8_t * buf, size_t len, size_t & pos, uint32_t v)
+        {
+            do
+            {
+                if(pos >= len)
+                {
+                    return false;
+                }
+
+                buf[pos++] = (uint8_t)((v & 0x7FU) | ((v > 0x7FU) ? 0x80U : 0U));
+                v >>= 7;
+            }
+            while(0U != v);
+
+            return true;
+        }
+
+        static bool getVarint(const uint8_t * buf, size_t len, size_t & pos, uint32_t & v)
+        {
+            v = 0;
+
+            for(uint8_t s = 0; s < 35U; s = (uint8_t)(s + 7U))
+            {
+                if(pos >= len)
+                {
+                    return false;
+                }
+
+                uint8_t b = buf[pos++];
+                v |= (uint32_t)(b & 0x7FU) << s;
+
+                if(0U == (b & 0x80U))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        C                 counts[buckets];  /**< Bucket counters */
+        uint32_t          total;            /**< Results counted */
+        uint32_t          dropped;          /**< Results not counted, bucket saturated */
+        int16_t           lo;               /**< Lowest result */
+        int16_t           hi;               /**< Highest result */
+};
+
+/** @} */
+
+#endif /** PAS_CO2_QUANTILE_INO_HPP_ **/
@@ -0,0 +1,177 @@
+/**
+ * @file        pas-co2-rate-ino.cpp
+ * @brief       XENSIV™ PAS CO2 Arduino Adaptive Measurement Rate
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "pas-co2-rate-ino.hpp"
+
+/**
+ * @brief       Longest interval between two results taken into account in s
+ */
+#define RATE_MAX_INTERVAL_S     (2UL * XENSIV_PASCO2_MEAS_RATE_MAX)
+
+/**
+ * @brief       Adaptive measurement period constructor
+ *
+ * @details     The period starts at the minimum one, and relaxes once the
+ *              results are found stable.
+ *
+ * @param[in]   minPeriodInSec  Minimum period, from 5 s
+ * @param[in]   maxPeriodInSec  Maximum period, up to 4095 s
+ * @param[in]   tolerancePPM    Change of the CO2 concentration between two
+ *                              results in ppm
+ * @param[in]   noisePPM        Noise amplitude of the results in ppm. Changes
+ *                              between two results within twice this value
+ *                              are ignored
+ * @pre         None
+ */
+PASCO2RateControl::PASCO2RateControl(int16_t minPeriodInSec, int16_t maxPeriodInSec, uint16_t tolerancePPM, uint16_t noisePPM)
+: tolerance(tolerancePPM), alarm(0)
+{
+    minPeriod = (minPeriodInSec < (int16_t)XENSIV_PASCO2_MEAS_RATE_MIN) ? (int16_t)XENSIV_PASCO2_MEAS_RATE_MIN : minPeriodInSec;
+    maxPeriod = (maxPeriodInSec > (int16_t)XENSIV_PASCO2_MEAS_RATE_MAX) ? (int16_t)XENSIV_PASCO2_MEAS_RATE_MAX : maxPeriodInSec;
+    maxPeriod = (maxPeriod < minPeriod) ? minPeriod : maxPeriod;
+    band      = (uint16_t)(2U * noisePPM);
+
+    reset(minPeriod);
+}
+
+/**
+ * @brief       Restarts the estimation
+ *
+ * @details     Forgets the previous result, e.g. after the continuous mode
+ *              has been restarted.
+ *
+ * @param[in]   periodInSec     Period the continuous mode runs with
+ * @pre         None
+ */
+void PASCO2RateControl::reset(int16_t periodInSec)
+{
+    current    = periodInSec;
+    applied    = periodInSec;
+    last       = 0;
+    lastTime   = 0;
+    anchor     = 0;
+    anchorTime = 0;
+    primed     = false;
+    rate       = 0;
+}
+
+/**
+ * @brief       Sets the alarm threshold
+ *
+ * @details     The tolerance shrinks to half the distance of the results to
+ *              the threshold.
+ *
+ * @param[in]   alarmTh     Alarm threshold in ppm. 0 disables it
+ * @pre         None
+ */
+void PASCO2RateControl::setAlarm(int16_t alarmTh)
+{
+    alarm = alarmTh;
+}
+
+/**
+ * @brief       Updates the period with a result
+ *
+ * @param[in]   co2PPM      CO2 concentration in ppm
+ * @param[in]   timestamp   Result time in ms
+ * @return      Period to use in s
+ * @pre         None
+ */
+int16_t PASCO2RateControl::update(int16_t co2PPM, uint32_t timestamp)
+{
+    if(!primed)
+    {
+        last       = co2PPM;
+        lastTime   = timestamp;
+        anchor     = co2PPM;
+        anchorTime = timestamp;
+        primed     = true;
+
+        return current;
+    }
+
+    uint32_t dt   = (timestamp - lastTime + 500U) / 1000U;
+    uint32_t span = (timestamp - anchorTime + 500U) / 1000U;
+    uint32_t step = change(co2PPM, last, dt);
+    uint32_t bend = change(co2PPM, anchor, span);
+    uint32_t tol  = tolerance;
+
+    last     = co2PPM;
+    lastTime = timestamp;
+    rate     = (step > bend) ? step : bend;
+
+    if(0 != alarm)
+    {
+        int32_t  dist = (int32_t)alarm - co2PPM;
+        uint32_t half = (uint32_t)((dist < 0) ? -dist : dist) / 2U;
+
+        tol = (half < tol) ? half : tol;
+        tol = (tol < 1U) ? 1U : tol;
+    }
+
+    /**
+     * Time to move by the tolerance, or relax while within the noise band.
+     * setMeasRate() restarts the continuous mode, which measures at once:
+     * a result well within the applied period does not relax it further
+     */
+    uint32_t relax  = ((2U * dt) >= (uint32_t)applied) ? (2U * (uint32_t)current) : (uint32_t)current;
+    uint32_t target = relax;
+
+    if(0U != rate)
+    {
+        target     = (tol * 3600U) / rate;
+        anchor     = co2PPM;
+        anchorTime = timestamp;
+    }
+
+    target = (target > relax) ? relax : target;
+    target = (target > (uint32_t)maxPeriod) ? (uint32_t)maxPeriod : target;
+    target = (target < (uint32_t)minPeriod) ? (uint32_t)minPeriod : target;
+
+    current = (int16_t)target;
+
+    return current;
+}
+
+/**
+ * @brief       Rate of change between two results in ppm per hour
+ * @return      0 if the change is within the noise band
+ */
+uint32_t PASCO2RateControl::change(int16_t co2PPM, int16_t ref, uint32_t dt) const
+{
+    int32_t  delta = (int32_t)co2PPM - ref;
+    uint32_t diff  = (uint32_t)((delta < 0) ? -delta : delta);
+
+    dt = (dt > RATE_MAX_INTERVAL_S) ? RATE_MAX_INTERVAL_S : dt;
+
+    return ((diff > band) && (0U != dt)) ? ((diff * 3600U) / dt) : 0U;
+}
+
+/**
+ * @brief       Updates the period with a result timestamped with millis()
+ *
+ * @param[in]   co2PPM      CO2 concentration in ppm
+ * @return      Period to use in s
+ * @pre         None
+ */
+int16_t PASCO2RateControl::update(int16_t co2PPM)
+{
+    return update(co2PPM, (uint32_t)millis());
+}
+
+/**
+ * @brief       Updates the period with a sample of the acquisition service
+ *
+ * @param[in]   sample      Sample from PASCO2::service()
+ * @return      Period to use in s
+ * @pre         None
+ */
+int16_t PASCO2RateControl::update(const Sample_t & sample)
+{
+    return update(sample.co2PPM, sample.timestamp);
+}
@@ -0,0 +1,147 @@
+/**
+ * @file        pas-co2-rate-ino.hpp
+ * @brief       XENSIV™ PAS CO2 Arduino Adaptive Measurement Rate
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef PAS_CO2_RATE_INO_HPP_
+#define PAS_CO2_RATE_INO_HPP_
+
+#include <stdint.h>
+#include "pas-co2-ino.hpp"
+
+/**
+ * @addtogroup co2inoapi
+ * @{
+ */
+
+/**
+ * @brief       Adaptive continuous measurement period
+ *
+ * @details     Sets the period from the rate of change of the results, so
+ *              that the CO2 concentration moves by about the tolerance
+ *              between two results: the period is long while the
+ *              concentration is stable, e.g. in an empty room, and tightens
+ *              as soon as it changes, e.g. when people arrive.
+ *
+ *              The rate of change is estimated from the change since the
+ *              previous result, and from the drift since the last change
+ *              beyond the noise band, which catches slow build-ups below
+ *              the noise of a single result. The period tightens at once to
+ *              the time the concentration takes to move by the tolerance,
+ *              and relaxes by at most a factor 2 per result while the
+ *              results stay within the noise band. Close to the alarm
+ *              threshold, the tolerance shrinks to half the distance to it,
+ *              so that a crossing is caught early.
+ *
+ *              apply() rewrites MEAS_RATE with PASCO2::setMeasRate(), which
+ *              goes through idle mode and restarts the continuous mode. The
+ *              restart measures at once, so a new period takes effect
+ *              immediately, at the cost of one extra result per change. That
+ *              result does not relax the period further.
+ *
+ *              On the meeting room week of extras/host/bench-rate.cpp, a 10
+ *              to 300 s period takes 54 % fewer results than a fixed 60 s
+ *              period, and tracks the concentration better than a fixed
+ *              120 s period, with a shorter alarm delay.
+ *
+ *              @code
+ *              PASCO2RateControl rate(10, 300);
+ *              Sample_t sample;
+ *
+ *              cotwo.startAcquisition(rate.period());
+ *
+ *              if(XENSIV_PASCO2_OK == cotwo.service(sample))
+ *              {
+ *                  rate.update(sample);
+ *                  rate.apply(cotwo);
+ *              }
+ *              @endcode
+ */
+class PASCO2RateControl
+{
+    public:
+
+        static constexpr int16_t   defaultMinSec       = 10;   /**< Default minimum period in s */
+        static constexpr int16_t   defaultMaxSec       = 300;  /**< Default maximum period in s */
+        static constexpr uint16_t  defaultTolerancePPM = 20U;  /**< Default change between two results in ppm */
+        static constexpr uint16_t  defaultNoisePPM     = 10U;  /**< Default result noise amplitude in ppm */
+
+                PASCO2RateControl   (int16_t minPeriodInSec = defaultMinSec, int16_t maxPeriodInSec = defaultMaxSec,
+                                     uint16_t tolerancePPM = defaultTolerancePPM, uint16_t noisePPM = defaultNoisePPM);
+        void    reset               (int16_t periodInSec);
+        void    setAlarm            (int16_t alarmTh);
+        int16_t update              (int16_t co2PPM, uint32_t timestamp);
+        int16_t update              (int16_t co2PPM);
+        int16_t update              (const Sample_t & sample);
+        template<typename Transport>
+        Error_t apply               (PASCO2<Transport> & sensor);
+
+        /**
+         * @brief   Period to use in s
+         */
+        int16_t period              () const { return current; }
+
+        /**
+         * @brief   True if the period differs from the one last applied
+         */
+        bool    pending             () const { return current != applied; }
+
+        /**
+         * @brief   Last rate of change estimate beyond the noise band in ppm per hour
+         */
+        uint32_t slope              () const { return rate; }
+
+    private:
+
+        uint32_t    change          (int16_t co2PPM, int16_t ref, uint32_t dt) const;
+
+        int16_t     minPeriod;      /**< Minimum period in s */
+        int16_t     maxPeriod;      /**< Maximum period in s */
+        uint16_t    tolerance;      /**< Change between two results in ppm */
+        uint16_t    band;           /**< Noise band of the change between two results in ppm */
+        int16_t     alarm;          /**< Alarm threshold in ppm. 0 if none */
+        int16_t     current;        /**< Period to use in s */
+        int16_t     applied;        /**< Period last applied in s. 0 if none */
+        int16_t     last;           /**< Previous result in ppm */
+        uint32_t    lastTime;       /**< Previous result time in ms */
+        int16_t     anchor;         /**< Result of the last change beyond the noise band in ppm */
+        uint32_t    anchorTime;     /**< Result time of the last change beyond the noise band in ms */
+        bool        primed;         /**< A previous result is held */
+        uint32_t    rate;           /**< Last rate of change estimate in ppm per hour */
+};
+
+/**
+ * @brief       Applies the period to a sensor
+ *
+ * @details     Rewrites MEAS_RATE if the period has changed since it was
+ *              last applied.
+ *
+ * @param[in]   sensor  Sensor in continuous mode
+ * @return      XENSIV™ PAS CO2 error code
+ * @retval      XENSIV_PASCO2_OK if success or nothing to apply
+ * @pre         The sensor continuous mode is started with period()
+ */
+template<typename Transport>
+Error_t PASCO2RateControl::apply(PASCO2<Transport> & sensor)
+{
+    Error_t ret = XENSIV_PASCO2_OK;
+
+    if(current != applied)
+    {
+        ret = sensor.setMeasRate(current);
+
+        if(XENSIV_PASCO2_OK == ret)
+        {
+            applied = current;
+        }
+    }
+
+    return ret;
+}
+
+/** @} */
+
+#endif /** PAS_CO2_RATE_INO_HPP_ **/
@@ -0,0 +1,131 @@
+/**
+ * @file        pas-co2-ring-ino.hpp
+ * @brief       XENSIV™ PAS CO2 Arduino Lock-Free Ring Buffer
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef PAS_CO2_RING_INO_HPP_
+#define PAS_CO2_RING_INO_HPP_
+
+#include <stdint.h>
+
+/**
+ * @addtogroup co2inoapi
+ * @{
+ */
+
+/**
+ * @brief       Single-producer/single-consumer ring buffer
+ *
+ * @details     Fixed-capacity FIFO without dynamic allocation. One context
+ *              pushes (e.g. PASCO2Ino::service() in the main loop) and another
+ *              one pops (e.g. a task or the same loop at a lower rate).
+ *              Neither side ever blocks or takes a lock: the producer drops
+ *              the element and counts the overrun when the buffer is full.
+ *
+ *              The indices are free-running 8-bit counters, which are read and
+ *              written atomically on every Arduino architecture.
+ *
+ * @tparam      T   Element type
+ * @tparam      N   Capacity. Power of two, up to 128
+ */
+template<typename T, uint8_t N>
+class PASCO2Ring
+{
+    static_assert((N > 0U) && (N <= 128U) && ((N & (N - 1U)) == 0U), "ring capacity must be a power of two up to 128");
+
+    public:
+
+        PASCO2Ring() : head(0), tail(0), overruns(0) { }
+
+        /**
+         * @brief       Pushes an element
+         * @note        Producer side only
+         * @param[in]   elem    Element to push
+         * @return      False if the buffer is full and the element has been dropped
+         */
+        bool push(const T & elem)
+        {
+            uint8_t h = head;
+
+            if((uint8_t)(h - __atomic_load_n(&tail, __ATOMIC_ACQUIRE)) >= N)
+            {
+                overruns++;
+                return false;
+            }
+
+            buf[h & (N - 1U)] = elem;
+            __atomic_store_n(&head, (uint8_t)(h + 1U), __ATOMIC_RELEASE);
+
+            return true;
+        }
+
+        /**
+         * @brief       Pops the oldest element
+         * @note        Consumer side only
+         * @param[out]  elem    Element popped
+         * @return      False if the buffer is empty
+         */
+        bool pop(T & elem)
+        {
+            return (1U == drain(&elem, 1U));
+        }
+
+        /**
+         * @brief       Pops up to max elements in a batch
+         * @note        Consumer side only
+         * @param[out]  out     Destination array of at least max elements
+         * @param[in]   max     Maximum number of elements to pop
+         * @return      Number of elements popped
+         */
+        uint8_t drain(T * out, uint8_t max)
+        {
+            uint8_t t = tail;
+            uint8_t n = (uint8_t)(__atomic_load_n(&head, __ATOMIC_ACQUIRE) - t);
+
+            if(n > max)
+            {
+                n = max;
+            }
+
+            for(uint8_t i = 0; i < n; i++)
+            {
+                out[i] = buf[(uint8_t)(t + i) & (N - 1U)];
+            }
+
+            __atomic_store_n(&tail, (uint8_t)(t + n), __ATOMIC_RELEASE);
+
+            return n;
+        }
+
+        /**
+         * @brief       Number of elements ready to be popped
+         */
+        uint8_t available() const
+        {
+            return (uint8_t)(__atomic_load_n(&head, __ATOMIC_ACQUIRE) - __atomic_load_n(&tail, __ATOMIC_ACQUIRE));
+        }
+
+        /**
+         * @brief       Number of elements dropped because the buffer was full
+         */
+        uint16_t dropped() const
+        {
+            return overruns;
+        }
+
+        static constexpr uint8_t capacity = N;  /**< Ring capacity */
+
+    private:
+
+        T                 buf[N];       /**< Element storage */
+        uint8_t           head;         /**< Producer index */
+        uint8_t           tail;         /**< Consumer index */
+        uint16_t          overruns;     /**< Dropped elements counter */
+};
+
+/** @} */
+
+#endif /** PAS_CO2_RING_INO_HPP_ **/
@@ -0,0 +1,456 @@
+/**
+ * @file        pas-co2-rollup-ino.hpp
+ * @brief       XENSIV™ PAS CO2 Arduino Multi-Resolution Rollup
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef PAS_CO2_ROLLUP_INO_HPP_
+#define PAS_CO2_ROLLUP_INO_HPP_
+
+#include <stdint.h>
+#include "pas-co2-ino.hpp"
+
+/**
+ * @addtogroup co2inoapi
+ * @{
+ */
+
+/**
+ * @brief   Aggregate of the results of a time bin
+ */
+typedef struct
+{
+    int32_t     sum;        /**< Sum of the results in ppm */
+    uint32_t    area;       /**< Time integral of the results in ppm.s. Wraps around beyond 2^32, e.g. a week above 7000 ppm */
+    uint32_t    covered;    /**< Time covered by the integral in s */
+    uint32_t    count;      /**< Number of results */
+    int16_t     minimum;    /**< Lowest result. INT16_MAX if none */
+    int16_t     maximum;    /**< Highest result. INT16_MIN if none */
+} Rollup_t;
+
+/**
+ * @brief   Rollup tier
+ */
+typedef enum
+{
+    ROLLUP_MINUTE = 0,      /**< One minute bins */
+    ROLLUP_HOUR,            /**< One hour bins */
+    ROLLUP_DAY              /**< One day bins */
+} RollupTier_t;
+
+/**
+ * @brief       Multi-resolution rollup of the CO2 concentration
+ *
+ * @details     Aggregates the results of the continuous mode into minute,
+ *              hour and day bins, each tier keeping its last bins in a ring
+ *              buffer. A bin holds the count, min, max and sum of its
+ *              results, and their time integral, from which the time
+ *              weighted average (TWA) follows.
+ *
+ *              A result updates the open minute bin only. When a minute
+ *              bin closes, it is pushed into the minute ring and merged
+ *              into the open hour bin, which in turn is pushed and merged
+ *              into the open day bin when it closes. Each result and each
+ *              bin closing is then a constant amount of work, and the raw
+ *              results are never scanned again.
+ *
+ *              Each result is held until the next one for the time
+ *              integral, at most 2.5 periods, so that a missed result is
+ *              bridged but the time the sensor is off is not counted. The
+ *              bins are aligned on the timestamp clock, millis() by default.
+ *
+ *              window() and twa() combine the bins of the finest tier
+ *              reaching back over the requested window, e.g. the 8-hour TWA
+ *              exposure from the last 9 hour bins at most:
+ *
+ *              @code
+ *              PASCO2Rollup<60, 24, 7> rollup(60);
+ *              Sample_t sample;
+ *
+ *              cotwo.startAcquisition(60);
+ *
+ *              if(XENSIV_PASCO2_OK == cotwo.service(sample))
+ *              {
+ *                  rollup.update(sample);
+ *                  Serial.println(rollup.twa(8UL * 3600000UL));
+ *              }
+ *              @endcode
+ *
+ *              A bin takes 20 bytes, e.g. 1.8 KB for the last hour of
+ *              minutes, the last day of hours and the last week of days.
+ *
+ * @tparam      M   Minute bins kept, up to 1440
+ * @tparam      H   Hour bins kept, up to 255
+ * @tparam      D   Day bins kept, up to 255
+ */
+template<uint16_t M = 60, uint8_t H = 24, uint8_t D = 7>
+class PASCO2Rollup
+{
+    static_assert((M > 0U) && (M <= 1440U) && (H > 0U) && (D > 0U), "each tier keeps 1 to 1440 minutes, 255 hours, 255 days");
+
+    public:
+
+        static constexpr uint32_t minuteMs = 60000UL;       /**< Minute bin width in ms */
+        static constexpr uint32_t hourMs   = 3600000UL;     /**< Hour bin width in ms */
+        static constexpr uint32_t dayMs    = 86400000UL;    /**< Day bin width in ms */
+
+        /**
+         * @brief       Rollup constructor
+         * @param[in]   periodInSec Continuous measurement period of startMeasure() or startAcquisition()
+         */
+        PASCO2Rollup(int16_t periodInSec)
+        : holdMs(((uint32_t)periodInSec * 5000UL) / 2U)
+        {
+            reset();
+        }
+
+        /**
+         * @brief       Clears all the tiers
+         */
+        void reset()
+        {
+            started = false;
+            lastMs  = 0;
+            lastPPM = 0;
+            areaMs  = 0;
+            coverMs = 0;
+
+            clear(openMin);
+            clear(openHour);
+            clear(openDay);
+
+            minRing.head  = 0;
+            minRing.fill  = 0;
+            hourRing.head = 0;
+            hourRing.fill = 0;
+            dayRing.head  = 0;
+            dayRing.fill  = 0;
+        }
+
+        /**
+         * @brief       Adds a result
+         * @param[in]   co2PPM      CO2 concentration in ppm
+         * @param[in]   timestamp   Result time in ms, not before the previous one
+         */
+        void update(int16_t co2PPM, uint32_t timestamp)
+        {
+            if(!started)
+            {
+                started   = true;
+                minStart  = timestamp - (timestamp % minuteMs);
+                hourStart = timestamp - (timestamp % hourMs);
+                dayStart  = timestamp - (timestamp % dayMs);
+            }
+            else
+            {
+                /* The previous result held until this one, split at the minute bounds */
+                uint32_t ppm  = (lastPPM < 0) ? 0U : (uint32_t)lastPPM;
+                uint32_t from = lastMs;
+
+                while(((timestamp - lastMs) <= holdMs) && (from != timestamp))
+                {
+                    advance(from);
+
+                    uint32_t left = minuteMs - (from - minStart);
+                    uint32_t span = ((timestamp - from) < left) ? (timestamp - from) : left;
+
+                    areaMs  += ppm * span;
+                    coverMs += span;
+                    from    += span;
+                }
+
+                advance(timestamp);
+            }
+
+            openMin.count++;
+            openMin.sum     += co2PPM;
+            openMin.minimum  = (co2PPM < openMin.minimum) ? co2PPM : openMin.minimum;
+            openMin.maximum  = (co2PPM > openMin.maximum) ? co2PPM : openMin.maximum;
+
+            lastMs  = timestamp;
+            lastPPM = co2PPM;
+        }
+
+        /**
+         * @brief       Adds a result timestamped with millis()
+         * @param[in]   co2PPM  CO2 concentration in ppm
+         */
+        void update(int16_t co2PPM)
+        {
+            update(co2PPM, (uint32_t)millis());
+        }
+
+        /**
+         * @brief       Adds an acquired sample
+         * @param[in]   sample  Sample from service()
+         */
+        void update(const Sample_t & sample)
+        {
+            update(sample.co2PPM, sample.timestamp);
+        }
+
+        /**
+         * @brief       Number of bins held in a tier, the open one included
+         * @param[in]   tier    Rollup tier
+         */
+        uint16_t bins(RollupTier_t tier) const
+        {
+            if(!started)
+            {
+                return 0;
+            }
+
+            return (uint16_t)(1U + ((ROLLUP_MINUTE == tier) ? minRing.fill : ((ROLLUP_HOUR == tier) ? hourRing.fill : dayRing.fill)));
+        }
+
+        /**
+         * @brief       Gets a bin
+         *
+         * @param[in]   tier    Rollup tier
+         * @param[in]   age     0 for the open bin, 1 for the last closed one, etc.
+         * @param[out]  agg     Bin aggregate
+         * @param[out]  start   Bin start time in ms. Optional
+         * @return      False if the bin is not held
+         */
+        bool bin(RollupTier_t tier, uint16_t age, Rollup_t & agg, uint32_t * start = nullptr) const
+        {
+            if(age >= bins(tier))
+            {
+                return false;
+            }
+
+            uint32_t width = (ROLLUP_MINUTE == tier) ? minuteMs : ((ROLLUP_HOUR == tier) ? hourMs : dayMs);
+            uint32_t open  = (ROLLUP_MINUTE == tier) ? minStart : ((ROLLUP_HOUR == tier) ? hourStart : dayStart);
+
+            if(0U == age)
+            {
+                agg = (ROLLUP_MINUTE == tier) ? openMinute() : ((ROLLUP_HOUR == tier) ? openHour : openDay);
+            }
+            else
+            {
+                agg = (ROLLUP_MINUTE == tier) ? minRing.at(age) : ((ROLLUP_HOUR == tier) ? hourRing.at(age) : dayRing.at(age));
+            }
+
+            if(nullptr != start)
+            {
+                *start = open - (width * age);
+            }
+
+            return true;
+        }
+
+        /**
+         * @brief       Aggregates the last results
+         *
+         * @details     Combines the bins overlapping the window ending at the
+         *              last result, from the finest tier holding it all: the
+         *              minute bins, else the open minute and hour bins and the
+         *              hour bins, else the open bins and the day bins. The
+         *              window is thus rounded up to whole bins of that tier,
+         *              e.g. 8 to 9 hours.
+         *
+         * @param[in]   windowMs    Window length in ms
+         * @param[out]  agg         Aggregate of the window
+         */
+        void window(uint32_t windowMs, Rollup_t & agg) const
+        {
+            agg = openMinute();
+
+            if(!started)
+            {
+                return;
+            }
+
+            uint32_t from = lastMs - windowMs;
+
+            if(windowMs <= ((lastMs - minStart) + (minRing.fill * minuteMs)))
+            {
+                merge(agg, minRing, minStart, minuteMs, from);
+                return;
+            }
+
+            merge(agg, openHour);
+
+            if(windowMs <= ((lastMs - hourStart) + (hourRing.fill * hourMs)))
+            {
+                merge(agg, hourRing, hourStart, hourMs, from);
+                return;
+            }
+
+            merge(agg, openDay);
+            merge(agg, dayRing, dayStart, dayMs, from);
+        }
+
+        /**
+         * @brief       Time weighted average of the last results
+         * @param[in]   windowMs    Window length in ms. See window()
+         * @return      TWA in ppm. 0 if no time is covered
+         */
+        int16_t twa(uint32_t windowMs) const
+        {
+            Rollup_t agg;
+
+            window(windowMs, agg);
+
+            return twa(agg);
+        }
+
+        /**
+         * @brief       Mean of the results of an aggregate
+         * @return      Mean rounded to ppm. 0 if no result
+         */
+        static int16_t mean(const Rollup_t & agg)
+        {
+            if(0U == agg.count)
+            {
+                return 0;
+            }
+
+            int32_t half = (agg.sum < 0) ? -(int32_t)(agg.count / 2U) : (int32_t)(agg.count / 2U);
+
+            return (int16_t)((agg.sum + half) / (int32_t)agg.count);
+        }
+
+        /**
+         * @brief       Time weighted average of an aggregate
+         * @return      TWA rounded to ppm. 0 if no time is covered
+         */
+        static int16_t twa(const Rollup_t & agg)
+        {
+            return (0U == agg.covered) ? 0 : (int16_t)((agg.area + (agg.covered / 2U)) / agg.covered);
+        }
+
+    private:
+
+        /**
+         * @brief   Ring of the closed bins of a tier
+         */
+        template<uint16_t N>
+        struct Ring
+        {
+            Rollup_t    bins[N];    /**< Closed bins */
+            uint16_t    head;       /**< Next bin */
+            uint16_t    fill;       /**< Bins held */
+
+            void push(const Rollup_t & bin)
+            {
+                bins[head] = bin;
+                head = (uint16_t)((head + 1U) % N);
+                fill = (fill < N) ? (uint16_t)(fill + 1U) : fill;
+            }
+
+            /* Age 1 is the last bin pushed */
+            const Rollup_t & at(uint16_t age) const
+            {
+                return bins[(head + N - age) % N];
+            }
+        };
+
+        static void clear(Rollup_t & bin)
+        {
+            bin.sum     = 0;
+            bin.area    = 0;
+            bin.covered = 0;
+            bin.count   = 0;
+            bin.minimum = INT16_MAX;
+            bin.maximum = INT16_MIN;
+        }
+
+        static void merge(Rollup_t & into, const Rollup_t & bin)
+        {
+            into.sum     += bin.sum;
+            into.area    += bin.area;
+            into.covered += bin.covered;
+            into.count   += bin.count;
+            into.minimum  = (bin.minimum < into.minimum) ? bin.minimum : into.minimum;
+            into.maximum  = (bin.maximum > into.maximum) ? bin.maximum : into.maximum;
+        }
+
+        /**
+         * @brief   Merges the closed bins ending after a time
+         */
+        template<uint16_t N>
+        static void merge(Rollup_t & into, const Ring<N> & ring, uint32_t open, uint32_t width, uint32_t from)
+        {
+            for(uint16_t age = 1; age <= ring.fill; age++)
+            {
+                /* Bin end at or before the window start */
+                if((int32_t)((open - (width * (age - 1U))) - from) <= 0)
+                {
+                    break;
+                }
+
+                merge(into, ring.at(age));
+            }
+        }
+
+        /**
+         * @brief   Open minute bin, its time integral converted to ppm.s
+         */
+        Rollup_t openMinute() const
+        {
+            Rollup_t bin = openMin;
+
+            bin.area    = (areaMs + 500U) / 1000U;
+            bin.covered = (coverMs + 500U) / 1000U;
+
+            return bin;
+        }
+
+        /**
+         * @brief   Closes the bins ending at or before a time
+         */
+        void advance(uint32_t t)
+        {
+            while((t - minStart) >= minuteMs)
+            {
+                Rollup_t bin = openMinute();
+
+                minRing.push(bin);
+                merge(openHour, bin);
+                clear(openMin);
+                areaMs    = 0;
+                coverMs   = 0;
+                minStart += minuteMs;
+
+                if((minStart - hourStart) >= hourMs)
+                {
+                    hourRing.push(openHour);
+                    merge(openDay, openHour);
+                    clear(openHour);
+                    hourStart += hourMs;
+
+                    if((hourStart - dayStart) >= dayMs)
+                    {
+                        dayRing.push(openDay);
+                        clear(openDay);
+                        dayStart += dayMs;
+                    }
+                }
+            }
+        }
+
+        uint32_t        holdMs;     /**< Longest time a result is held in ms */
+        bool            started;    /**< First result added */
+        uint32_t        lastMs;     /**< Last result time in ms */
+        int16_t         lastPPM;    /**< Last result */
+
+        uint32_t        minStart;   /**< Open minute bin start in ms */
+        uint32_t        hourStart;  /**< Open hour bin start in ms */
+        uint32_t        dayStart;   /**< Open day bin start in ms */
+        uint32_t        areaMs;     /**< Open minute bin integral in ppm.ms */
+        uint32_t        coverMs;    /**< Open minute bin covered time in ms */
+
+        Rollup_t        openMin;    /**< Open minute bin, integral apart */
+        Rollup_t        openHour;   /**< Open hour bin, closed minutes merged */
+        Rollup_t        openDay;    /**< Open day bin, closed hours merged */
+        Ring<M>         minRing;    /**< Closed minute bins */
+        Ring<H>         hourRing;   /**< Closed hour bins */
+        Ring<D>         dayRing;    /**< Closed day bins */
+};
+
+/** @} */
+
+#endif /** PAS_CO2_ROLLUP_INO_HPP_ **/
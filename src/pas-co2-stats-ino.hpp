@@ -0,0 +1,409 @@
+/**
+ * @file        pas-co2-stats-ino.hpp
+ * @brief       XENSIV™ PAS CO2 Arduino Streaming Statistics
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef PAS_CO2_STATS_INO_HPP_
+#define PAS_CO2_STATS_INO_HPP_
+
+#include <stdint.h>
+#include "pas-co2-ino.hpp"
+
+/**
+ * @addtogroup co2inoapi
+ * @{
+ */
+
+/**
+ * @brief       Streaming statistics of the CO2 concentration
+ *
+ * @details     Fed one result at a time, e.g. from getCO2() or service(),
+ *              and without dynamic allocation. The memory is fixed by the
+ *              window length: 2 bytes per window sample plus about 50 bytes.
+ *              - Moving average over the last W results
+ *              - Exponential moving average with a time constant in ms,
+ *                following the result timestamps, so that irregular
+ *                intervals are weighted correctly
+ *              - Min and max
+ *              - Mean, variance and standard deviation
+ *
+ *              Only integer arithmetic is used, no floating-point emulation
+ *              is pulled in on AVR. The averages are kept in Q8 fixed point
+ *              (1/256 ppm). update() multiplies in 32 bits and only adds to
+ *              the 64-bit deviation sums. It does not divide, except for a
+ *              32-bit division of the exponential moving average weight when
+ *              the interval between two results changes. The intervals are
+ *              compared on their dtBits most significant bits, so that the
+ *              jitter of the result timestamps does not trigger the division.
+ *              The 64-bit divisions are left to meanQ8() and varianceQ8().
+ *
+ *              The variance is computed in one pass from the sums of the
+ *              deviations to the first result and of their squares. Both are
+ *              exact integers, so there is neither the rounding drift of a
+ *              fixed-point Welford update nor a division per result. The sums
+ *              hold at least 2^56 / 32767² (about 67 million) results; with
+ *              deviations within 2000 ppm, the whole 32-bit result count.
+ *
+ *              @code
+ *              PASCO2Stats<16> stats(300000);    // 5 min time constant
+ *
+ *              if(XENSIV_PASCO2_OK == cotwo.getCO2(co2))
+ *              {
+ *                  stats.update(co2);
+ *                  Serial.println(stats.ema());
+ *              }
+ *              @endcode
+ *
+ * @tparam      W   Moving average window. Power of two, up to 128
+ */
+template<uint8_t W>
+class PASCO2Stats
+{
+    static_assert((W > 0U) && (W <= 128U) && ((W & (W - 1U)) == 0U), "window must be a power of two up to 128");
+
+    public:
+
+        static constexpr uint32_t defaultTauMs = 60000U;    /**< Default EMA time constant in ms */
+        static constexpr uint8_t  window = W;               /**< Moving average window */
+        static constexpr uint8_t  dtBits = 8;               /**< Significant bits of the interval the EMA weight is computed for */
+
+        /**
+         * @brief       Streaming statistics constructor
+         * @param[in]   tauMs   EMA time constant in ms
+         */
+        PASCO2Stats(uint32_t tauMs = defaultTauMs) : tau(tauMs)
+        {
+            reset();
+        }
+
+        /**
+         * @brief       Clears all the statistics
+         * @note        The EMA time constant is kept
+         */
+        void reset()
+        {
+            head    = 0;
+            filled  = 0;
+            sum     = 0;
+            emaQ    = 0;
+            last    = 0;
+            lastDt  = 0;
+            alpha   = 0;
+            n       = 0;
+            lo      = INT16_MAX;
+            hi      = INT16_MIN;
+            shift   = 0;
+            dev     = 0;
+            dev2    = 0;
+        }
+
+        /**
+         * @brief       Sets the EMA time constant
+         * @details     The EMA weight of a result taken dt ms after the previous
+         *              one is dt / (tau + dt), the backward Euler step of a first
+         *              order low-pass filter with time constant tau.
+         * @param[in]   tauMs   Time constant in ms. 0 follows the last result
+         */
+        void setTimeConstant(uint32_t tauMs)
+        {
+            tau    = tauMs;
+            lastDt = 0;
+            alpha  = 0;
+        }
+
+        /**
+         * @brief       Adds a result
+         * @param[in]   co2PPM      CO2 concentration in ppm
+         * @param[in]   timestamp   Result time in ms
+         */
+        void update(int16_t co2PPM, uint32_t timestamp)
+        {
+            /* Moving average */
+            if(filled == W)
+            {
+                sum -= buf[head];
+            }
+            else
+            {
+                filled++;
+            }
+
+            buf[head] = co2PPM;
+            sum      += co2PPM;
+            head      = (uint8_t)((head + 1U) & (W - 1U));
+
+            /* Exponential moving average */
+            int32_t xQ = (int32_t)co2PPM << 8;
+
+            if(0U == n)
+            {
+                emaQ = xQ;
+            }
+            else
+            {
+                uint32_t dt = quantize(timestamp - last);
+
+                if(dt != lastDt)
+                {
+                    lastDt = dt;
+                    alpha  = weight(dt, tau);
+                }
+
+                /**
+                 * Both terms are within int16 in Q8, so |diff| < 2^24. diff * alpha
+                 * is split on the 8 low bits of diff so that each partial product
+                 * fits in 32 bits, giving the same result as (diff * alpha) >> 15.
+                 */
+                int32_t diff = xQ - emaQ;
+                int32_t step = ((diff >> 8) * (int32_t)alpha) + (int32_t)(((uint32_t)(diff & 0xFF) * alpha) >> 8);
+
+                emaQ += step >> 7;
+            }
+
+            last = timestamp;
+
+            /* Min and max */
+            lo = (co2PPM < lo) ? co2PPM : lo;
+            hi = (co2PPM > hi) ? co2PPM : hi;
+
+            /* Deviation sums to the first result */
+            if(0U == n)
+            {
+                shift = co2PPM;
+            }
+
+            int32_t  d  = (int32_t)co2PPM - shift;
+            uint32_t ad = (uint32_t)((d < 0) ? -d : d);
+
+            dev  += d;
+            dev2 += ad * ad;
+            n++;
+        }
+
+        /**
+         * @brief       Adds a result timestamped with millis()
+         * @param[in]   co2PPM  CO2 concentration in ppm
+         */
+        void update(int16_t co2PPM)
+        {
+            update(co2PPM, (uint32_t)millis());
+        }
+
+        /**
+         * @brief       Adds an acquired sample
+         * @param[in]   sample  Sample from service()
+         */
+        void update(const Sample_t & sample)
+        {
+            update(sample.co2PPM, sample.timestamp);
+        }
+
+        /**
+         * @brief       Number of results added since the last reset
+         */
+        uint32_t count() const
+        {
+            return n;
+        }
+
+        /**
+         * @brief       Moving average over the last W results, in Q8 ppm
+         * @return      0 if no result has been added
+         */
+        int32_t averageQ8() const
+        {
+            return (0U == filled) ? 0 : (int32_t)(((int64_t)sum << 8) / filled);
+        }
+
+        /**
+         * @brief       Moving average over the last W results, rounded to ppm
+         */
+        int16_t average() const
+        {
+            return roundQ8(averageQ8());
+        }
+
+        /**
+         * @brief       Exponential moving average, in Q8 ppm
+         */
+        int32_t emaQ8() const
+        {
+            return emaQ;
+        }
+
+        /**
+         * @brief       Exponential moving average, rounded to ppm
+         */
+        int16_t ema() const
+        {
+            return roundQ8(emaQ);
+        }
+
+        /**
+         * @brief       Lowest result. INT16_MAX if no result has been added
+         */
+        int16_t minimum() const
+        {
+            return lo;
+        }
+
+        /**
+         * @brief       Highest result. INT16_MIN if no result has been added
+         */
+        int16_t maximum() const
+        {
+            return hi;
+        }
+
+        /**
+         * @brief       Mean of all the results, in Q8 ppm
+         */
+        int32_t meanQ8() const
+        {
+            return (0U == n) ? 0 : (int32_t)(((int32_t)shift << 8) + (((int64_t)dev << 8) / (int64_t)n));
+        }
+
+        /**
+         * @brief       Mean of all the results, rounded to ppm
+         */
+        int16_t mean() const
+        {
+            return roundQ8(meanQ8());
+        }
+
+        /**
+         * @brief       Sample variance of all the results, in Q8 ppm²
+         * @return      0 below two results
+         */
+        uint64_t varianceQ8() const
+        {
+            if(n < 2U)
+            {
+                return 0;
+            }
+
+            /**
+             * Sum of the squared deviations to the mean: dev2 - dev^2 / n.
+             * dev^2 overflows 64 bits, so with |dev| = q * n + r:
+             * dev^2 / n = q * |dev| + q * r + r^2 / n
+             */
+            uint64_t a    = (uint64_t)((dev < 0) ? -dev : dev);
+            uint64_t q    = a / n;
+            uint64_t r    = a % n;
+            uint64_t rr   = r * r;
+            uint64_t m2Q8 = ((dev2 - (q * a) - (q * r) - (rr / n)) << 8) - (((rr % n) << 8) / n);
+
+            return m2Q8 / (n - 1U);
+        }
+
+        /**
+         * @brief       Sample variance of all the results, in ppm²
+         */
+        uint32_t variance() const
+        {
+            uint64_t v = (varianceQ8() + 0x80U) >> 8;
+
+            return (v > UINT32_MAX) ? UINT32_MAX : (uint32_t)v;
+        }
+
+        /**
+         * @brief       Sample standard deviation of all the results, in Q8 ppm
+         */
+        uint32_t stddevQ8() const
+        {
+            /* sqrt(variance in Q16) is the deviation in Q8 */
+            return isqrt(varianceQ8() << 8);
+        }
+
+        /**
+         * @brief       Sample standard deviation of all the results, rounded to ppm
+         */
+        uint16_t stddev() const
+        {
+            return (uint16_t)((stddevQ8() + 0x80U) >> 8);
+        }
+
+    private:
+
+        static int16_t roundQ8(int32_t q)
+        {
+            return (int16_t)((q + 0x80) >> 8);
+        }
+
+        static uint32_t quantize(uint32_t dt)
+        {
+            uint8_t s = 0;
+
+            while((dt >> s) >= (1UL << dtBits))
+            {
+                s++;
+            }
+
+            return (dt >> s) << s;
+        }
+
+        static uint16_t weight(uint32_t dt, uint32_t tau)
+        {
+            /* dt / (tau + dt) in Q15, in 32 bits: both are scaled down alike until dt << 15 and tau + dt fit */
+            while((dt >= 0x10000UL) || (tau >= 0x80000000UL))
+            {
+                dt  >>= 1;
+                tau >>= 1;
+            }
+
+            return (0U == (tau + dt)) ? (uint16_t)0x8000U : (uint16_t)((dt << 15) / (tau + dt));
+        }
+
+        static uint32_t isqrt(uint64_t v)
+        {
+            uint64_t r   = 0;
+            uint64_t bit = (uint64_t)1U << 62;
+
+            while(bit > v)
+            {
+                bit >>= 2;
+            }
+
+            while(0U != bit)
+            {
+                if(v >= (r + bit))
+                {
+                    v -= r + bit;
+                    r  = (r >> 1) + bit;
+                }
+                else
+                {
+                    r >>= 1;
+                }
+
+                bit >>= 2;
+            }
+
+            return (uint32_t)r;
+        }
+
+        int16_t           buf[W];   /**< Moving average window */
+        uint8_t           head;     /**< Next window position */
+        uint8_t           filled;   /**< Results in the window */
+        int32_t           sum;      /**< Window sum */
+
+        uint32_t          tau;      /**< EMA time constant in ms */
+        int32_t           emaQ;     /**< EMA in Q8 */
+        uint32_t          last;     /**< Previous result time in ms */
+        uint32_t          lastDt;   /**< Quantized interval the EMA weight was computed for */
+        uint16_t          alpha;    /**< EMA weight in Q15 */
+
+        uint32_t          n;        /**< Results added */
+        int16_t           lo;       /**< Lowest result */
+        int16_t           hi;       /**< Highest result */
+        int16_t           shift;    /**< First result, reference of the deviations */
+        int64_t           dev;      /**< Sum of the deviations */
+        uint64_t          dev2;     /**< Sum of the squared deviations */
+};
+
+/** @} */
+
+#endif /** PAS_CO2_STATS_INO_HPP_ **/
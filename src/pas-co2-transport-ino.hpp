@@ -0,0 +1,122 @@
+/**
+ * @file        pas-co2-transport-ino.hpp
+ * @brief       XENSIV™ PAS CO2 Arduino Serial Transports
+ * @copyright   Copyright (c) 2020-2021 Infineon Technologies AG
+ *
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef PAS_CO2_TRANSPORT_INO_HPP_
+#define PAS_CO2_TRANSPORT_INO_HPP_
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <HardwareSerial.h>
+#include "xensiv_pasco2.h"
+
+/**
+ * @addtogroup co2inoapi
+ * @{
+ */
+
+/**
+ * @brief       I2C transport of PASCO2
+ *
+ * @details     Only the I2C protocol of the corelib and of the PAL is
+ *              referenced, so that the UART code is not linked.
+ */
+class PASCO2I2C
+{
+    public:
+
+        PASCO2I2C(TwoWire * wire = &Wire) : wire(wire) { }
+
+        int32_t           begin   (xensiv_pasco2_t * dev);
+        void              end     ();
+
+        /**
+         * @brief       UART interface of the transport
+         * @return      Always nullptr
+         */
+        HardwareSerial  * serial  () const { return nullptr; }
+
+        /**
+         * @brief       Serial bus of the transport
+         */
+        void            * bus     () const { return wire; }
+
+    private:
+
+        static constexpr uint32_t freqHz = 100000;    /**< I2C frequency in Hz*/
+
+        TwoWire         * wire;     /**< I2C interface */
+};
+
+/**
+ * @brief       UART transport of PASCO2
+ *
+ * @details     Only the UART protocol of the corelib and of the PAL is
+ *              referenced, so that the I2C code is not linked.
+ */
+class PASCO2UART
+{
+    public:
+
+        PASCO2UART(HardwareSerial * uart) : uart(uart) { }
+
+        int32_t           begin   (xensiv_pasco2_t * dev);
+        void              end     ();
+
+        /**
+         * @brief       UART interface of the transport
+         */
+        HardwareSerial  * serial  () const { return uart; }
+
+        /**
+         * @brief       Serial bus of the transport
+         */
+        void            * bus     () const { return uart; }
+
+    private:
+
+        static constexpr uint16_t baudrateBps = 9600;  /**< UART baud rate in bps */
+
+        HardwareSerial  * uart;     /**< UART interface */
+};
+
+/**
+ * @brief       Run-time selected transport of PASCO2
+ *
+ * @details     The interface is chosen by the constructor argument. Both the
+ *              I2C and the UART protocols are linked.
+ */
+class PASCO2Dual
+{
+    public:
+
+        PASCO2Dual(TwoWire * wire = &Wire) : wire(wire), uart(nullptr) { }
+        PASCO2Dual(HardwareSerial * serial) : wire(nullptr), uart(serial) { }
+
+        int32_t           begin   (xensiv_pasco2_t * dev);
+        void              end     ();
+
+        /**
+         * @brief       UART interface of the transport
+         * @return      nullptr if the I2C interface is used
+         */
+        HardwareSerial  * serial  () const { return uart; }
+
+        /**
+         * @brief       Serial bus of the transport
+         */
+        void            * bus     () const { return (nullptr != wire) ? (void *)wire : (void *)uart; }
+
+    private:
+
+        TwoWire         * wire;     /**< I2C interface. nullptr if the UART interface is used */
+        HardwareSerial  * uart;     /**< UART interface. nullptr if the I2C interface is used */
+};
+
+/** @} */
+
+#endif /** PAS_CO2_TRANSPORT_INO_HPP_ **/
@@ -23,22 +23,33 @@
  **************************************************************************************************/
 
 #include <assert.h>
+#include <string.h>
 
 #include "xensiv_pasco2.h"
 
 #define XENSIV_PASCO2_COMM_DELAY_MS             (5U)
 #define XENSIV_PASCO2_COMM_TEST_VAL             (0xA5U)
 
-#define XENSIV_PASCO2_SOFT_RESET_DELAY_MS       (2000U)
-
 #define XENSIV_PASCO2_FCS_MEAS_RATE_S           (10)
+#define XENSIV_PASCO2_FCS_POLL_INTERVAL_MS      (1000U)
+
+#define XENSIV_PASCO2_STATS_RETRIES             (4U)
 
 #define XENSIV_PASCO2_I2C_WRITE_BUFFER_LEN      (17U)
 #define XENSIV_PASCO2_UART_WRITE_XFER_BUF_SIZE  (8U)
 #define XENSIV_PASCO2_UART_READ_XFER_BUF_SIZE   (5U)
 
 #define XENSIV_PASCO2_UART_WRITE_XFER_RESP_LEN  (2U)
-#define XENSIV_PASCO2_UART_READ_XFER_RESP_LEN   (3U)
+#define XENSIV_PASCO2_UART_READ_XFER_RESP_LEN   (XENSIV_PASCO2_UART_READ_REPLY_LEN)
+#define XENSIV_PASCO2_REG_COUNT                 (XENSIV_PASCO2_REG_SENS_RST + 1U)
+#define XENSIV_PASCO2_UART_PIPELINE_MAX_REGS    (XENSIV_PASCO2_REG_COUNT)
+
+#define XENSIV_PASCO2_SHADOW_REGS_MSK           ((1U << XENSIV_PASCO2_REG_MEAS_RATE_H) | (1U << XENSIV_PASCO2_REG_MEAS_RATE_L) | \
+                                                 (1U << XENSIV_PASCO2_REG_MEAS_CFG)    | (1U << XENSIV_PASCO2_REG_INT_CFG)     | \
+                                                 (1U << XENSIV_PASCO2_REG_ALARM_TH_H)  | (1U << XENSIV_PASCO2_REG_ALARM_TH_L)  | \
+                                                 (1U << XENSIV_PASCO2_REG_PRESS_REF_H) | (1U << XENSIV_PASCO2_REG_PRESS_REF_L) | \
+                                                 (1U << XENSIV_PASCO2_REG_CALIB_REF_H) | (1U << XENSIV_PASCO2_REG_CALIB_REF_L) | \
+                                                 (1U << XENSIV_PASCO2_REG_SCRATCH_PAD))
 #define XENSIV_PASCO2_UART_ACK                  (0x06U)
 #define XENSIV_PASCO2_UART_NAK                  (0x15U)
 
@@ -56,20 +67,222 @@ static inline uint8_t xensiv_pasco2_digit_to_ascii(uint8_t digit)
     }
 }
 
-static inline uint8_t xensiv_pasco2_ascii_to_digit(uint8_t ascii)
+static inline bool xensiv_pasco2_ascii_to_digit(uint8_t ascii, uint8_t * digit)
+{
+    if ((ascii >= (uint8_t)'0') && (ascii <= (uint8_t)'9'))
+    {
+        *digit = (uint8_t)(ascii - (uint8_t)'0');
+    }
+    else if ((ascii >= (uint8_t)'A') && (ascii <= (uint8_t)'F'))
+    {
+        *digit = (uint8_t)(10u + (ascii - (uint8_t)'A'));
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/* Decodes the two hex digits of a UART read reply. A corrupted reply is a communication error */
+static int32_t xensiv_pasco2_uart_decode(const uint8_t * reply, uint8_t * val)
 {
-    xensiv_pasco2_plat_assert(((ascii >= (uint8_t)'0') && (ascii <= (uint8_t)'9')) || ((ascii >= (uint8_t)'A') && (ascii <= (uint8_t)'F')));
+    uint8_t hi;
+    uint8_t lo;
 
-    if (ascii < (uint8_t)'A')
+    if (!xensiv_pasco2_ascii_to_digit(reply[0], &hi) || !xensiv_pasco2_ascii_to_digit(reply[1], &lo))
     {
-        return (uint8_t)(ascii - (uint8_t)'0');
+        return XENSIV_PASCO2_ERR_COMM;
+    }
+
+    *val = (uint8_t)((hi << 4) + lo);
+
+    return XENSIV_PASCO2_OK;
+}
+
+/* The register accessors receive the device as const. The communication timing and
+ * shadow register bookkeeping is not part of the sensor state and is updated through this alias */
+static inline xensiv_pasco2_t * xensiv_pasco2_comm_state(const xensiv_pasco2_t * dev)
+{
+    return (xensiv_pasco2_t *)dev;
+}
+
+/* Statistics writer side. The sequence number is odd while an update is in progress, so that
+ * readers in another context can detect a torn snapshot and retry */
+static void xensiv_pasco2_stats_begin(const xensiv_pasco2_t * dev)
+{
+    xensiv_pasco2_t * state = xensiv_pasco2_comm_state(dev);
+
+    __atomic_store_n(&state->stats.seq, (uint8_t)(state->stats.seq + 1U), __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static void xensiv_pasco2_stats_end(const xensiv_pasco2_t * dev)
+{
+    xensiv_pasco2_t * state = xensiv_pasco2_comm_state(dev);
+
+    __atomic_store_n(&state->stats.seq, (uint8_t)(state->stats.seq + 1U), __ATOMIC_RELEASE);
+}
+
+static void xensiv_pasco2_stats_xfer(const xensiv_pasco2_t * dev, bool write, uint8_t len, int32_t res, uint32_t start_us)
+{
+    xensiv_pasco2_stats_t * stats = &xensiv_pasco2_comm_state(dev)->stats;
+    uint32_t latency_us = xensiv_pasco2_plat_get_time_us() - start_us;
+
+    xensiv_pasco2_stats_begin(dev);
+
+    if (write)
+    {
+        stats->write_xfers++;
+        stats->write_bytes += len;
     }
     else
     {
-        return (uint8_t)(10u + (ascii - (uint8_t)'A'));
+        stats->read_xfers++;
+        stats->read_bytes += len;
+    }
+
+    if (XENSIV_PASCO2_ERR_COMM == res)
+    {
+        stats->comm_errors++;
+    }
+
+    if (latency_us > stats->latency_us_max)
+    {
+        stats->latency_us_max = latency_us;
+    }
+
+    xensiv_pasco2_stats_end(dev);
+}
+
+/* Set by the default microsecond time base, which only advances in millisecond steps */
+static bool xensiv_pasco2_time_us_coarse = false;
+
+static void xensiv_pasco2_comm_guard(const xensiv_pasco2_t * dev)
+{
+    if (dev->comm_pending)
+    {
+        uint32_t elapsed_us = xensiv_pasco2_plat_get_time_us() - dev->comm_ts;
+
+        /* A millisecond tick can elapse right after the previous access finished, so with a coarse
+         * time base the elapsed time is only guaranteed to be one tick less than measured */
+        if (xensiv_pasco2_time_us_coarse)
+        {
+            elapsed_us = (elapsed_us >= 1000U) ? (elapsed_us - 999U) : 0U;
+        }
+
+        if (elapsed_us < (XENSIV_PASCO2_COMM_DELAY_MS * 1000U))
+        {
+            xensiv_pasco2_delay(dev, ((XENSIV_PASCO2_COMM_DELAY_MS * 1000U) - elapsed_us + 999U) / 1000U);
+        }
+    }
+}
+
+static void xensiv_pasco2_comm_done(const xensiv_pasco2_t * dev)
+{
+    xensiv_pasco2_t * state = xensiv_pasco2_comm_state(dev);
+
+    state->comm_ts = xensiv_pasco2_plat_get_time_us();
+    state->comm_pending = true;
+}
+
+/* Registers beyond the register map are folded into the bit past the last register, which is
+ * never cached nor staged. This keeps the shifts below the mask width for any address and length */
+static inline uint32_t xensiv_pasco2_reg_range(uint8_t reg_addr, uint8_t len)
+{
+    if (0U == len)
+    {
+        return 0U;
+    }
+
+    uint32_t first = ((uint32_t)reg_addr < XENSIV_PASCO2_REG_COUNT) ? reg_addr : XENSIV_PASCO2_REG_COUNT;
+    uint32_t end = (uint32_t)reg_addr + len;
+
+    if (end > XENSIV_PASCO2_REG_COUNT)
+    {
+        end = XENSIV_PASCO2_REG_COUNT + 1U;
+    }
+
+    return ((1UL << end) - 1UL) & ~((1UL << first) - 1UL);
+}
+
+static void xensiv_pasco2_shadow_store(const xensiv_pasco2_t * dev, uint8_t reg_addr, const uint8_t * data, uint8_t len)
+{
+    xensiv_pasco2_t * state = xensiv_pasco2_comm_state(dev);
+
+    for (uint8_t i = 0; i < len; ++i)
+    {
+        uint8_t addr = (uint8_t)(reg_addr + i);
+        /* Staged values are kept until they are committed */
+        if ((addr < XENSIV_PASCO2_SNAPSHOT_LEN) && ((XENSIV_PASCO2_SHADOW_REGS_MSK & (1UL << addr)) != 0U) &&
+            ((state->shadow_dirty & (1U << addr)) == 0U))
+        {
+            state->shadow[addr] = data[i];
+            state->shadow_valid |= (uint16_t)(1U << addr);
+        }
+    }
+
+    /* The sensor leaves the single shot mode and the forced compensation on its own */
+    xensiv_pasco2_measurement_config_t meas_config;
+    meas_config.u = state->shadow[XENSIV_PASCO2_REG_MEAS_CFG];
+    if ((XENSIV_PASCO2_OP_MODE_SINGLE == meas_config.b.op_mode) || (XENSIV_PASCO2_BOC_CFG_FORCED == meas_config.b.boc_cfg))
+    {
+        state->shadow_valid &= (uint16_t)~(1U << XENSIV_PASCO2_REG_MEAS_CFG);
     }
 }
 
+static int32_t xensiv_pasco2_commit_run(const xensiv_pasco2_t * dev, uint8_t first, uint8_t last)
+{
+    uint8_t data[XENSIV_PASCO2_SNAPSHOT_LEN];
+    uint8_t len = (uint8_t)(last - first + 1U);
+
+    for (uint8_t i = 0; i < len; ++i)
+    {
+        data[i] = dev->shadow[first + i];
+    }
+
+    /* Cleared before writing, so that the write updates the shadow valid mask */
+    xensiv_pasco2_comm_state(dev)->shadow_dirty &= (uint16_t)~xensiv_pasco2_reg_range(first, len);
+
+    return xensiv_pasco2_set_reg(dev, first, data, len);
+}
+
+static int32_t xensiv_pasco2_commit_block(const xensiv_pasco2_t * dev, uint8_t first, uint8_t last)
+{
+    int32_t res = XENSIV_PASCO2_OK;
+    bool in_run = false;
+    uint8_t run_first = first;
+    uint8_t run_last = first;
+
+    /* Dirty registers are merged into a single burst. Clean registers in between are
+     * written again if their shadow value is known to match the device */
+    for (uint8_t addr = first; (addr <= last) && (XENSIV_PASCO2_OK == res); ++addr)
+    {
+        if ((dev->shadow_dirty & (1U << addr)) != 0U)
+        {
+            if (!in_run)
+            {
+                in_run = true;
+                run_first = addr;
+            }
+            run_last = addr;
+        }
+        else if (in_run && ((dev->shadow_valid & (1U << addr)) == 0U))
+        {
+            in_run = false;
+            res = xensiv_pasco2_commit_run(dev, run_first, run_last);
+        }
+    }
+
+    if ((XENSIV_PASCO2_OK == res) && in_run)
+    {
+        res = xensiv_pasco2_commit_run(dev, run_first, run_last);
+    }
+
+    return res;
+}
+
 static int32_t xensiv_pasco2_i2c_read(const xensiv_pasco2_t * dev, uint8_t reg_addr, uint8_t * data, uint8_t len)
 {
     xensiv_pasco2_plat_assert(dev != NULL);
@@ -124,7 +337,7 @@ static int32_t xensiv_pasco2_uart_read(const xensiv_pasco2_t * dev, uint8_t reg_
             res = xensiv_pasco2_plat_uart_read(dev->ctx, uart_buf, XENSIV_PASCO2_UART_READ_XFER_RESP_LEN);
             if (XENSIV_PASCO2_OK == res)
             {
-                data[i] = (uint8_t)((xensiv_pasco2_ascii_to_digit(uart_buf[0]) << 4) + xensiv_pasco2_ascii_to_digit(uart_buf[1]));
+                res = xensiv_pasco2_uart_decode(uart_buf, &data[i]);
             }
         }
 
@@ -189,7 +402,103 @@ static int32_t xensiv_pasco2_uart_write(const xensiv_pasco2_t * dev, uint8_t reg
     return res;
 }
 
-static int32_t xensiv_pasco2_init(const xensiv_pasco2_t * dev)
+static int32_t xensiv_pasco2_uart_send_read_frames(const xensiv_pasco2_t * dev, uint8_t reg_addr, uint8_t len, uint8_t * uart_buf)
+{
+    /* Encode all the read frames and send them back to back */
+    for (uint8_t i = 0; i < len; ++i)
+    {
+        uint8_t * frame = &uart_buf[i * XENSIV_PASCO2_UART_READ_XFER_BUF_SIZE];
+        uint8_t addr = (uint8_t)(reg_addr + i);
+
+        frame[0] = (uint8_t)'r';
+        frame[1] = (uint8_t)',';
+        frame[2] = xensiv_pasco2_digit_to_ascii((addr & (uint8_t)0xF0) >> 4U);
+        frame[3] = xensiv_pasco2_digit_to_ascii(addr & (uint8_t)0x0F);
+        frame[4] = (uint8_t)'\n';
+    }
+
+    return xensiv_pasco2_plat_uart_write(dev->ctx, uart_buf, (size_t)len * XENSIV_PASCO2_UART_READ_XFER_BUF_SIZE);
+}
+
+static int32_t xensiv_pasco2_uart_read_pipelined(const xensiv_pasco2_t * dev, uint8_t reg_addr, uint8_t * data, uint8_t len)
+{
+    xensiv_pasco2_plat_assert(dev != NULL);
+    xensiv_pasco2_plat_assert(reg_addr <= XENSIV_PASCO2_REG_SENS_RST);
+    xensiv_pasco2_plat_assert(data != NULL);
+    xensiv_pasco2_plat_assert(((uint16_t)reg_addr + len) <= XENSIV_PASCO2_UART_PIPELINE_MAX_REGS);
+
+    uint8_t uart_buf[XENSIV_PASCO2_UART_READ_XFER_BUF_SIZE * XENSIV_PASCO2_UART_PIPELINE_MAX_REGS];
+
+    int32_t res = xensiv_pasco2_uart_send_read_frames(dev, reg_addr, len, uart_buf);
+
+    /* Parse the replies in order as they arrive. The transmit buffer is reused */
+    for (uint8_t i = 0; (i < len) && (XENSIV_PASCO2_OK == res); ++i)
+    {
+        res = xensiv_pasco2_plat_uart_read(dev->ctx, uart_buf, XENSIV_PASCO2_UART_READ_XFER_RESP_LEN);
+        if (XENSIV_PASCO2_OK == res)
+        {
+            res = xensiv_pasco2_uart_decode(uart_buf, &data[i]);
+        }
+    }
+
+    return res;
+}
+
+static int32_t xensiv_pasco2_uart_write_pipelined(const xensiv_pasco2_t * dev, uint8_t reg_addr, const uint8_t * data, uint8_t len)
+{
+    xensiv_pasco2_plat_assert(dev != NULL);
+    xensiv_pasco2_plat_assert(reg_addr <= XENSIV_PASCO2_REG_SENS_RST);
+    xensiv_pasco2_plat_assert(data != NULL);
+    xensiv_pasco2_plat_assert(((uint16_t)reg_addr + len) <= XENSIV_PASCO2_UART_PIPELINE_MAX_REGS);
+
+    uint8_t uart_buf[XENSIV_PASCO2_UART_WRITE_XFER_BUF_SIZE * XENSIV_PASCO2_UART_PIPELINE_MAX_REGS];
+    uint8_t ack_len = len;
+
+    /* Encode all the write frames and send them back to back */
+    for (uint8_t i = 0; i < len; ++i)
+    {
+        uint8_t * frame = &uart_buf[i * XENSIV_PASCO2_UART_WRITE_XFER_BUF_SIZE];
+        uint8_t addr = (uint8_t)(reg_addr + i);
+
+        frame[0] = (uint8_t)'w';
+        frame[1] = (uint8_t)',';
+        frame[2] = xensiv_pasco2_digit_to_ascii((addr & 0xF0U) >> 4U);
+        frame[3] = xensiv_pasco2_digit_to_ascii(addr & 0x0FU);
+        frame[4] = (uint8_t)',';
+        frame[5] = xensiv_pasco2_digit_to_ascii((data[i] & 0xF0U) >> 4U);
+        frame[6] = xensiv_pasco2_digit_to_ascii(data[i] & 0x0FU);
+        frame[7] = (uint8_t)'\n';
+    }
+
+    /* SENS_RST is the last register, so only the last frame can trigger a software reset */
+    if ((XENSIV_PASCO2_REG_SENS_RST == (reg_addr + len - 1U)) && ((uint8_t)XENSIV_PASCO2_CMD_SOFT_RESET == data[len - 1U]))
+    {
+        ack_len--;
+    }
+
+    int32_t res = xensiv_pasco2_plat_uart_write(dev->ctx, uart_buf, (size_t)len * XENSIV_PASCO2_UART_WRITE_XFER_BUF_SIZE);
+
+    /* Collect and validate the responses of all the frames in one pass. The transmit buffer is reused */
+    if ((XENSIV_PASCO2_OK == res) && (ack_len > 0U))
+    {
+        res = xensiv_pasco2_plat_uart_read(dev->ctx, uart_buf, (size_t)ack_len * XENSIV_PASCO2_UART_WRITE_XFER_RESP_LEN);
+
+        for (uint8_t i = 0; (i < ack_len) && (XENSIV_PASCO2_OK == res); ++i)
+        {
+            res = (XENSIV_PASCO2_UART_ACK == uart_buf[i * XENSIV_PASCO2_UART_WRITE_XFER_RESP_LEN]) ? XENSIV_PASCO2_OK : XENSIV_PASCO2_ERR_COMM;
+        }
+    }
+
+    /* If command triggers a software reset ignores the sensor response */
+    if ((XENSIV_PASCO2_OK == res) && (ack_len < len))
+    {
+        (void)xensiv_pasco2_plat_uart_read(dev->ctx, uart_buf, XENSIV_PASCO2_UART_WRITE_XFER_RESP_LEN);
+    }
+
+    return res;
+}
+
+int32_t xensiv_pasco2_reset_start(const xensiv_pasco2_t * dev)
 {
     xensiv_pasco2_plat_assert(dev != NULL);
 
@@ -207,68 +516,305 @@ static int32_t xensiv_pasco2_init(const xensiv_pasco2_t * dev)
     {
         /* Soft reset */
         res = xensiv_pasco2_cmd(dev, XENSIV_PASCO2_CMD_SOFT_RESET);
-        xensiv_pasco2_plat_delay(XENSIV_PASCO2_SOFT_RESET_DELAY_MS);
+    }
+    else
+    {
+        res = XENSIV_PASCO2_ERR_COMM;
+    }
 
-        if (XENSIV_PASCO2_OK == res)
+    return res;
+}
+
+static void xensiv_pasco2_trace_put(xensiv_pasco2_trace_t * trace, uint32_t start_us, uint8_t reg_addr, uint8_t flags, const uint8_t * data, uint8_t len, int32_t res)
+{
+    xensiv_pasco2_trace_rec_t * rec = &trace->buf[trace->head];
+    uint32_t duration_us = xensiv_pasco2_plat_get_time_us() - start_us;
+    uint8_t data_len = len;
+
+    if (data_len > XENSIV_PASCO2_TRACE_DATA_LEN)
+    {
+        data_len = XENSIV_PASCO2_TRACE_DATA_LEN;
+        flags |= XENSIV_PASCO2_TRACE_TRUNC;
+    }
+
+    rec->timestamp_us = start_us;
+    rec->duration_us = (duration_us > 0xFFFFU) ? 0xFFFFU : (uint16_t)duration_us;
+    rec->reg_addr = reg_addr;
+    rec->flags = flags;
+    rec->len = len;
+    rec->result = (int8_t)res;
+    (void)memset(rec->data, 0, sizeof(rec->data));
+    (void)memcpy(rec->data, data, data_len);
+
+    trace->head = (uint16_t)((trace->head + 1U) % trace->size);
+    if (trace->len < trace->size)
+    {
+        trace->len++;
+    }
+    trace->total++;
+}
+
+static int32_t xensiv_pasco2_trace_read(const xensiv_pasco2_t * dev, uint8_t reg_addr, uint8_t * data, uint8_t len)
+{
+    uint32_t start_us = xensiv_pasco2_plat_get_time_us();
+    int32_t res = dev->trace->read(dev, reg_addr, data, len);
+
+    xensiv_pasco2_trace_put(dev->trace, start_us, reg_addr, 0U, data, len, res);
+
+    return res;
+}
+
+static int32_t xensiv_pasco2_trace_write(const xensiv_pasco2_t * dev, uint8_t reg_addr, const uint8_t * data, uint8_t len)
+{
+    uint32_t start_us = xensiv_pasco2_plat_get_time_us();
+    int32_t res = dev->trace->write(dev, reg_addr, data, len);
+
+    xensiv_pasco2_trace_put(dev->trace, start_us, reg_addr, XENSIV_PASCO2_TRACE_WRITE, data, len, res);
+
+    return res;
+}
+
+static void xensiv_pasco2_init_dev(xensiv_pasco2_t * dev, void * ctx, xensiv_pasco2_read_fptr_t read, xensiv_pasco2_write_fptr_t write)
+{
+    xensiv_pasco2_plat_assert(dev != NULL);
+    xensiv_pasco2_plat_assert(ctx != NULL);
+
+    dev->ctx = ctx;
+    dev->read = read;
+    dev->write = write;
+    dev->comm_ts = 0U;
+    dev->comm_pending = false;
+    dev->shadow_en = false;
+    dev->shadow_valid = 0U;
+    dev->shadow_dirty = 0U;
+    dev->stage_en = false;
+    dev->trace = NULL;
+    dev->uart_req_addr = 0U;
+    xensiv_pasco2_reset_stats(dev);
+}
+
+int32_t xensiv_pasco2_init_i2c(xensiv_pasco2_t * dev, void * ctx)
+{
+    int32_t res = xensiv_pasco2_init_i2c_start(dev, ctx);
+
+    if (XENSIV_PASCO2_OK == res)
+    {
+        xensiv_pasco2_delay(dev, XENSIV_PASCO2_SOFT_RESET_DELAY_MS);
+        res = xensiv_pasco2_init_finish(dev);
+    }
+
+    return res;
+}
+
+int32_t xensiv_pasco2_init_uart(xensiv_pasco2_t * dev, void * ctx)
+{
+    int32_t res = xensiv_pasco2_init_uart_start(dev, ctx);
+
+    if (XENSIV_PASCO2_OK == res)
+    {
+        xensiv_pasco2_delay(dev, XENSIV_PASCO2_SOFT_RESET_DELAY_MS);
+        res = xensiv_pasco2_init_finish(dev);
+    }
+
+    return res;
+}
+
+int32_t xensiv_pasco2_init_i2c_start(xensiv_pasco2_t * dev, void * ctx)
+{
+    xensiv_pasco2_bind_i2c(dev, ctx);
+
+    return xensiv_pasco2_reset_start(dev);
+}
+
+int32_t xensiv_pasco2_init_uart_start(xensiv_pasco2_t * dev, void * ctx)
+{
+    xensiv_pasco2_bind_uart(dev, ctx);
+
+    return xensiv_pasco2_reset_start(dev);
+}
+
+void xensiv_pasco2_bind_i2c(xensiv_pasco2_t * dev, void * ctx)
+{
+    xensiv_pasco2_init_dev(dev, ctx, xensiv_pasco2_i2c_read, xensiv_pasco2_i2c_write);
+}
+
+void xensiv_pasco2_bind_uart(xensiv_pasco2_t * dev, void * ctx)
+{
+    xensiv_pasco2_init_dev(dev, ctx, xensiv_pasco2_uart_read, xensiv_pasco2_uart_write);
+}
+
+int32_t xensiv_pasco2_init_finish(const xensiv_pasco2_t * dev)
+{
+    xensiv_pasco2_plat_assert(dev != NULL);
+
+    uint8_t data;
+
+    /* Read the sensor status and verify if the sensor is ready */
+    int32_t res = xensiv_pasco2_get_reg(dev, (uint8_t)XENSIV_PASCO2_REG_SENS_STS, &data, 1U);
+
+    if (XENSIV_PASCO2_OK == res)
+    {
+        if ((data & XENSIV_PASCO2_REG_SENS_STS_ICCER_MSK) != 0U)
+        {
+            res = XENSIV_PASCO2_ICCERR;
+        }
+        else if ((data & XENSIV_PASCO2_REG_SENS_STS_ORVS_MSK) != 0U)
+        {
+            res = XENSIV_PASCO2_ORVS;
+        }
+        else if ((data & XENSIV_PASCO2_REG_SENS_STS_ORTMP_MSK) != 0U)
         {
-            /* Read the sensor status and verify if the sensor is ready */
-            res = xensiv_pasco2_get_reg(dev, (uint8_t)XENSIV_PASCO2_REG_SENS_STS, &data, 1U);
+            res = XENSIV_PASCO2_ORTMP;
         }
+        else if ((data & XENSIV_PASCO2_REG_SENS_STS_SEN_RDY_MSK) == 0U)
+        {
+            res = XENSIV_PASCO2_ERR_NOT_READY;
+        }
+        else
+        {
+            res = XENSIV_PASCO2_OK;
+        }
+    }
 
-        if (XENSIV_PASCO2_OK == res)
+    return res;
+}
+
+void xensiv_pasco2_set_uart_pipelining(xensiv_pasco2_t * dev, bool enable)
+{
+    xensiv_pasco2_plat_assert(dev != NULL);
+
+    /* The transport functions sit behind the trace recorder while tracing */
+    xensiv_pasco2_read_fptr_t * read = (NULL != dev->trace) ? &dev->trace->read : &dev->read;
+    xensiv_pasco2_write_fptr_t * write = (NULL != dev->trace) ? &dev->trace->write : &dev->write;
+
+    xensiv_pasco2_plat_assert((*read == xensiv_pasco2_uart_read) || (*read == xensiv_pasco2_uart_read_pipelined));
+
+    *read = enable ? xensiv_pasco2_uart_read_pipelined : xensiv_pasco2_uart_read;
+    *write = enable ? xensiv_pasco2_uart_write_pipelined : xensiv_pasco2_uart_write;
+}
+
+void xensiv_pasco2_set_shadow(xensiv_pasco2_t * dev, bool enable)
+{
+    xensiv_pasco2_plat_assert(dev != NULL);
+
+    dev->shadow_en = enable;
+    dev->shadow_valid = 0U;
+}
+
+void xensiv_pasco2_begin_config(xensiv_pasco2_t * dev)
+{
+    xensiv_pasco2_plat_assert(dev != NULL);
+
+    xensiv_pasco2_measurement_config_t meas_config;
+    meas_config.u = dev->shadow[XENSIV_PASCO2_REG_MEAS_CFG];
+
+    dev->stage_en = true;
+    dev->stage_idle = ((dev->shadow_valid & (1U << XENSIV_PASCO2_REG_MEAS_CFG)) != 0U) &&
+                      (XENSIV_PASCO2_OP_MODE_IDLE == meas_config.b.op_mode);
+}
+
+int32_t xensiv_pasco2_commit_config(xensiv_pasco2_t * dev)
+{
+    xensiv_pasco2_plat_assert(dev != NULL);
+
+    int32_t res = XENSIV_PASCO2_OK;
+
+    dev->stage_en = false;
+
+    /* Interrupt, alarm and references first, so that a new operation mode starts with the complete configuration */
+    res = xensiv_pasco2_commit_block(dev, (uint8_t)XENSIV_PASCO2_REG_INT_CFG, (uint8_t)XENSIV_PASCO2_REG_SCRATCH_PAD);
+
+    /* The measurement rate is only changed in idle mode, and the operation mode only changes from idle mode */
+    bool rate_dirty = (dev->shadow_dirty & xensiv_pasco2_reg_range((uint8_t)XENSIV_PASCO2_REG_MEAS_RATE_H, 2U)) != 0U;
+    bool cfg_dirty = (dev->shadow_dirty & (1U << XENSIV_PASCO2_REG_MEAS_CFG)) != 0U;
+
+    if ((XENSIV_PASCO2_OK == res) && (rate_dirty || cfg_dirty) && !dev->stage_idle)
+    {
+        xensiv_pasco2_measurement_config_t staged;
+        xensiv_pasco2_measurement_config_t meas_config;
+
+        /* Read the device value instead of the staged one */
+        staged.u = dev->shadow[XENSIV_PASCO2_REG_MEAS_CFG];
+        dev->shadow_dirty &= (uint16_t)~(1U << XENSIV_PASCO2_REG_MEAS_CFG);
+        res = xensiv_pasco2_get_measurement_config(dev, &meas_config);
+
+        if ((XENSIV_PASCO2_OK == res) && (XENSIV_PASCO2_OP_MODE_IDLE != meas_config.b.op_mode) &&
+            (rate_dirty || ((XENSIV_PASCO2_OP_MODE_IDLE != staged.b.op_mode) && (staged.b.op_mode != meas_config.b.op_mode))))
         {
-            if ((data & XENSIV_PASCO2_REG_SENS_STS_ICCER_MSK) != 0U)
-            {
-                res = XENSIV_PASCO2_ICCERR;
-            }
-            else if ((data & XENSIV_PASCO2_REG_SENS_STS_ORVS_MSK) != 0U)
-            {
-                res = XENSIV_PASCO2_ORVS;
-            }
-            else if ((data & XENSIV_PASCO2_REG_SENS_STS_ORTMP_MSK) != 0U)
-            {
-                res = XENSIV_PASCO2_ORTMP;
-            }
-            else if ((data & XENSIV_PASCO2_REG_SENS_STS_SEN_RDY_MSK) == 0U)
+            /* A rate change alone resumes the continuous mode afterwards */
+            if (!cfg_dirty && (XENSIV_PASCO2_OP_MODE_CONTINUOUS == meas_config.b.op_mode))
             {
-                res = XENSIV_PASCO2_ERR_NOT_READY;
-            }
-            else
-            {
-                res = XENSIV_PASCO2_OK;
+                staged.u = meas_config.u;
+                cfg_dirty = true;
             }
+
+            meas_config.b.op_mode = XENSIV_PASCO2_OP_MODE_IDLE;
+            res = xensiv_pasco2_set_measurement_config(dev, meas_config);
+        }
+
+        if (cfg_dirty)
+        {
+            dev->shadow[XENSIV_PASCO2_REG_MEAS_CFG] = staged.u;
+            dev->shadow_dirty |= (uint16_t)(1U << XENSIV_PASCO2_REG_MEAS_CFG);
+            dev->shadow_valid &= (uint16_t)~(1U << XENSIV_PASCO2_REG_MEAS_CFG);
         }
     }
-    else
+
+    if (XENSIV_PASCO2_OK == res)
     {
-        res = XENSIV_PASCO2_ERR_COMM;
+        res = xensiv_pasco2_commit_block(dev, (uint8_t)XENSIV_PASCO2_REG_MEAS_RATE_H, (uint8_t)XENSIV_PASCO2_REG_MEAS_CFG);
+    }
+
+    if (XENSIV_PASCO2_OK != res)
+    {
+        dev->shadow_valid &= (uint16_t)~dev->shadow_dirty;
+        dev->shadow_dirty = 0U;
     }
 
     return res;
 }
 
-int32_t xensiv_pasco2_init_i2c(xensiv_pasco2_t * dev, void * ctx)
+int32_t xensiv_pasco2_uart_read_request(const xensiv_pasco2_t * dev, uint8_t reg_addr, uint8_t len)
 {
     xensiv_pasco2_plat_assert(dev != NULL);
-    xensiv_pasco2_plat_assert(ctx != NULL);
+    xensiv_pasco2_plat_assert(reg_addr <= XENSIV_PASCO2_REG_SENS_RST);
+    xensiv_pasco2_plat_assert(((uint16_t)reg_addr + len) <= XENSIV_PASCO2_UART_PIPELINE_MAX_REGS);
 
-    dev->ctx = ctx;
-    dev->read = xensiv_pasco2_i2c_read;
-    dev->write = xensiv_pasco2_i2c_write;
+    uint8_t uart_buf[XENSIV_PASCO2_UART_READ_XFER_BUF_SIZE * XENSIV_PASCO2_UART_PIPELINE_MAX_REGS];
 
-    return xensiv_pasco2_init(dev);
+    uint32_t start_us = xensiv_pasco2_plat_get_time_us();
+    xensiv_pasco2_comm_guard(dev);
+
+    xensiv_pasco2_plat_bus_lock(dev->ctx);
+    int32_t res = xensiv_pasco2_uart_send_read_frames(dev, reg_addr, len, uart_buf);
+    xensiv_pasco2_plat_bus_unlock(dev->ctx);
+    xensiv_pasco2_comm_done(dev);
+    xensiv_pasco2_comm_state(dev)->uart_req_addr = reg_addr;
+    xensiv_pasco2_stats_xfer(dev, false, len, res, start_us);
+
+    return res;
 }
 
-int32_t xensiv_pasco2_init_uart(xensiv_pasco2_t * dev, void * ctx)
+int32_t xensiv_pasco2_uart_read_reply(const xensiv_pasco2_t * dev, const uint8_t * reply, uint8_t * val)
 {
     xensiv_pasco2_plat_assert(dev != NULL);
-    xensiv_pasco2_plat_assert(ctx != NULL);
+    xensiv_pasco2_plat_assert(reply != NULL);
+    xensiv_pasco2_plat_assert(val != NULL);
 
-    dev->ctx = ctx;
-    dev->read = xensiv_pasco2_uart_read;
-    dev->write = xensiv_pasco2_uart_write;
+    xensiv_pasco2_t * state = xensiv_pasco2_comm_state(dev);
+    int32_t res = xensiv_pasco2_uart_decode(reply, val);
+
+    xensiv_pasco2_comm_done(dev);
+
+    /* Recorded as a single register read, as the read frames are sent in one go */
+    if (NULL != dev->trace)
+    {
+        xensiv_pasco2_trace_put(dev->trace, xensiv_pasco2_plat_get_time_us(), state->uart_req_addr, 0U, val, 1U, res);
+    }
 
-    return xensiv_pasco2_init(dev);
+    state->uart_req_addr++;
+
+    return res;
 }
 
 int32_t xensiv_pasco2_set_reg(const xensiv_pasco2_t * dev, uint8_t reg_addr, const uint8_t * data, uint8_t len)
@@ -276,8 +822,51 @@ int32_t xensiv_pasco2_set_reg(const xensiv_pasco2_t * dev, uint8_t reg_addr, con
     xensiv_pasco2_plat_assert(dev != NULL);
     xensiv_pasco2_plat_assert(data != NULL);
 
+    uint32_t range = xensiv_pasco2_reg_range(reg_addr, len);
+
+    /* Configuration register writes are staged while a configuration transaction is open */
+    if (dev->stage_en && ((range & ~(uint32_t)XENSIV_PASCO2_SHADOW_REGS_MSK) == 0U))
+    {
+        xensiv_pasco2_t * state = xensiv_pasco2_comm_state(dev);
+
+        for (uint8_t i = 0; i < len; ++i)
+        {
+            state->shadow[reg_addr + i] = data[i];
+        }
+
+        state->shadow_dirty |= (uint16_t)range;
+        state->shadow_valid &= (uint16_t)~range;
+
+        return XENSIV_PASCO2_OK;
+    }
+
+    uint32_t start_us = xensiv_pasco2_plat_get_time_us();
+    xensiv_pasco2_comm_guard(dev);
+
+    /* The bus is only locked for the transfer, not for the guard time */
+    xensiv_pasco2_plat_bus_lock(dev->ctx);
     int32_t res = dev->write(dev, reg_addr, data, len);
-    xensiv_pasco2_plat_delay(XENSIV_PASCO2_COMM_DELAY_MS);
+    xensiv_pasco2_plat_bus_unlock(dev->ctx);
+    xensiv_pasco2_comm_done(dev);
+    xensiv_pasco2_stats_xfer(dev, true, len, res, start_us);
+
+    if (dev->shadow_en)
+    {
+        uint8_t rst_idx = (uint8_t)(XENSIV_PASCO2_REG_SENS_RST - reg_addr);
+
+        if (XENSIV_PASCO2_OK != res)
+        {
+            xensiv_pasco2_comm_state(dev)->shadow_valid &= (uint16_t)~range;
+        }
+        else if ((rst_idx < len) && ((uint8_t)XENSIV_PASCO2_CMD_SOFT_RESET == data[rst_idx]))
+        {
+            xensiv_pasco2_comm_state(dev)->shadow_valid = 0U;
+        }
+        else
+        {
+            xensiv_pasco2_shadow_store(dev, reg_addr, data, len);
+        }
+    }
 
     return res;
 }
@@ -287,12 +876,218 @@ int32_t xensiv_pasco2_get_reg(const xensiv_pasco2_t * dev, uint8_t reg_addr, uin
     xensiv_pasco2_plat_assert(dev != NULL);
     xensiv_pasco2_plat_assert(data != NULL);
 
+    uint32_t range = xensiv_pasco2_reg_range(reg_addr, len);
+
+    /* The shadow valid mask is always empty with the cache disabled */
+    if ((range & ~((uint32_t)dev->shadow_valid | dev->shadow_dirty)) == 0U)
+    {
+        for (uint8_t i = 0; i < len; ++i)
+        {
+            data[i] = dev->shadow[reg_addr + i];
+        }
+
+        return XENSIV_PASCO2_OK;
+    }
+
+    uint32_t start_us = xensiv_pasco2_plat_get_time_us();
+    xensiv_pasco2_comm_guard(dev);
+
+    xensiv_pasco2_plat_bus_lock(dev->ctx);
     int32_t res = dev->read(dev, reg_addr, data, len);
-    xensiv_pasco2_plat_delay(XENSIV_PASCO2_COMM_DELAY_MS);
+    xensiv_pasco2_plat_bus_unlock(dev->ctx);
+    xensiv_pasco2_comm_done(dev);
+    xensiv_pasco2_stats_xfer(dev, false, len, res, start_us);
+
+    if (dev->shadow_en && (XENSIV_PASCO2_OK == res))
+    {
+        xensiv_pasco2_shadow_store(dev, reg_addr, data, len);
+    }
+
+    if ((XENSIV_PASCO2_OK == res) && ((range & dev->shadow_dirty) != 0U))
+    {
+        /* Read back the staged values instead of the device ones */
+        for (uint8_t i = 0; i < len; ++i)
+        {
+            if (((reg_addr + i) < XENSIV_PASCO2_SNAPSHOT_LEN) && ((dev->shadow_dirty & (1UL << (reg_addr + i))) != 0U))
+            {
+                data[i] = dev->shadow[reg_addr + i];
+            }
+        }
+    }
 
     return res;
 }
 
+int32_t xensiv_pasco2_get_snapshot(const xensiv_pasco2_t * dev, xensiv_pasco2_snapshot_t * snapshot)
+{
+    xensiv_pasco2_plat_assert(dev != NULL);
+    xensiv_pasco2_plat_assert(snapshot != NULL);
+
+    uint8_t regs[XENSIV_PASCO2_SNAPSHOT_LEN];
+    int32_t res = xensiv_pasco2_get_reg(dev, (uint8_t)XENSIV_PASCO2_REG_PROD_ID, regs, (uint8_t)XENSIV_PASCO2_SNAPSHOT_LEN);
+
+    if (XENSIV_PASCO2_OK == res)
+    {
+        snapshot->id.u = regs[XENSIV_PASCO2_REG_PROD_ID];
+        snapshot->status.u = regs[XENSIV_PASCO2_REG_SENS_STS];
+        snapshot->meas_rate = (uint16_t)(((uint16_t)regs[XENSIV_PASCO2_REG_MEAS_RATE_H] << 8) | regs[XENSIV_PASCO2_REG_MEAS_RATE_L]);
+        snapshot->meas_config.u = regs[XENSIV_PASCO2_REG_MEAS_CFG];
+        snapshot->co2_ppm = (uint16_t)(((uint16_t)regs[XENSIV_PASCO2_REG_CO2PPM_H] << 8) | regs[XENSIV_PASCO2_REG_CO2PPM_L]);
+        snapshot->meas_status.u = regs[XENSIV_PASCO2_REG_MEAS_STS];
+        snapshot->int_config.u = regs[XENSIV_PASCO2_REG_INT_CFG];
+        snapshot->alarm_threshold = (uint16_t)(((uint16_t)regs[XENSIV_PASCO2_REG_ALARM_TH_H] << 8) | regs[XENSIV_PASCO2_REG_ALARM_TH_L]);
+        snapshot->pressure_ref = (uint16_t)(((uint16_t)regs[XENSIV_PASCO2_REG_PRESS_REF_H] << 8) | regs[XENSIV_PASCO2_REG_PRESS_REF_L]);
+        snapshot->calib_ref = (uint16_t)(((uint16_t)regs[XENSIV_PASCO2_REG_CALIB_REF_H] << 8) | regs[XENSIV_PASCO2_REG_CALIB_REF_L]);
+        snapshot->scratch_pad = regs[XENSIV_PASCO2_REG_SCRATCH_PAD];
+    }
+
+    return res;
+}
+
+bool xensiv_pasco2_get_stats(const xensiv_pasco2_t * dev, xensiv_pasco2_stats_t * stats)
+{
+    xensiv_pasco2_plat_assert(dev != NULL);
+    xensiv_pasco2_plat_assert(stats != NULL);
+
+    for (uint8_t retry = 0; retry < XENSIV_PASCO2_STATS_RETRIES; ++retry)
+    {
+        uint8_t seq = __atomic_load_n(&dev->stats.seq, __ATOMIC_ACQUIRE);
+
+        if ((seq & 1U) == 0U)
+        {
+            *stats = dev->stats;
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+            if (seq == __atomic_load_n(&dev->stats.seq, __ATOMIC_RELAXED))
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void xensiv_pasco2_reset_stats(xensiv_pasco2_t * dev)
+{
+    xensiv_pasco2_plat_assert(dev != NULL);
+
+    uint8_t seq = dev->stats.seq;
+
+    xensiv_pasco2_stats_begin(dev);
+    (void)memset(&dev->stats, 0, sizeof(dev->stats));
+    dev->stats.seq = (uint8_t)(seq + 1U);
+    xensiv_pasco2_stats_end(dev);
+}
+
+void xensiv_pasco2_delay(const xensiv_pasco2_t * dev, uint32_t ms)
+{
+    xensiv_pasco2_plat_assert(dev != NULL);
+
+    xensiv_pasco2_stats_t * stats = &xensiv_pasco2_comm_state(dev)->stats;
+
+    xensiv_pasco2_stats_begin(dev);
+    stats->delay_ms_total += ms;
+
+    if (ms > stats->delay_ms_max)
+    {
+        stats->delay_ms_max = ms;
+    }
+
+    xensiv_pasco2_stats_end(dev);
+
+    xensiv_pasco2_plat_delay(ms);
+}
+
+void xensiv_pasco2_trace_init(xensiv_pasco2_trace_t * trace, xensiv_pasco2_trace_rec_t * buf, uint16_t size)
+{
+    xensiv_pasco2_plat_assert(trace != NULL);
+    xensiv_pasco2_plat_assert(buf != NULL);
+    xensiv_pasco2_plat_assert(size > 0U);
+
+    trace->buf = buf;
+    trace->size = size;
+    trace->head = 0U;
+    trace->len = 0U;
+    trace->total = 0U;
+    trace->read = NULL;
+    trace->write = NULL;
+}
+
+void xensiv_pasco2_trace_start(xensiv_pasco2_t * dev, xensiv_pasco2_trace_t * trace)
+{
+    xensiv_pasco2_plat_assert(dev != NULL);
+    xensiv_pasco2_plat_assert(trace != NULL);
+
+    xensiv_pasco2_trace_stop(dev);
+
+    trace->read = dev->read;
+    trace->write = dev->write;
+
+    dev->trace = trace;
+    dev->read = xensiv_pasco2_trace_read;
+    dev->write = xensiv_pasco2_trace_write;
+}
+
+void xensiv_pasco2_trace_stop(xensiv_pasco2_t * dev)
+{
+    xensiv_pasco2_plat_assert(dev != NULL);
+
+    if (NULL != dev->trace)
+    {
+        dev->read = dev->trace->read;
+        dev->write = dev->trace->write;
+        dev->trace = NULL;
+    }
+}
+
+const xensiv_pasco2_trace_rec_t * xensiv_pasco2_trace_get(const xensiv_pasco2_trace_t * trace, uint16_t index)
+{
+    xensiv_pasco2_plat_assert(trace != NULL);
+
+    if (index >= trace->len)
+    {
+        return NULL;
+    }
+
+    /* The oldest record is at head once the ring has wrapped around */
+    uint16_t first = (trace->len < trace->size) ? 0U : trace->head;
+
+    return &trace->buf[((uint32_t)first + index) % trace->size];
+}
+
+void xensiv_pasco2_trace_encode(const xensiv_pasco2_trace_rec_t * rec, uint8_t * buf)
+{
+    xensiv_pasco2_plat_assert(rec != NULL);
+    xensiv_pasco2_plat_assert(buf != NULL);
+
+    buf[0] = (uint8_t)rec->timestamp_us;
+    buf[1] = (uint8_t)(rec->timestamp_us >> 8U);
+    buf[2] = (uint8_t)(rec->timestamp_us >> 16U);
+    buf[3] = (uint8_t)(rec->timestamp_us >> 24U);
+    buf[4] = (uint8_t)rec->duration_us;
+    buf[5] = (uint8_t)(rec->duration_us >> 8U);
+    buf[6] = rec->reg_addr;
+    buf[7] = rec->flags;
+    buf[8] = rec->len;
+    buf[9] = (uint8_t)rec->result;
+    (void)memcpy(&buf[10], rec->data, XENSIV_PASCO2_TRACE_DATA_LEN);
+}
+
+void xensiv_pasco2_trace_decode(const uint8_t * buf, xensiv_pasco2_trace_rec_t * rec)
+{
+    xensiv_pasco2_plat_assert(buf != NULL);
+    xensiv_pasco2_plat_assert(rec != NULL);
+
+    rec->timestamp_us = (uint32_t)buf[0] | ((uint32_t)buf[1] << 8U) | ((uint32_t)buf[2] << 16U) | ((uint32_t)buf[3] << 24U);
+    rec->duration_us = (uint16_t)(buf[4] | ((uint16_t)buf[5] << 8U));
+    rec->reg_addr = buf[6];
+    rec->flags = buf[7];
+    rec->len = buf[8];
+    rec->result = (int8_t)buf[9];
+    (void)memcpy(rec->data, &buf[10], XENSIV_PASCO2_TRACE_DATA_LEN);
+}
+
 int32_t xensiv_pasco2_get_id(const xensiv_pasco2_t * dev, xensiv_pasco2_id_t * id)
 {
     xensiv_pasco2_plat_assert(dev != NULL);
@@ -364,6 +1159,10 @@ int32_t xensiv_pasco2_get_result(const xensiv_pasco2_t * dev, uint16_t * val)
         else
         {
             res =  XENSIV_PASCO2_READ_NRDY;
+
+            xensiv_pasco2_stats_begin(dev);
+            xensiv_pasco2_comm_state(dev)->stats.read_nrdy++;
+            xensiv_pasco2_stats_end(dev);
         }
     }
 
@@ -500,6 +1299,49 @@ int32_t xensiv_pasco2_start_continuous_mode(const xensiv_pasco2_t * dev, uint16_
 }
 
 int32_t xensiv_pasco2_perform_forced_compensation(const xensiv_pasco2_t * dev, uint16_t co2_ref)
+{
+    /* The baseline offset compensation setting is restored if the compensation is aborted */
+    xensiv_pasco2_measurement_config_t meas_config;
+    int32_t res = xensiv_pasco2_get_measurement_config(dev, &meas_config);
+
+    if (XENSIV_PASCO2_OK == res)
+    {
+        res = xensiv_pasco2_start_forced_compensation(dev, co2_ref);
+
+        if (XENSIV_PASCO2_OK == res)
+        {
+            uint32_t waited_ms = 0U;
+
+            /* wait until the FCS is finished. Communication errors are not retried */
+            res = xensiv_pasco2_get_forced_compensation_state(dev);
+            while ((XENSIV_PASCO2_BUSY == res) && (waited_ms < XENSIV_PASCO2_FCS_TIMEOUT_MS))
+            {
+                xensiv_pasco2_delay(dev, XENSIV_PASCO2_FCS_POLL_INTERVAL_MS);
+                waited_ms += XENSIV_PASCO2_FCS_POLL_INTERVAL_MS;
+                res = xensiv_pasco2_get_forced_compensation_state(dev);
+            }
+        }
+
+        if (XENSIV_PASCO2_OK == res)
+        {
+            res = xensiv_pasco2_finish_forced_compensation(dev);
+        }
+        else
+        {
+            /* The first error is reported */
+            (void)xensiv_pasco2_abort_forced_compensation(dev, (xensiv_pasco2_boc_cfg_t)meas_config.b.boc_cfg);
+
+            if (XENSIV_PASCO2_BUSY == res)
+            {
+                res = XENSIV_PASCO2_ERR_TIMEOUT;
+            }
+        }
+    }
+
+    return res;
+}
+
+int32_t xensiv_pasco2_start_forced_compensation(const xensiv_pasco2_t * dev, uint16_t co2_ref)
 {
     xensiv_pasco2_measurement_config_t meas_config;
     int32_t res = xensiv_pasco2_get_measurement_config(dev, &meas_config);
@@ -527,15 +1369,27 @@ int32_t xensiv_pasco2_perform_forced_compensation(const xensiv_pasco2_t * dev, u
         res = xensiv_pasco2_set_measurement_config(dev, meas_config);
     }
 
-    if (XENSIV_PASCO2_OK == res)
+    return res;
+}
+
+int32_t xensiv_pasco2_get_forced_compensation_state(const xensiv_pasco2_t * dev)
+{
+    xensiv_pasco2_measurement_config_t meas_config;
+    int32_t res = xensiv_pasco2_get_measurement_config(dev, &meas_config);
+
+    if ((XENSIV_PASCO2_OK == res) && (XENSIV_PASCO2_BOC_CFG_FORCED == meas_config.b.boc_cfg))
     {
-        /* wait until the FCS is finished */
-        do
-        {
-            res = xensiv_pasco2_get_measurement_config(dev, &meas_config);
-        } while ((XENSIV_PASCO2_OK != res) || (XENSIV_PASCO2_BOC_CFG_FORCED == meas_config.b.boc_cfg));
+        res = XENSIV_PASCO2_BUSY;
     }
 
+    return res;
+}
+
+int32_t xensiv_pasco2_finish_forced_compensation(const xensiv_pasco2_t * dev)
+{
+    xensiv_pasco2_measurement_config_t meas_config;
+    int32_t res = xensiv_pasco2_get_measurement_config(dev, &meas_config);
+
     if (XENSIV_PASCO2_OK == res)
     {
         meas_config.b.op_mode = XENSIV_PASCO2_OP_MODE_IDLE;
@@ -550,6 +1404,21 @@ int32_t xensiv_pasco2_perform_forced_compensation(const xensiv_pasco2_t * dev, u
     return res;
 }
 
+int32_t xensiv_pasco2_abort_forced_compensation(const xensiv_pasco2_t * dev, xensiv_pasco2_boc_cfg_t boc_cfg)
+{
+    xensiv_pasco2_measurement_config_t meas_config;
+    int32_t res = xensiv_pasco2_get_measurement_config(dev, &meas_config);
+
+    if (XENSIV_PASCO2_OK == res)
+    {
+        meas_config.b.op_mode = XENSIV_PASCO2_OP_MODE_IDLE;
+        meas_config.b.boc_cfg = (XENSIV_PASCO2_BOC_CFG_FORCED == boc_cfg) ? XENSIV_PASCO2_BOC_CFG_DISABLE : boc_cfg;
+        res = xensiv_pasco2_set_measurement_config(dev, meas_config);
+    }
+
+    return res;
+}
+
 __attribute__((weak)) int32_t xensiv_pasco2_plat_i2c_transfer(void * ctx, uint16_t dev_addr, const uint8_t * tx_buffer, size_t tx_len, uint8_t * rx_buffer, size_t rx_len)
 {
     (void)ctx;
@@ -585,6 +1454,28 @@ __attribute__((weak)) void xensiv_pasco2_plat_delay(uint32_t ms)
     (void)ms;
 }
 
+__attribute__((weak)) uint32_t xensiv_pasco2_plat_get_time_ms(void)
+{
+    return 0U;
+}
+
+__attribute__((weak)) uint32_t xensiv_pasco2_plat_get_time_us(void)
+{
+    xensiv_pasco2_time_us_coarse = true;
+
+    return xensiv_pasco2_plat_get_time_ms() * 1000U;
+}
+
+__attribute__((weak)) void xensiv_pasco2_plat_bus_lock(void * ctx)
+{
+    (void)ctx;
+}
+
+__attribute__((weak)) void xensiv_pasco2_plat_bus_unlock(void * ctx)
+{
+    (void)ctx;
+}
+
 __attribute__((weak)) uint16_t xensiv_pasco2_plat_htons(uint16_t x)
 {
     return ((uint16_t)(((x & 0x00ffU) << 8) |
@@ -35,6 +35,8 @@
  * - \ref xensiv_pasco2_plat_i2c_transfer
  * - \ref xensiv_pasco2_plat_uart_read, \ref xensiv_pasco2_plat_uart_write
  * - \ref xensiv_pasco2_plat_delay
+ * - \ref xensiv_pasco2_plat_get_time_ms, \ref xensiv_pasco2_plat_get_time_us
+ * - \ref xensiv_pasco2_plat_bus_lock, \ref xensiv_pasco2_plat_bus_unlock
  * - \ref xensiv_pasco2_plat_htons
  * - \ref xensiv_pasco2_plat_assert
  *
@@ -42,6 +44,9 @@
  * \ref xensiv_pasco2_plat_i2c_transfer must be overridden when using the I2C interface.
  * \ref xensiv_pasco2_plat_uart_read, \ref xensiv_pasco2_plat_uart_write must be overridden when using the UART interface.
  * \ref xensiv_pasco2_plat_delay must be overridden with an appropriate implementation for the target platform that delays the processing for a certain number of milliseconds.
+ * \ref xensiv_pasco2_plat_get_time_ms can be overridden with a millisecond time base of the target platform. The driver then only waits the remaining part of the inter-transaction guard time. The default implementation always returns zero, and the full guard time is waited.
+ * \ref xensiv_pasco2_plat_get_time_us can be overridden with a microsecond time base to measure the register access latency reported by \ref xensiv_pasco2_get_stats and the inter-transaction guard time. The default implementation derives it from \ref xensiv_pasco2_plat_get_time_ms, and the guard time is then rounded up by one millisecond tick.
+ * \ref xensiv_pasco2_plat_bus_lock and \ref xensiv_pasco2_plat_bus_unlock can be overridden to serialize the transfers of several tasks on a shared bus. They enclose each transfer only, not the inter-transaction guard time. The default implementation does nothing.
  * \ref xensiv_pasco2_plat_htons implements byte reversing in C and can be overridden optionally to optimize the performance if the target platform provides a specific instruction to byte reversing.
  * \ref xensiv_pasco2_plat_assert is implemented using the standard assert.h, and can be optionally overriden for the target platform.
  *
@@ -73,6 +78,12 @@
 #define XENSIV_PASCO2_ORTMP                 (6)
 /** Result code indicating that a new CO2 value is not yet ready */
 #define XENSIV_PASCO2_READ_NRDY             (7)
+/** Result code indicating that a non-blocking operation has not completed yet */
+#define XENSIV_PASCO2_BUSY                  (8)
+/** Result code indicating that a non-blocking operation has not completed within its deadline */
+#define XENSIV_PASCO2_ERR_TIMEOUT           (9)
+/** Result code indicating that an argument is out of its valid range or a resource is exhausted */
+#define XENSIV_PASCO2_ERR_ILLEGAL_ARG       (10)
 
 /** Minimum allowed measurement rate */
 #define XENSIV_PASCO2_MEAS_RATE_MIN         (5U)
@@ -80,9 +91,21 @@
 /** Maximum allowed measurement rate */
 #define XENSIV_PASCO2_MEAS_RATE_MAX         (4095U)
 
+/** Time in milliseconds the sensor needs to get ready after a soft reset */
+#define XENSIV_PASCO2_SOFT_RESET_DELAY_MS   (2000U)
+
+/** Time in milliseconds after which \ref xensiv_pasco2_perform_forced_compensation gives up */
+#define XENSIV_PASCO2_FCS_TIMEOUT_MS        (180000U)
+
 /** I2C address of the XENSIV™ PASCO2 sensor */
 #define XENSIV_PASCO2_I2C_ADDR              (0x28U)
 
+/** Length of the reply to a UART register read frame */
+#define XENSIV_PASCO2_UART_READ_REPLY_LEN   (3U)
+
+/** Number of registers read by a register file snapshot (PROD_ID to SCRATCH_PAD) */
+#define XENSIV_PASCO2_SNAPSHOT_LEN          (16U)
+
 /********************************* Type definitions **************************************/
 
 /** Enum defining the different device commands */
@@ -212,6 +235,61 @@ typedef union
   uint8_t u;                                            /*!< Type used for byte access */
 } xensiv_pasco2_meas_status_t;
 
+/** Structure of a register file snapshot (PROD_ID to SCRATCH_PAD). Populated using \ref xensiv_pasco2_get_snapshot */
+typedef struct
+{
+    xensiv_pasco2_id_t id;                              /*!< Product and revision ID (PROD_ID) */
+    xensiv_pasco2_status_t status;                      /*!< Sensor status (SENS_STS) */
+    uint16_t meas_rate;                                 /*!< Measurement period in seconds (MEAS_RATE_H/L) */
+    xensiv_pasco2_measurement_config_t meas_config;     /*!< Measurement configuration (MEAS_CFG) */
+    uint16_t co2_ppm;                                   /*!< CO2 concentration in ppm (CO2PPM_H/L). Only valid if meas_status.b.drdy is set */
+    xensiv_pasco2_meas_status_t meas_status;            /*!< Measurement status (MEAS_STS) */
+    xensiv_pasco2_interrupt_config_t int_config;        /*!< Interrupt configuration (INT_CFG) */
+    uint16_t alarm_threshold;                           /*!< Alarm threshold (ALARM_TH_H/L) */
+    uint16_t pressure_ref;                              /*!< Pressure compensation reference (PRESS_REF_H/L) */
+    uint16_t calib_ref;                                 /*!< Offset compensation reference (CALIB_REF_H/L) */
+    uint8_t scratch_pad;                                /*!< Scratch pad (SCRATCH_PAD) */
+} xensiv_pasco2_snapshot_t;
+
+/** Structure of the runtime statistics of a device. See \ref xensiv_pasco2_get_stats */
+typedef struct
+{
+    uint8_t seq;                                        /*!< Update sequence number. Odd while an update is in progress */
+    uint32_t read_xfers;                                /*!< Register read transactions */
+    uint32_t write_xfers;                               /*!< Register write transactions */
+    uint32_t read_bytes;                                /*!< Register bytes read */
+    uint32_t write_bytes;                               /*!< Register bytes written */
+    uint32_t comm_errors;                               /*!< Transactions failed with XENSIV_PASCO2_ERR_COMM */
+    uint32_t read_nrdy;                                 /*!< Result reads answered with XENSIV_PASCO2_READ_NRDY */
+    uint32_t delay_ms_total;                            /*!< Total time waited in \ref xensiv_pasco2_plat_delay (ms) */
+    uint32_t delay_ms_max;                              /*!< Longest single wait in \ref xensiv_pasco2_plat_delay (ms) */
+    uint32_t latency_us_max;                            /*!< Longest register access, inter-transaction guard time included (us) */
+} xensiv_pasco2_stats_t;
+
+/** Maximum register payload stored in a trace record. Matches the longest access issued by the library */
+#define XENSIV_PASCO2_TRACE_DATA_LEN        (XENSIV_PASCO2_SNAPSHOT_LEN)
+
+/** Size in bytes of a trace record encoded with \ref xensiv_pasco2_trace_encode */
+#define XENSIV_PASCO2_TRACE_REC_LEN         (10U + XENSIV_PASCO2_TRACE_DATA_LEN)
+
+/** Trace record flag: register write access */
+#define XENSIV_PASCO2_TRACE_WRITE           (0x01U)
+
+/** Trace record flag: payload longer than \ref XENSIV_PASCO2_TRACE_DATA_LEN and truncated */
+#define XENSIV_PASCO2_TRACE_TRUNC           (0x02U)
+
+/** Structure of a bus transaction trace record. See \ref xensiv_pasco2_trace_start */
+typedef struct
+{
+    uint32_t timestamp_us;                              /*!< Time at which the transaction started (us), from \ref xensiv_pasco2_plat_get_time_us */
+    uint16_t duration_us;                               /*!< Duration of the transaction (us), saturated to 0xFFFF */
+    uint8_t reg_addr;                                   /*!< Start register address */
+    uint8_t flags;                                      /*!< XENSIV_PASCO2_TRACE_WRITE, XENSIV_PASCO2_TRACE_TRUNC */
+    uint8_t len;                                        /*!< Number of registers accessed */
+    int8_t result;                                      /*!< Transaction result */
+    uint8_t data[XENSIV_PASCO2_TRACE_DATA_LEN];         /*!< Register values written or read */
+} xensiv_pasco2_trace_rec_t;
+
 struct xensiv_pasco2;                                   /* Forward declaration */
 
 /* Function pointer to the platform-specific function for reading the sensor registers via I2C/UART */
@@ -220,12 +298,35 @@ typedef int32_t (*xensiv_pasco2_read_fptr_t)(const struct xensiv_pasco2 * dev, u
 /* Function pointer to the platform-specific function for writing  the sensor registers via I2C/UART */
 typedef int32_t (*xensiv_pasco2_write_fptr_t)(const struct xensiv_pasco2 * dev, uint8_t reg_addr, const uint8_t * data, uint8_t len);
 
+/** Structure of a bus transaction trace recorder. The records are stored in a ring buffer allocated by the user, overwriting the oldest ones when full */
+typedef struct xensiv_pasco2_trace
+{
+    xensiv_pasco2_trace_rec_t * buf;    /*!< Record storage */
+    uint16_t size;                      /*!< Capacity of buf in records */
+    uint16_t head;                      /*!< Index of the next record to write */
+    uint16_t len;                       /*!< Number of valid records */
+    uint32_t total;                     /*!< Number of records written since the trace start, overwritten ones included */
+    xensiv_pasco2_read_fptr_t read;     /*!< Traced register read function */
+    xensiv_pasco2_write_fptr_t write;   /*!< Traced register write function */
+} xensiv_pasco2_trace_t;
+
 /** Structure of the XENSIV™ PAS CO2 sensor device. Initialized using \ref xensiv_pasco2_init_i2c or \ref xensiv_pasco2_init_uart */
 typedef struct xensiv_pasco2
 {
     void * ctx;                         /*!< Context for I2C/UART platform-specific read and write functions */
     xensiv_pasco2_read_fptr_t read;     /*!< Pointer to the register read function which depends on the communication interface used */
     xensiv_pasco2_write_fptr_t write;   /*!< Pointer to the register write function which depends on the communication interface used */
+    uint32_t comm_ts;                   /*!< Time (us) at which the last register access finished */
+    bool comm_pending;                  /*!< Whether comm_ts is valid and the inter-transaction guard time applies to the next access */
+    bool shadow_en;                     /*!< Whether register reads are served from the shadow register cache when possible */
+    uint16_t shadow_valid;              /*!< Bitmask of the shadow registers holding the device value (bit n for register address n) */
+    uint16_t shadow_dirty;              /*!< Bitmask of the shadow registers holding a staged value not yet written to the device */
+    bool stage_en;                      /*!< Whether configuration register writes are staged. See \ref xensiv_pasco2_begin_config */
+    bool stage_idle;                    /*!< Whether the device was known to be in idle mode when the configuration transaction was opened */
+    uint8_t shadow[XENSIV_PASCO2_SNAPSHOT_LEN]; /*!< Shadow copy of the configuration registers */
+    xensiv_pasco2_stats_t stats;        /*!< Runtime statistics */
+    xensiv_pasco2_trace_t * trace;      /*!< Bus transaction trace recorder. NULL if not tracing */
+    uint8_t uart_req_addr;              /*!< Register address of the next reply expected by \ref xensiv_pasco2_uart_read_reply */
 } xensiv_pasco2_t;
 
 /******************************* Function prototypes *************************************/
@@ -256,6 +357,142 @@ int32_t xensiv_pasco2_init_i2c(xensiv_pasco2_t * dev, void *ctx);
  */
 int32_t xensiv_pasco2_init_uart(xensiv_pasco2_t * dev, void *ctx);
 
+/**
+ * @brief Starts the initialization of the XENSIV™ PAS CO2 device using the I2C interface without waiting for the sensor.
+ * It initializes the dev structure, verifies the integrity of the communication layer of the serial communication interface
+ * and triggers a soft reset. The application must wait \ref XENSIV_PASCO2_SOFT_RESET_DELAY_MS before calling
+ * \ref xensiv_pasco2_init_finish, and can use the time to initialize other devices
+ *
+ * @param[inout] dev Pointer to a XENSIV™ PAS CO2 sensor device structure allocated by the user,
+ * but the init function will initialize its contents
+ * @param[in] ctx Pointer to the platform-specific I2C communication handler
+ * @return XENSIV_PASCO2_OK if the soft reset has been triggered; an error indicating what went wrong otherwise
+ */
+int32_t xensiv_pasco2_init_i2c_start(xensiv_pasco2_t * dev, void * ctx);
+
+/**
+ * @brief Starts the initialization of the XENSIV™ PAS CO2 device using the UART interface without waiting for the sensor.
+ * Same as \ref xensiv_pasco2_init_i2c_start for the UART interface
+ *
+ * @param[inout] dev Pointer to a XENSIV™ PAS CO2 sensor device structure allocated by the user,
+ * but the init function will initialize its contents
+ * @param[in] ctx Pointer to the platform-specific UART communication handler
+ * @return XENSIV_PASCO2_OK if the soft reset has been triggered; an error indicating what went wrong otherwise
+ */
+int32_t xensiv_pasco2_init_uart_start(xensiv_pasco2_t * dev, void * ctx);
+
+/**
+ * @brief Initializes the dev structure for the I2C interface without accessing the sensor.
+ * Together with \ref xensiv_pasco2_reset_start it is the same as \ref xensiv_pasco2_init_i2c_start, and allows to
+ * configure the device in between, e.g. to start the tracing before the first register access
+ *
+ * @param[inout] dev Pointer to a XENSIV™ PAS CO2 sensor device structure allocated by the user,
+ * but the function will initialize its contents
+ * @param[in] ctx Pointer to the platform-specific I2C communication handler
+ */
+void xensiv_pasco2_bind_i2c(xensiv_pasco2_t * dev, void * ctx);
+
+/**
+ * @brief Initializes the dev structure for the UART interface without accessing the sensor.
+ * Same as \ref xensiv_pasco2_bind_i2c for the UART interface
+ *
+ * @param[inout] dev Pointer to a XENSIV™ PAS CO2 sensor device structure allocated by the user,
+ * but the function will initialize its contents
+ * @param[in] ctx Pointer to the platform-specific UART communication handler
+ */
+void xensiv_pasco2_bind_uart(xensiv_pasco2_t * dev, void * ctx);
+
+/**
+ * @brief Verifies the integrity of the communication layer of the serial communication interface and triggers a soft reset.
+ * The application must wait \ref XENSIV_PASCO2_SOFT_RESET_DELAY_MS before calling \ref xensiv_pasco2_init_finish
+ *
+ * @param[in] dev Pointer to the XENSIV™ PAS CO2 sensor device initialized with \ref xensiv_pasco2_bind_i2c or \ref xensiv_pasco2_bind_uart
+ * @return XENSIV_PASCO2_OK if the soft reset has been triggered; an error indicating what went wrong otherwise
+ */
+int32_t xensiv_pasco2_reset_start(const xensiv_pasco2_t * dev);
+
+/**
+ * @brief Completes the initialization started with \ref xensiv_pasco2_init_i2c_start or \ref xensiv_pasco2_init_uart_start.
+ * Checks whether the sensor is ready. Must be called at least \ref XENSIV_PASCO2_SOFT_RESET_DELAY_MS after the start
+ *
+ * @param[in] dev Pointer to the XENSIV™ PAS CO2 sensor device
+ * @return XENSIV_PASCO2_OK if the sensor is ready; an error indicating what went wrong otherwise
+ */
+int32_t xensiv_pasco2_init_finish(const xensiv_pasco2_t * dev);
+
+/**
+ * @brief Enables or disables the pipelined UART register access.
+ * When enabled, a multi-register read sends the read frames of all the registers in a single UART write and then
+ * collects the replies as they arrive, instead of waiting for each reply before sending the next frame.
+ * Likewise, a multi-register write sends all the write frames back to back and then validates the ACK/NAK
+ * responses in one pass. The response to a soft reset command is ignored as in the non-pipelined access.
+ * The device must have been initialized with \ref xensiv_pasco2_init_uart. Initialization resets it to disabled
+ *
+ * @param[inout] dev Pointer to the XENSIV™ PAS CO2 sensor device
+ * @param[in] enable True to enable the pipelined access, false to use one round trip per register
+ */
+void xensiv_pasco2_set_uart_pipelining(xensiv_pasco2_t * dev, bool enable);
+
+/**
+ * @brief Enables or disables the shadow register cache.
+ * The cache keeps a copy of the configuration registers written by the host (MEAS_RATE, MEAS_CFG, INT_CFG, ALARM_TH,
+ * PRESS_REF, CALIB_REF and SCRATCH_PAD). Reads of cached registers do not access the bus, so the read-modify-write
+ * sequences of the configuration functions become write-only. MEAS_CFG is not cached while the sensor can change it
+ * on its own (single shot operation mode or forced compensation in progress). The cache is invalidated by a soft reset,
+ * by a failed write and when the cache is enabled. Initialization resets it to disabled
+ *
+ * @param[inout] dev Pointer to the XENSIV™ PAS CO2 sensor device
+ * @param[in] enable True to enable the cache
+ */
+void xensiv_pasco2_set_shadow(xensiv_pasco2_t * dev, bool enable);
+
+/**
+ * @brief Opens a configuration transaction.
+ * Until \ref xensiv_pasco2_commit_config is called, writes to the configuration registers (MEAS_RATE, MEAS_CFG, INT_CFG,
+ * ALARM_TH, PRESS_REF, CALIB_REF and SCRATCH_PAD) are only staged and reads return the staged values. Writes to the
+ * status and reset registers access the device immediately
+ *
+ * @param[inout] dev Pointer to the XENSIV™ PAS CO2 sensor device
+ */
+void xensiv_pasco2_begin_config(xensiv_pasco2_t * dev);
+
+/**
+ * @brief Commits the configuration transaction opened with \ref xensiv_pasco2_begin_config.
+ * Only the staged registers are written. Contiguous registers are merged into single bursts: INT_CFG to SCRATCH_PAD
+ * first, and then MEAS_RATE and MEAS_CFG, so that a new operation mode starts with the complete configuration.
+ * The measurement rate is only changed in idle mode, and the operation mode only changes from idle mode. Unless the
+ * device is known to be in idle mode, it is set to idle mode first if the measurement rate changes or a different
+ * measuring operation mode is staged. A continuous mode interrupted by a rate change alone is resumed afterwards.
+ * With the shadow register cache enabled (\ref xensiv_pasco2_set_shadow) unchanged registers in between are
+ * written along to merge the bursts
+ *
+ * @param[inout] dev Pointer to the XENSIV™ PAS CO2 sensor device
+ * @return XENSIV_PASCO2_OK if writing the configuration was successful; an error indicating what went wrong otherwise
+ */
+int32_t xensiv_pasco2_commit_config(xensiv_pasco2_t * dev);
+
+/**
+ * @brief Sends the UART read frames for a register range without waiting for the replies.
+ * Used together with \ref xensiv_pasco2_uart_read_reply to read registers with a non-blocking receive path.
+ * The application collects the \ref XENSIV_PASCO2_UART_READ_REPLY_LEN bytes reply of each register in order
+ *
+ * @param[in] dev Pointer to the XENSIV™ PAS CO2 sensor device initialized with \ref xensiv_pasco2_init_uart
+ * @param[in] reg_addr Start register address
+ * @param[in] len Number of registers to be read
+ * @return XENSIV_PASCO2_OK if sending the read frames was successful; an error indicating what went wrong otherwise
+ */
+int32_t xensiv_pasco2_uart_read_request(const xensiv_pasco2_t * dev, uint8_t reg_addr, uint8_t len);
+
+/**
+ * @brief Decodes the reply to a UART read frame sent with \ref xensiv_pasco2_uart_read_request
+ *
+ * @param[in] dev Pointer to the XENSIV™ PAS CO2 sensor device initialized with \ref xensiv_pasco2_init_uart
+ * @param[in] reply Received reply of \ref XENSIV_PASCO2_UART_READ_REPLY_LEN bytes
+ * @param[out] val Pointer to populate with the register value
+ * @return XENSIV_PASCO2_OK if the reply is valid; XENSIV_PASCO2_ERR_COMM if it does not start with two hex digits
+ */
+int32_t xensiv_pasco2_uart_read_reply(const xensiv_pasco2_t * dev, const uint8_t * reply, uint8_t * val);
+
 /**
  * @brief Writes the given data buffer into the sensor device.
  * Writes the given data buffer to the sensor register map starting at the register address
@@ -280,6 +517,102 @@ int32_t xensiv_pasco2_set_reg(const xensiv_pasco2_t * dev, uint8_t reg_addr, con
  */
 int32_t xensiv_pasco2_get_reg(const xensiv_pasco2_t * dev, uint8_t reg_addr, uint8_t * data, uint8_t len);
 
+/**
+ * @brief Reads the complete register file of the sensor device in a single bus access.
+ * Reads the registers PROD_ID to SCRATCH_PAD with one register read and decodes them into the snapshot structure.
+ * Over I2C this is a single repeated-start transfer, instead of one transfer per register
+ *
+ * @param[in] dev Pointer to the XENSIV™ PAS CO2 sensor device
+ * @param[out] snapshot Pointer to populate with the decoded register values
+ * @note The status sticky bits are not cleared. Use \ref xensiv_pasco2_clear_status and \ref xensiv_pasco2_clear_measurement_status
+ * @return XENSIV_PASCO2_OK if reading the register file was successful; an error indicating what went wrong otherwise
+ */
+int32_t xensiv_pasco2_get_snapshot(const xensiv_pasco2_t * dev, xensiv_pasco2_snapshot_t * snapshot);
+
+/**
+ * @brief Gets a consistent snapshot of the runtime statistics without locking.
+ * It can be called from another context than the one accessing the sensor, such as an interrupt handler
+ * or another task. If an update is in progress and does not complete within a few retries, no snapshot
+ * is taken.
+ *
+ * @param[in] dev Pointer to the XENSIV™ PAS CO2 sensor device
+ * @param[out] stats Statistics snapshot
+ * @return true if the snapshot was taken; false if the statistics were being updated
+ */
+bool xensiv_pasco2_get_stats(const xensiv_pasco2_t * dev, xensiv_pasco2_stats_t * stats);
+
+/**
+ * @brief Clears the runtime statistics.
+ * Must be called from the context accessing the sensor.
+ *
+ * @param[in] dev Pointer to the XENSIV™ PAS CO2 sensor device
+ */
+void xensiv_pasco2_reset_stats(xensiv_pasco2_t * dev);
+
+/**
+ * @brief Waits through \ref xensiv_pasco2_plat_delay and accounts the wait in the runtime statistics
+ *
+ * @param[in] dev Pointer to the XENSIV™ PAS CO2 sensor device
+ * @param[in] ms Number of miliseconds to wait for
+ */
+void xensiv_pasco2_delay(const xensiv_pasco2_t * dev, uint32_t ms);
+
+/**
+ * @brief Initializes a bus transaction trace recorder with an empty trace
+ *
+ * @param[out] trace Pointer to the trace recorder allocated by the user
+ * @param[in] buf Record storage
+ * @param[in] size Capacity of buf in records
+ */
+void xensiv_pasco2_trace_init(xensiv_pasco2_trace_t * trace, xensiv_pasco2_trace_rec_t * buf, uint16_t size);
+
+/**
+ * @brief Starts or resumes recording the bus transactions of the device.
+ * Every register access passing through the device read and write functions is appended to the trace
+ * with its register address, payload, result and timestamp. The replies decoded by \ref xensiv_pasco2_uart_read_reply
+ * are recorded as single register reads.
+ * The device initialization resets the device structure and stops the tracing. To record the interface check and
+ * soft reset accesses, start it between \ref xensiv_pasco2_bind_i2c or \ref xensiv_pasco2_bind_uart and
+ * \ref xensiv_pasco2_reset_start
+ *
+ * @param[inout] dev Pointer to the XENSIV™ PAS CO2 sensor device
+ * @param[inout] trace Pointer to the trace recorder initialized with \ref xensiv_pasco2_trace_init
+ */
+void xensiv_pasco2_trace_start(xensiv_pasco2_t * dev, xensiv_pasco2_trace_t * trace);
+
+/**
+ * @brief Stops recording the bus transactions of the device. The recorded trace is kept
+ *
+ * @param[inout] dev Pointer to the XENSIV™ PAS CO2 sensor device
+ */
+void xensiv_pasco2_trace_stop(xensiv_pasco2_t * dev);
+
+/**
+ * @brief Gets a record of the trace
+ *
+ * @param[in] trace Pointer to the trace recorder
+ * @param[in] index Record index, 0 being the oldest record kept in the ring buffer
+ * @return Pointer to the record; NULL if index is beyond the number of valid records
+ */
+const xensiv_pasco2_trace_rec_t * xensiv_pasco2_trace_get(const xensiv_pasco2_trace_t * trace, uint16_t index);
+
+/**
+ * @brief Encodes a trace record into its portable binary format of \ref XENSIV_PASCO2_TRACE_REC_LEN bytes,
+ * with multi-byte fields in little-endian order. A trace file is a sequence of encoded records
+ *
+ * @param[in] rec Pointer to the trace record
+ * @param[out] buf Buffer of at least \ref XENSIV_PASCO2_TRACE_REC_LEN bytes
+ */
+void xensiv_pasco2_trace_encode(const xensiv_pasco2_trace_rec_t * rec, uint8_t * buf);
+
+/**
+ * @brief Decodes a trace record encoded with \ref xensiv_pasco2_trace_encode
+ *
+ * @param[in] buf Buffer of \ref XENSIV_PASCO2_TRACE_REC_LEN bytes
+ * @param[out] rec Pointer to populate with the trace record
+ */
+void xensiv_pasco2_trace_decode(const uint8_t * buf, xensiv_pasco2_trace_rec_t * rec);
+
 /**
  * @brief Gets the sensor device product and version ID
  *
@@ -469,13 +802,58 @@ int32_t xensiv_pasco2_start_continuous_mode(const xensiv_pasco2_t * dev, uint16_
  * @brief Performs force compensation.
  * Used to calculate the offset compensation when the sensor is exposed to a CO2 reference value.
  * The device is left is idle mode and the new offset compensation value is stored in non-volatile memory.
+ * Blocks until the sensor completes the compensation, polling its state once per second. If the sensor does not complete
+ * it within \ref XENSIV_PASCO2_FCS_TIMEOUT_MS, or a poll fails, the compensation is aborted with
+ * \ref xensiv_pasco2_abort_forced_compensation and the baseline offset compensation setting in use before is restored
  *
  * @param[in] dev Pointer to the XENSIV™ PAS CO2 sensor device
- * @param[in] cmd Command to trigger
- * @return XENSIV_PASCO2_OK if the force compensation was successful; an error indicating what went wrong otherwise
+ * @param[in] co2_ref CO2 reference value the sensor is exposed to [ppm]
+ * @return XENSIV_PASCO2_OK if the force compensation was successful; XENSIV_PASCO2_ERR_TIMEOUT if the sensor did not
+ * complete it in time; an error indicating what went wrong otherwise
  */
 int32_t xensiv_pasco2_perform_forced_compensation(const xensiv_pasco2_t * dev, uint16_t co2_ref);
 
+/**
+ * @brief Starts the force compensation without waiting for its completion.
+ * The sensor is put in continuous mode with forced compensation enabled.
+ * Completion is checked with xensiv_pasco2_get_forced_compensation_state() and
+ * concluded with xensiv_pasco2_finish_forced_compensation().
+ *
+ * @param[in] dev Pointer to the XENSIV™ PAS CO2 sensor device
+ * @param[in] co2_ref CO2 reference value the sensor is exposed to [ppm]
+ * @return XENSIV_PASCO2_OK if the force compensation was started; an error indicating what went wrong otherwise
+ */
+int32_t xensiv_pasco2_start_forced_compensation(const xensiv_pasco2_t * dev, uint16_t co2_ref);
+
+/**
+ * @brief Checks whether the sensor has completed the force compensation
+ *
+ * @param[in] dev Pointer to the XENSIV™ PAS CO2 sensor device
+ * @return XENSIV_PASCO2_OK if the compensation is completed, XENSIV_PASCO2_BUSY if it is still running;
+ * an error indicating what went wrong otherwise
+ */
+int32_t xensiv_pasco2_get_forced_compensation_state(const xensiv_pasco2_t * dev);
+
+/**
+ * @brief Concludes a completed force compensation.
+ * The device is left is idle mode and the new offset compensation value is stored in non-volatile memory.
+ *
+ * @param[in] dev Pointer to the XENSIV™ PAS CO2 sensor device
+ * @return XENSIV_PASCO2_OK if the offset compensation was stored; an error indicating what went wrong otherwise
+ */
+int32_t xensiv_pasco2_finish_forced_compensation(const xensiv_pasco2_t * dev);
+
+/**
+ * @brief Aborts a force compensation without storing the offset compensation.
+ * The device is left in idle mode with the given baseline offset compensation setting, usually the one in use before
+ * \ref xensiv_pasco2_start_forced_compensation. A forced compensation setting is restored as disabled
+ *
+ * @param[in] dev Pointer to the XENSIV™ PAS CO2 sensor device
+ * @param[in] boc_cfg Baseline offset compensation setting to restore
+ * @return XENSIV_PASCO2_OK if the compensation was aborted; an error indicating what went wrong otherwise
+ */
+int32_t xensiv_pasco2_abort_forced_compensation(const xensiv_pasco2_t * dev, xensiv_pasco2_boc_cfg_t boc_cfg);
+
 /**
  * @brief Target platform-specific function to perform I2C write/read transfer.
  * Synchronously writes a block of data and optionally receive a block of data.
@@ -516,6 +894,36 @@ int32_t xensiv_pasco2_plat_uart_write(void *ctx, uint8_t * data, size_t len);
  */
 void xensiv_pasco2_plat_delay(uint32_t ms);
 
+/**
+ * @brief Target platform-specific function that returns a free running millisecond time base
+ * Used by the default \ref xensiv_pasco2_plat_get_time_us
+ *
+ * @return Current time in milliseconds. Wrap around is allowed
+ */
+uint32_t xensiv_pasco2_plat_get_time_ms(void);
+
+/**
+ * @brief Target platform-specific function that returns a free running microsecond time base
+ * Used to measure the register access latency and to skip the inter-transaction guard time when enough time has passed since the last register access
+ *
+ * @return Current time in microseconds. Wrap around is allowed
+ */
+uint32_t xensiv_pasco2_plat_get_time_us(void);
+
+/**
+ * @brief Target platform-specific function that takes the exclusive access to the serial bus before a transfer
+ *
+ * @param[in] ctx Pointer to the platform-specific I2C/UART communication handler
+ */
+void xensiv_pasco2_plat_bus_lock(void * ctx);
+
+/**
+ * @brief Target platform-specific function that releases the serial bus after a transfer
+ *
+ * @param[in] ctx Pointer to the platform-specific I2C/UART communication handler
+ */
+void xensiv_pasco2_plat_bus_unlock(void * ctx);
+
 /**
  * @brief Target platform-specific function to reverse the byte order (16-bit)
  *